@@ -33,6 +33,7 @@
 -keep class me.magnum.melonds.domain.model.Cheat { *; }
 -keep class me.magnum.melonds.domain.model.DSiWareTitle { *; }
 -keep class me.magnum.melonds.domain.model.VideoRenderer { *; }
+-keep class me.magnum.melonds.domain.model.RewindThumbnailSize { *; }
 -keep class me.magnum.melonds.domain.model.retroachievements.RASimpleAchievement { *; }
 -keep class me.magnum.melonds.domain.model.retroachievements.RASimpleLeaderboard { *; }
 -keep class me.magnum.melonds.domain.model.retroachievements.RASimpleRuntimeAchievement { *; }
@@ -42,6 +43,7 @@
 -keep class me.magnum.melonds.ui.settings.fragments.**
 -keep class me.magnum.melonds.common.UriFileHandler {
     public int open(java.lang.String, java.lang.String);
+    public boolean replace(java.lang.String, java.lang.String);
 }
 -keep interface me.magnum.melonds.common.camera.DSiCameraSource { *; }
 
@@ -0,0 +1,91 @@
+#include <cstring>
+#include "EmulatorConfigurationDiff.h"
+#include "EmulatorConfigurationLayout.h"
+
+using namespace melonDS;
+using namespace EmulatorConfigurationLayout;
+
+namespace
+{
+    struct FieldClass
+    {
+        u32 offset;
+        u32 size;
+        u32 changeClass;
+        bool isCoreField;
+    };
+
+    const FieldClass FIXED_FIELDS[] = {
+        { FAST_FORWARD_SPEED_MULTIPLIER_OFFSET, 4, EmulatorConfigurationDiff::CHANGE_HOT, false },
+        { REWIND_ENABLED_OFFSET, 1, EmulatorConfigurationDiff::CHANGE_HOT, true },
+        { REWIND_PERIOD_SECONDS_OFFSET, 4, EmulatorConfigurationDiff::CHANGE_HOT, true },
+        { REWIND_WINDOW_SECONDS_OFFSET, 4, EmulatorConfigurationDiff::CHANGE_HOT, false },
+        { REWIND_THUMBNAIL_SCALE_OFFSET, 4, EmulatorConfigurationDiff::CHANGE_HOT, false },
+        { SOUND_ENABLED_OFFSET, 1, EmulatorConfigurationDiff::CHANGE_HOT, true },
+        { VOLUME_OFFSET, 4, EmulatorConfigurationDiff::CHANGE_HOT, true },
+        { AUDIO_INTERPOLATION_OFFSET, 4, EmulatorConfigurationDiff::CHANGE_HOT, true },
+        { AUDIO_BITRATE_OFFSET, 4, EmulatorConfigurationDiff::CHANGE_HOT, true },
+        { MIC_SOURCE_OFFSET, 4, EmulatorConfigurationDiff::CHANGE_HOT, true },
+        { AUDIO_LATENCY_OFFSET, 4, EmulatorConfigurationDiff::CHANGE_WARM, true },
+        { RENDERER_OFFSET, 4, EmulatorConfigurationDiff::CHANGE_WARM, true },
+        { RESOLUTION_SCALING_OFFSET, 4, EmulatorConfigurationDiff::CHANGE_WARM, true },
+        { THREADED_RENDERING_OFFSET, 1, EmulatorConfigurationDiff::CHANGE_WARM, true },
+        { USE_CUSTOM_BIOS_OFFSET, 1, EmulatorConfigurationDiff::CHANGE_COLD, true },
+        { SHOW_BOOT_SCREEN_OFFSET, 1, EmulatorConfigurationDiff::CHANGE_COLD, true },
+        { USE_JIT_OFFSET, 1, EmulatorConfigurationDiff::CHANGE_COLD, true },
+        { CONSOLE_TYPE_OFFSET, 4, EmulatorConfigurationDiff::CHANGE_COLD, true },
+        { RANDOMIZE_MAC_ADDRESS_OFFSET, 1, EmulatorConfigurationDiff::CHANGE_COLD, true },
+        { FIRMWARE_LANGUAGE_OFFSET, 4, EmulatorConfigurationDiff::CHANGE_COLD, true },
+        { FIRMWARE_FAVOURITE_COLOUR_OFFSET, 4, EmulatorConfigurationDiff::CHANGE_COLD, true },
+        { FIRMWARE_BIRTHDAY_MONTH_OFFSET, 4, EmulatorConfigurationDiff::CHANGE_COLD, true },
+        { FIRMWARE_BIRTHDAY_DAY_OFFSET, 4, EmulatorConfigurationDiff::CHANGE_COLD, true },
+    };
+
+    // All strings are files, directories or firmware settings, which are only read when the emulator boots
+    constexpr u32 STRING_CHANGE_CLASS = EmulatorConfigurationDiff::CHANGE_COLD;
+
+    bool isStringEqual(const u8* previous, size_t previousSize, const u8* current, size_t currentSize, u32 slot)
+    {
+        u32 slotOffset = STRING_TABLE_OFFSET + slot * STRING_SLOT_SIZE;
+        u32 previousOffset, currentOffset;
+        s32 previousLength, currentLength;
+        memcpy(&previousOffset, previous + slotOffset, sizeof(u32));
+        memcpy(&previousLength, previous + slotOffset + 4, sizeof(s32));
+        memcpy(&currentOffset, current + slotOffset, sizeof(u32));
+        memcpy(&currentLength, current + slotOffset + 4, sizeof(s32));
+
+        if (previousLength != currentLength)
+            return false;
+        if (previousLength < 0)
+            return true;
+        if ((size_t) previousOffset + previousLength > previousSize || (size_t) currentOffset + currentLength > currentSize)
+            return false;
+
+        return memcmp(previous + previousOffset, current + currentOffset, previousLength) == 0;
+    }
+}
+
+EmulatorConfigurationDiff::Changes EmulatorConfigurationDiff::diff(const u8* previous, size_t previousSize, const u8* current, size_t currentSize)
+{
+    Changes changes = { 0, false };
+
+    for (const FieldClass& field : FIXED_FIELDS)
+    {
+        if (memcmp(previous + field.offset, current + field.offset, field.size) != 0)
+        {
+            changes.changeClasses |= field.changeClass;
+            changes.affectsCore |= field.isCoreField;
+        }
+    }
+
+    for (u32 slot = 0; slot < STRING_COUNT; slot++)
+    {
+        if (!isStringEqual(previous, previousSize, current, currentSize, slot))
+        {
+            changes.changeClasses |= STRING_CHANGE_CLASS;
+            changes.affectsCore = true;
+        }
+    }
+
+    return changes;
+}
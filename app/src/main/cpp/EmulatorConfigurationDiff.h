@@ -0,0 +1,39 @@
+#ifndef MELONDS_ANDROID_EMULATORCONFIGURATIONDIFF_H
+#define MELONDS_ANDROID_EMULATORCONFIGURATIONDIFF_H
+
+#include <cstddef>
+#include "types.h"
+
+/**
+ * Compares two configurations serialized with the layout described in EmulatorConfigurationLayout.h and classifies the fields that changed by
+ * what is needed to apply them:
+ *
+ * - Hot changes (volume, audio interpolation, fast-forward speed, mic source, rewind settings) can be applied between two frames
+ * - Warm changes (renderer, resolution scaling, audio latency) can be applied between two frames, but need render targets or audio streams to
+ *   be recreated
+ * - Cold changes (console type, BIOS and firmware files, JIT) only take effect after the emulator is reset
+ *
+ * The change class values must match EmulatorConfigurationChange.kt.
+ */
+namespace EmulatorConfigurationDiff
+{
+    constexpr melonDS::u32 CHANGE_HOT = 1 << 0;
+    constexpr melonDS::u32 CHANGE_WARM = 1 << 1;
+    constexpr melonDS::u32 CHANGE_COLD = 1 << 2;
+
+    struct Changes
+    {
+        // Combination of the CHANGE_* values
+        melonDS::u32 changeClasses;
+        // Whether any of the changed fields is consumed by the core. Fields only used by the frontend, like the fast-forward speed or the rewind
+        // settings, do not need the core configuration to be updated
+        bool affectsCore;
+    };
+
+    /**
+     * Both configurations must have already been validated by MelonDSAndroidConfiguration::decodeEmulatorConfiguration().
+     */
+    Changes diff(const melonDS::u8* previous, size_t previousSize, const melonDS::u8* current, size_t currentSize);
+}
+
+#endif //MELONDS_ANDROID_EMULATORCONFIGURATIONDIFF_H
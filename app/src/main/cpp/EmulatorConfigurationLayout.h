@@ -0,0 +1,62 @@
+#ifndef MELONDS_ANDROID_EMULATORCONFIGURATIONLAYOUT_H
+#define MELONDS_ANDROID_EMULATORCONFIGURATIONLAYOUT_H
+
+#include "types.h"
+
+/**
+ * Layout of the serialized emulator configuration written by EmulatorConfigurationSerializer.kt. All values are in native byte order. Booleans
+ * are single bytes. Strings are stored after the fixed fields as NUL-terminated UTF-8, and referenced by a table of (offset, length) slots in which
+ * a length of -1 means null.
+ *
+ * The constants must match EmulatorConfigurationLayout.kt, which is checked by EmulatorConfigurationLayoutTest. LAYOUT_VERSION must be increased
+ * whenever the layout changes.
+ */
+namespace EmulatorConfigurationLayout
+{
+    constexpr melonDS::u32 LAYOUT_VERSION = 1;
+
+    constexpr melonDS::u32 VERSION_OFFSET = 0;
+    constexpr melonDS::u32 SIZE_OFFSET = 4;
+    constexpr melonDS::u32 USE_CUSTOM_BIOS_OFFSET = 8;
+    constexpr melonDS::u32 SHOW_BOOT_SCREEN_OFFSET = 9;
+    constexpr melonDS::u32 REWIND_ENABLED_OFFSET = 10;
+    constexpr melonDS::u32 USE_JIT_OFFSET = 11;
+    constexpr melonDS::u32 SOUND_ENABLED_OFFSET = 12;
+    constexpr melonDS::u32 THREADED_RENDERING_OFFSET = 13;
+    constexpr melonDS::u32 RANDOMIZE_MAC_ADDRESS_OFFSET = 14;
+    constexpr melonDS::u32 FAST_FORWARD_SPEED_MULTIPLIER_OFFSET = 16;
+    constexpr melonDS::u32 REWIND_PERIOD_SECONDS_OFFSET = 20;
+    constexpr melonDS::u32 REWIND_WINDOW_SECONDS_OFFSET = 24;
+    constexpr melonDS::u32 REWIND_THUMBNAIL_SCALE_OFFSET = 28;
+    constexpr melonDS::u32 CONSOLE_TYPE_OFFSET = 32;
+    constexpr melonDS::u32 VOLUME_OFFSET = 36;
+    constexpr melonDS::u32 AUDIO_INTERPOLATION_OFFSET = 40;
+    constexpr melonDS::u32 AUDIO_BITRATE_OFFSET = 44;
+    constexpr melonDS::u32 AUDIO_LATENCY_OFFSET = 48;
+    constexpr melonDS::u32 MIC_SOURCE_OFFSET = 52;
+    constexpr melonDS::u32 RENDERER_OFFSET = 56;
+    constexpr melonDS::u32 RESOLUTION_SCALING_OFFSET = 60;
+    constexpr melonDS::u32 FIRMWARE_LANGUAGE_OFFSET = 64;
+    constexpr melonDS::u32 FIRMWARE_FAVOURITE_COLOUR_OFFSET = 68;
+    constexpr melonDS::u32 FIRMWARE_BIRTHDAY_MONTH_OFFSET = 72;
+    constexpr melonDS::u32 FIRMWARE_BIRTHDAY_DAY_OFFSET = 76;
+    constexpr melonDS::u32 STRING_TABLE_OFFSET = 80;
+
+    constexpr melonDS::u32 STRING_SLOT_SIZE = 8;
+    constexpr melonDS::u32 STRING_DS_BIOS7 = 0;
+    constexpr melonDS::u32 STRING_DS_BIOS9 = 1;
+    constexpr melonDS::u32 STRING_DS_FIRMWARE = 2;
+    constexpr melonDS::u32 STRING_DSI_BIOS7 = 3;
+    constexpr melonDS::u32 STRING_DSI_BIOS9 = 4;
+    constexpr melonDS::u32 STRING_DSI_FIRMWARE = 5;
+    constexpr melonDS::u32 STRING_DSI_NAND = 6;
+    constexpr melonDS::u32 STRING_INTERNAL_DIRECTORY = 7;
+    constexpr melonDS::u32 STRING_FIRMWARE_NICKNAME = 8;
+    constexpr melonDS::u32 STRING_FIRMWARE_MESSAGE = 9;
+    constexpr melonDS::u32 STRING_FIRMWARE_MAC_ADDRESS = 10;
+    constexpr melonDS::u32 STRING_COUNT = 11;
+
+    constexpr melonDS::u32 STRING_DATA_OFFSET = STRING_TABLE_OFFSET + STRING_COUNT * STRING_SLOT_SIZE;
+}
+
+#endif //MELONDS_ANDROID_EMULATORCONFIGURATIONLAYOUT_H
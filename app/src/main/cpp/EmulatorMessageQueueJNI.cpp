@@ -1,6 +1,7 @@
 #include <jni.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <cstring>
 #include <Platform.h>
 
 // messagePipes[0] -> read
@@ -50,13 +51,22 @@ namespace MelonDSAndroid {
             return;
         }
 
+        // Must match the maximum data size supported by EmulatorMessageQueue.kt
+        constexpr int MAX_EVENT_DATA_SIZE = 128;
+        if (dataLength > MAX_EVENT_DATA_SIZE) {
+            return;
+        }
+
         struct {
             int type;
             int dataLength;
-        } event = { type, dataLength };
+            char data[MAX_EVENT_DATA_SIZE];
+        } event = { type, data != nullptr ? dataLength : 0 };
 
-        write(messagePipes[1], &event, sizeof(event));
         if (data != nullptr)
-            write(messagePipes[1], data, dataLength);
+            memcpy(event.data, data, dataLength);
+
+        // Events can be fired from multiple threads. Writing the whole event at once keeps it atomic, since it is smaller than PIPE_BUF
+        write(messagePipes[1], &event, sizeof(event.type) + sizeof(event.dataLength) + event.dataLength);
     }
 }
\ No newline at end of file
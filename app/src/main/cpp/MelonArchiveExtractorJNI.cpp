@@ -0,0 +1,76 @@
+#include <jni.h>
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <vector>
+#include "Platform.h"
+#include "archive/ZipExtractor.h"
+
+std::vector<std::string> getExtensions(JNIEnv* env, jobjectArray extensions);
+bool findZipEntry(ZipExtractor& extractor, const std::vector<std::string>& extensions, ZipExtractor::Entry& entry);
+
+extern "C"
+{
+JNIEXPORT jlong JNICALL
+Java_me_magnum_melonds_MelonArchiveExtractor_getZipEntrySize(JNIEnv* env, jobject thiz, jint archiveFd, jobjectArray extensions)
+{
+    ZipExtractor extractor(archiveFd);
+    ZipExtractor::Entry entry;
+    if (!findZipEntry(extractor, getExtensions(env, extensions), entry))
+        return -1;
+
+    return (jlong) entry.uncompressedSize;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_me_magnum_melonds_MelonArchiveExtractor_extractZipEntry(JNIEnv* env, jobject thiz, jint archiveFd, jint outputFd, jobjectArray extensions)
+{
+    ZipExtractor extractor(archiveFd);
+    ZipExtractor::Entry entry;
+    if (!findZipEntry(extractor, getExtensions(env, extensions), entry))
+        return JNI_FALSE;
+
+    bool result = extractor.extractEntry(entry, outputFd);
+    ZipExtractor::Stats stats = extractor.getStats();
+    melonDS::Platform::Log(
+        result ? melonDS::Platform::LogLevel::Info : melonDS::Platform::LogLevel::Error,
+        "%s %s: %llu KB to %llu KB in %.0f ms (%.0f ms waiting for reads)",
+        result ? "Extracted" : "Failed to extract",
+        entry.name.c_str(),
+        (unsigned long long) (stats.compressedSize / 1024),
+        (unsigned long long) (stats.uncompressedSize / 1024),
+        stats.totalTimeMs,
+        stats.readWaitTimeMs
+    );
+
+    return result ? JNI_TRUE : JNI_FALSE;
+}
+}
+
+std::vector<std::string> getExtensions(JNIEnv* env, jobjectArray extensions)
+{
+    std::vector<std::string> result;
+    jsize count = env->GetArrayLength(extensions);
+    for (jsize i = 0; i < count; i++)
+    {
+        jstring extension = (jstring) env->GetObjectArrayElement(extensions, i);
+        const char* extensionChars = env->GetStringUTFChars(extension, JNI_FALSE);
+        result.emplace_back(extensionChars);
+        env->ReleaseStringUTFChars(extension, extensionChars);
+        env->DeleteLocalRef(extension);
+    }
+    return result;
+}
+
+bool findZipEntry(ZipExtractor& extractor, const std::vector<std::string>& extensions, ZipExtractor::Entry& entry)
+{
+    return extractor.findEntry([&extensions](const std::string& name) {
+        size_t dotPosition = name.find_last_of('.');
+        if (dotPosition == std::string::npos)
+            return false;
+
+        std::string extension = name.substr(dotPosition + 1);
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+        return std::find(extensions.begin(), extensions.end(), extension) != extensions.end();
+    }, entry);
+}
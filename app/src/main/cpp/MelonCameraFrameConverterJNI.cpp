@@ -0,0 +1,55 @@
+#include <jni.h>
+#include "camera/YuvFrameConverter.h"
+
+using namespace melonDS;
+
+extern "C"
+{
+JNIEXPORT void JNICALL
+Java_me_magnum_melonds_MelonCameraFrameConverter_convertYuv420ToYuyv(
+    JNIEnv* env,
+    jobject thiz,
+    jobject yPlane,
+    jobject uPlane,
+    jobject vPlane,
+    jint width,
+    jint height,
+    jint yRowStride,
+    jint uvRowStride,
+    jint uvPixelStride,
+    jint rotationDegrees,
+    jobject output
+)
+{
+    YuvFrameConverter::Yuv420Image image = {
+        .y = (const u8*) env->GetDirectBufferAddress(yPlane),
+        .u = (const u8*) env->GetDirectBufferAddress(uPlane),
+        .v = (const u8*) env->GetDirectBufferAddress(vPlane),
+        .width = (u32) width,
+        .height = (u32) height,
+        .yRowStride = (u32) yRowStride,
+        .uvRowStride = (u32) uvRowStride,
+        .uvPixelStride = (u32) uvPixelStride,
+        .rotationDegrees = (u32) rotationDegrees,
+    };
+
+    auto* frame = (u8*) env->GetDirectBufferAddress(output);
+    if (frame == nullptr || env->GetDirectBufferCapacity(output) < YuvFrameConverter::FRAME_SIZE)
+        return;
+
+    if (image.y == nullptr || image.u == nullptr || image.v == nullptr)
+        YuvFrameConverter::fillBlack(frame);
+    else
+        YuvFrameConverter::convert(image, frame);
+}
+
+JNIEXPORT void JNICALL
+Java_me_magnum_melonds_MelonCameraFrameConverter_fillBlack(JNIEnv* env, jobject thiz, jobject output)
+{
+    auto* frame = (u8*) env->GetDirectBufferAddress(output);
+    if (frame == nullptr || env->GetDirectBufferCapacity(output) < YuvFrameConverter::FRAME_SIZE)
+        return;
+
+    YuvFrameConverter::fillBlack(frame);
+}
+}
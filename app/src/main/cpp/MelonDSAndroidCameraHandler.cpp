@@ -1,40 +1,52 @@
 #include "MelonDSAndroidCameraHandler.h"
+#include <algorithm>
+#include <cstring>
+#include "camera/YuvFrameConverter.h"
 
 MelonDSAndroidCameraHandler::MelonDSAndroidCameraHandler(JniEnvHandler* jniEnvHandler, jobject cameraManager) : jniEnvHandler(jniEnvHandler), cameraManager(cameraManager)
 {
+    JNIEnv* env = jniEnvHandler->getCurrentThreadEnv();
+
+    jclass cameraManagerClass = env->GetObjectClass(cameraManager);
+    startCameraMethod = env->GetMethodID(cameraManagerClass, "startCamera", "(I)V");
+    stopCameraMethod = env->GetMethodID(cameraManagerClass, "stopCamera", "(I)V");
+    captureFrameMethod = env->GetMethodID(cameraManagerClass, "captureFrame", "(IIIZ)Ljava/nio/ByteBuffer;");
+    env->DeleteLocalRef(cameraManagerClass);
 }
 
 void MelonDSAndroidCameraHandler::startCamera(int camera)
 {
     JNIEnv* env = jniEnvHandler->getCurrentThreadEnv();
-
-    jclass cameraManagerClass = env->GetObjectClass(cameraManager);
-    jmethodID startCameraMethod = env->GetMethodID(cameraManagerClass, "startCamera", "(I)V");
     env->CallVoidMethod(cameraManager, startCameraMethod, camera);
 }
 
 void MelonDSAndroidCameraHandler::stopCamera(int camera)
 {
     JNIEnv* env = jniEnvHandler->getCurrentThreadEnv();
-
-    jclass cameraManagerClass = env->GetObjectClass(cameraManager);
-    jmethodID stopCameraMethod = env->GetMethodID(cameraManagerClass, "stopCamera", "(I)V");
     env->CallVoidMethod(cameraManager, stopCameraMethod, camera);
 }
 
 void MelonDSAndroidCameraHandler::captureFrame(int camera, u32* frameBuffer, int width, int height, bool isYuv)
 {
     JNIEnv* env = jniEnvHandler->getCurrentThreadEnv();
-    jbyteArray javaBuffer = env->NewByteArray(BUFFER_SIZE);
-    jclass cameraManagerClass = env->GetObjectClass(cameraManager);
-    jmethodID captureFrameMethod = env->GetMethodID(cameraManagerClass, "captureFrame", "(I[BIIZ)V");
-    env->CallVoidMethod(cameraManager, captureFrameMethod, camera, javaBuffer, width, height, isYuv);
-
-    env->GetByteArrayRegion(javaBuffer, 0, BUFFER_SIZE, (jbyte*) frameBuffer);
-
-    env->DeleteLocalRef(javaBuffer);
+    // The camera source returns one of its own preallocated direct buffers, so frames are copied straight into the core's buffer
+    jobject frame = env->CallObjectMethod(cameraManager, captureFrameMethod, camera, width, height, isYuv);
+
+    const u8* frameData = frame ? (const u8*) env->GetDirectBufferAddress(frame) : nullptr;
+    if (frameData == nullptr)
+    {
+        YuvFrameConverter::fillBlack((u8*) frameBuffer);
+    }
+    else
+    {
+        jlong frameSize = std::min<jlong>(env->GetDirectBufferCapacity(frame), BUFFER_SIZE);
+        memcpy(frameBuffer, frameData, frameSize);
+    }
+
+    if (frame)
+        env->DeleteLocalRef(frame);
 }
 
 MelonDSAndroidCameraHandler::~MelonDSAndroidCameraHandler()
 {
-}
\ No newline at end of file
+}
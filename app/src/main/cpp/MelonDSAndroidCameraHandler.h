@@ -14,6 +14,9 @@ private:
 
     JniEnvHandler* jniEnvHandler;
     jobject cameraManager;
+    jmethodID startCameraMethod;
+    jmethodID stopCameraMethod;
+    jmethodID captureFrameMethod;
 
 public:
     MelonDSAndroidCameraHandler(JniEnvHandler* jniEnvHandler, jobject cameraManager);
@@ -1,159 +1,156 @@
 #include <jni.h>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <unordered_set>
 #include "MelonDSAndroidConfiguration.h"
+#include "EmulatorConfigurationLayout.h"
 #include "renderer/Renderer.h"
 
-MelonDSAndroid::EmulatorConfiguration MelonDSAndroidConfiguration::buildEmulatorConfiguration(JNIEnv* env, jobject emulatorConfiguration) {
-    jclass emulatorConfigurationClass = env->GetObjectClass(emulatorConfiguration);
-    jclass uriClass = env->FindClass("android/net/Uri");
-    jclass consoleTypeEnumClass = env->FindClass("me/magnum/melonds/domain/model/ConsoleType");
-    jclass audioBitrateEnumClass = env->FindClass("me/magnum/melonds/domain/model/AudioBitrate");
-    jclass audioInterpolationEnumClass = env->FindClass("me/magnum/melonds/domain/model/AudioInterpolation");
-    jclass audioLatencyEnumClass = env->FindClass("me/magnum/melonds/domain/model/AudioLatency");
-    jclass micSourceEnumClass = env->FindClass("me/magnum/melonds/domain/model/MicSource");
-    jclass videoRendererEnumClass = env->FindClass("me/magnum/melonds/domain/model/VideoRenderer");
-    jclass renderConfigurationClass = env->FindClass("me/magnum/melonds/domain/model/RendererConfiguration");
-
-    jmethodID uriToStringMethod = env->GetMethodID(uriClass, "toString", "()Ljava/lang/String;");
-
-    jobject firmwareConfigurationObject = env->GetObjectField(emulatorConfiguration, env->GetFieldID(emulatorConfigurationClass, "firmwareConfiguration", "Lme/magnum/melonds/domain/model/FirmwareConfiguration;"));
-    jobject rendererConfigurationObject = env->GetObjectField(emulatorConfiguration, env->GetFieldID(emulatorConfigurationClass, "rendererConfiguration", "Lme/magnum/melonds/domain/model/RendererConfiguration;"));
-    jboolean useCustomBios = env->GetBooleanField(emulatorConfiguration, env->GetFieldID(emulatorConfigurationClass, "useCustomBios", "Z"));
-    jboolean showBootScreen = env->GetBooleanField(emulatorConfiguration, env->GetFieldID(emulatorConfigurationClass, "showBootScreen", "Z"));
-    jobject dsBios7Uri = env->GetObjectField(emulatorConfiguration, env->GetFieldID(emulatorConfigurationClass, "dsBios7Uri", "Landroid/net/Uri;"));
-    jobject dsBios9Uri = env->GetObjectField(emulatorConfiguration, env->GetFieldID(emulatorConfigurationClass, "dsBios9Uri", "Landroid/net/Uri;"));
-    jobject dsFirmwareUri = env->GetObjectField(emulatorConfiguration, env->GetFieldID(emulatorConfigurationClass, "dsFirmwareUri", "Landroid/net/Uri;"));
-    jobject dsiBios7Uri = env->GetObjectField(emulatorConfiguration, env->GetFieldID(emulatorConfigurationClass, "dsiBios7Uri", "Landroid/net/Uri;"));
-    jobject dsiBios9Uri = env->GetObjectField(emulatorConfiguration, env->GetFieldID(emulatorConfigurationClass, "dsiBios9Uri", "Landroid/net/Uri;"));
-    jobject dsiFirmwareUri = env->GetObjectField(emulatorConfiguration, env->GetFieldID(emulatorConfigurationClass, "dsiFirmwareUri", "Landroid/net/Uri;"));
-    jobject dsiNandUri = env->GetObjectField(emulatorConfiguration, env->GetFieldID(emulatorConfigurationClass, "dsiNandUri", "Landroid/net/Uri;"));
-    jstring internalFilesDir = (jstring) env->GetObjectField(emulatorConfiguration, env->GetFieldID(emulatorConfigurationClass, "internalDirectory", "Ljava/lang/String;"));
-    jfloat fastForwardMaxSpeed = env->GetFloatField(emulatorConfiguration, env->GetFieldID(emulatorConfigurationClass, "fastForwardSpeedMultiplier", "F"));
-    jboolean enableRewind = env->GetBooleanField(emulatorConfiguration, env->GetFieldID(emulatorConfigurationClass, "rewindEnabled", "Z"));
-    jint rewindPeriodSeconds = env->GetIntField(emulatorConfiguration, env->GetFieldID(emulatorConfigurationClass, "rewindPeriodSeconds", "I"));
-    jint rewindWindowSeconds = env->GetIntField(emulatorConfiguration, env->GetFieldID(emulatorConfigurationClass, "rewindWindowSeconds", "I"));
-    jboolean useJit = env->GetBooleanField(emulatorConfiguration, env->GetFieldID(emulatorConfigurationClass, "useJit", "Z"));
-    jobject consoleTypeEnum = env->GetObjectField(emulatorConfiguration, env->GetFieldID(emulatorConfigurationClass, "consoleType", "Lme/magnum/melonds/domain/model/ConsoleType;"));
-    jint consoleType = env->GetIntField(consoleTypeEnum, env->GetFieldID(consoleTypeEnumClass, "consoleType", "I"));
-    jboolean soundEnabled = env->GetBooleanField(emulatorConfiguration, env->GetFieldID(emulatorConfigurationClass, "soundEnabled", "Z"));
-    jint volume = env->GetIntField(emulatorConfiguration, env->GetFieldID(emulatorConfigurationClass, "volume", "I"));
-    jobject audioInterpolationEnum = env->GetObjectField(emulatorConfiguration, env->GetFieldID(emulatorConfigurationClass, "audioInterpolation", "Lme/magnum/melonds/domain/model/AudioInterpolation;"));
-    jint audioInterpolation = env->GetIntField(audioInterpolationEnum, env->GetFieldID(audioInterpolationEnumClass, "interpolationValue", "I"));
-    jobject audioBitrateEnum = env->GetObjectField(emulatorConfiguration, env->GetFieldID(emulatorConfigurationClass, "audioBitrate", "Lme/magnum/melonds/domain/model/AudioBitrate;"));
-    jint audioBitrate = env->GetIntField(audioBitrateEnum, env->GetFieldID(audioBitrateEnumClass, "bitrateValue", "I"));
-    jobject audioLatencyEnum = env->GetObjectField(emulatorConfiguration, env->GetFieldID(emulatorConfigurationClass, "audioLatency", "Lme/magnum/melonds/domain/model/AudioLatency;"));
-    jint audioLatency = env->GetIntField(audioLatencyEnum, env->GetFieldID(audioLatencyEnumClass, "latencyValue", "I"));
-    jobject micSourceEnum = env->GetObjectField(emulatorConfiguration, env->GetFieldID(emulatorConfigurationClass, "micSource", "Lme/magnum/melonds/domain/model/MicSource;"));
-    jint micSource = env->GetIntField(micSourceEnum, env->GetFieldID(micSourceEnumClass, "sourceValue", "I"));
-    jobject videoRendererEnum = env->GetObjectField(rendererConfigurationObject, env->GetFieldID(renderConfigurationClass, "renderer", "Lme/magnum/melonds/domain/model/VideoRenderer;"));
-    MelonDSAndroid::Renderer videoRenderer = static_cast<MelonDSAndroid::Renderer>(env->GetIntField(videoRendererEnum, env->GetFieldID(videoRendererEnumClass, "renderer", "I")));
-    jboolean isCopy = JNI_FALSE;
-    jstring dsBios7String = dsBios7Uri ? (jstring) env->CallObjectMethod(dsBios7Uri, uriToStringMethod) : nullptr;
-    jstring dsBios9String = dsBios9Uri ? (jstring) env->CallObjectMethod(dsBios9Uri, uriToStringMethod) : nullptr;
-    jstring dsFirmwareString = dsFirmwareUri ? (jstring) env->CallObjectMethod(dsFirmwareUri, uriToStringMethod) : nullptr;
-    jstring dsiBios7String = dsiBios7Uri ? (jstring) env->CallObjectMethod(dsiBios7Uri, uriToStringMethod) : nullptr;
-    jstring dsiBios9String = dsiBios9Uri ? (jstring) env->CallObjectMethod(dsiBios9Uri, uriToStringMethod) : nullptr;
-    jstring dsiFirmwareString = dsiFirmwareUri ? (jstring) env->CallObjectMethod(dsiFirmwareUri, uriToStringMethod) : nullptr;
-    jstring dsiNandString = dsiNandUri ? (jstring) env->CallObjectMethod(dsiNandUri, uriToStringMethod) : nullptr;
-    const char* dsBios7Path = dsBios7Uri ? env->GetStringUTFChars(dsBios7String, &isCopy) : nullptr;
-    const char* dsBios9Path = dsBios9Uri ? env->GetStringUTFChars(dsBios9String, &isCopy) : nullptr;
-    const char* dsFirmwarePath = dsFirmwareUri ? env->GetStringUTFChars(dsFirmwareString, &isCopy) : nullptr;
-    const char* dsiBios7Path = dsiBios7Uri ? env->GetStringUTFChars(dsiBios7String, &isCopy) : nullptr;
-    const char* dsiBios9Path = dsiBios9Uri ? env->GetStringUTFChars(dsiBios9String, &isCopy) : nullptr;
-    const char* dsiFirmwarePath = dsiFirmwareUri ? env->GetStringUTFChars(dsiFirmwareString, &isCopy) : nullptr;
-    const char* dsiNandPath = dsiNandUri ? env->GetStringUTFChars(dsiNandString, &isCopy) : nullptr;
-    const char* internalDir = env->GetStringUTFChars(internalFilesDir, nullptr);
-
-    MelonDSAndroid::EmulatorConfiguration finalEmulatorConfiguration;
-    finalEmulatorConfiguration.userInternalFirmwareAndBios = !useCustomBios;
-    finalEmulatorConfiguration.dsBios7Path = const_cast<char*>(dsBios7Path);
-    finalEmulatorConfiguration.dsBios9Path = const_cast<char*>(dsBios9Path);
-    finalEmulatorConfiguration.dsFirmwarePath = const_cast<char*>(dsFirmwarePath);
-    finalEmulatorConfiguration.dsiBios7Path = const_cast<char*>(dsiBios7Path);
-    finalEmulatorConfiguration.dsiBios9Path = const_cast<char*>(dsiBios9Path);
-    finalEmulatorConfiguration.dsiFirmwarePath = const_cast<char*>(dsiFirmwarePath);
-    finalEmulatorConfiguration.dsiNandPath = const_cast<char*>(dsiNandPath);
-    finalEmulatorConfiguration.internalFilesDir = const_cast<char*>(internalDir);
-    finalEmulatorConfiguration.fastForwardSpeedMultiplier = fastForwardMaxSpeed;
-    finalEmulatorConfiguration.showBootScreen = showBootScreen;
-    finalEmulatorConfiguration.useJit = useJit;
-    finalEmulatorConfiguration.consoleType = consoleType;
-    finalEmulatorConfiguration.audioSettings = MelonDSAndroid::AudioSettings {
-        .soundEnabled = (bool) soundEnabled,
-        .volume = volume,
-        .audioInterpolation = audioInterpolation,
-        .audioBitrate = audioBitrate,
-        .audioLatency = audioLatency,
-        .micSource = micSource
-    };
-    finalEmulatorConfiguration.firmwareConfiguration = buildFirmwareConfiguration(env, firmwareConfigurationObject);
-    finalEmulatorConfiguration.rewindEnabled = enableRewind ? 1 : 0;
-    finalEmulatorConfiguration.rewindCaptureSpacingSeconds = rewindPeriodSeconds;
-    finalEmulatorConfiguration.rewindLengthSeconds = rewindWindowSeconds;
-    finalEmulatorConfiguration.renderSettings = std::move(buildRenderSettings(env, videoRenderer, rendererConfigurationObject));
-    finalEmulatorConfiguration.dsiSdCardSettings = MelonDSAndroid::SdCardSettings { .enabled = false };
-    finalEmulatorConfiguration.dldiSdCardSettings = MelonDSAndroid::SdCardSettings { .enabled = false };
-    finalEmulatorConfiguration.renderer = videoRenderer;
-    return finalEmulatorConfiguration;
-}
+using namespace melonDS;
 
-MelonDSAndroid::FirmwareConfiguration MelonDSAndroidConfiguration::buildFirmwareConfiguration(JNIEnv* env, jobject firmwareConfiguration) {
-    jclass firmwareConfigurationClass = env->GetObjectClass(firmwareConfiguration);
-    jstring nicknameString = (jstring) env->GetObjectField(firmwareConfiguration, env->GetFieldID(firmwareConfigurationClass, "nickname", "Ljava/lang/String;"));
-    jstring messageString = (jstring) env->GetObjectField(firmwareConfiguration, env->GetFieldID(firmwareConfigurationClass, "message", "Ljava/lang/String;"));
-    int language = env->GetIntField(firmwareConfiguration, env->GetFieldID(firmwareConfigurationClass, "language", "I"));
-    int colour = env->GetIntField(firmwareConfiguration, env->GetFieldID(firmwareConfigurationClass, "favouriteColour", "I"));
-    int birthdayDay = env->GetIntField(firmwareConfiguration, env->GetFieldID(firmwareConfigurationClass, "birthdayDay", "I"));
-    int birthdayMonth = env->GetIntField(firmwareConfiguration, env->GetFieldID(firmwareConfigurationClass, "birthdayMonth", "I"));
-    bool randomizeMacAddress = env->GetBooleanField(firmwareConfiguration, env->GetFieldID(firmwareConfigurationClass, "randomizeMacAddress", "Z"));
-    jstring macAddressString = (jstring) env->GetObjectField(firmwareConfiguration, env->GetFieldID(firmwareConfigurationClass, "internalMacAddress", "Ljava/lang/String;"));
-
-    jboolean isCopy = JNI_FALSE;
-    const char* nickname = env->GetStringUTFChars(nicknameString, &isCopy);
-    const char* message = env->GetStringUTFChars(messageString, &isCopy);
-    const char* macAddress = macAddressString ? env->GetStringUTFChars(macAddressString, &isCopy) : nullptr;
-
-    MelonDSAndroid::FirmwareConfiguration finalFirmwareConfiguration;
-    strncpy(finalFirmwareConfiguration.username, nickname, sizeof(finalFirmwareConfiguration.username) - 1);
-    strncpy(finalFirmwareConfiguration.message, message, sizeof(finalFirmwareConfiguration.message) - 1);
-    finalFirmwareConfiguration.username[sizeof(finalFirmwareConfiguration.username) - 1] = '\0';
-    finalFirmwareConfiguration.message[sizeof(finalFirmwareConfiguration.message) - 1] = '\0';
-    finalFirmwareConfiguration.language = language;
-    finalFirmwareConfiguration.favouriteColour = colour;
-    finalFirmwareConfiguration.birthdayDay = birthdayDay;
-    finalFirmwareConfiguration.birthdayMonth = birthdayMonth;
-    finalFirmwareConfiguration.randomizeMacAddress = randomizeMacAddress;
-    if (macAddress != nullptr)
+namespace
+{
+    // The core keeps raw pointers to the configuration strings. Interning them keeps those pointers valid without leaking a new copy every time
+    // the configuration is updated, since the set of distinct paths is small
+    std::mutex internedStringsMutex;
+    std::unordered_set<std::string> internedStrings;
+
+    template<typename T>
+    T readValue(const u8* data, u32 offset)
     {
-        strncpy(finalFirmwareConfiguration.macAddress, macAddress, sizeof(finalFirmwareConfiguration.macAddress) - 1);
-        finalFirmwareConfiguration.macAddress[sizeof(finalFirmwareConfiguration.macAddress) - 1] = '\0';
+        T value;
+        memcpy(&value, data + offset, sizeof(T));
+        return value;
     }
-    else
+
+    const char* internString(const char* string, size_t length)
+    {
+        std::lock_guard<std::mutex> lock(internedStringsMutex);
+        return internedStrings.emplace(string, length).first->c_str();
+    }
+
+    /**
+     * Returns the string in the given slot, or null if the string is null or does not fit in the data.
+     */
+    const char* readString(const u8* data, size_t size, u32 slot)
     {
-        finalFirmwareConfiguration.macAddress[0] = '\0';
+        u32 slotOffset = EmulatorConfigurationLayout::STRING_TABLE_OFFSET + slot * EmulatorConfigurationLayout::STRING_SLOT_SIZE;
+        u32 offset = readValue<u32>(data, slotOffset);
+        s32 length = readValue<s32>(data, slotOffset + 4);
+        if (length < 0 || offset < EmulatorConfigurationLayout::STRING_DATA_OFFSET || (size_t) offset + length > size)
+            return nullptr;
+
+        return internString((const char*) data + offset, length);
     }
 
-    if (isCopy) {
-        env->ReleaseStringUTFChars(nicknameString, nickname);
-        env->ReleaseStringUTFChars(messageString, message);
-        if (macAddress) env->ReleaseStringUTFChars(macAddressString, macAddress);
+    void copyString(char* destination, size_t destinationSize, const char* source)
+    {
+        if (source == nullptr)
+        {
+            destination[0] = '\0';
+            return;
+        }
+
+        strncpy(destination, source, destinationSize - 1);
+        destination[destinationSize - 1] = '\0';
     }
 
-    return finalFirmwareConfiguration;
+    /**
+     * Returns the number of bytes of the given data used by the configuration, or 0 if the data is null, truncated or was written with a
+     * different layout version.
+     */
+    u32 getValidatedDataSize(const u8* data, size_t size)
+    {
+        using namespace EmulatorConfigurationLayout;
+
+        if (data == nullptr || size < STRING_DATA_OFFSET || readValue<u32>(data, VERSION_OFFSET) != LAYOUT_VERSION)
+            return 0;
+
+        u32 dataSize = readValue<u32>(data, SIZE_OFFSET);
+        if (dataSize < STRING_DATA_OFFSET || dataSize > size)
+            return 0;
+
+        return dataSize;
+    }
 }
 
-std::unique_ptr<MelonDSAndroid::RenderSettings> MelonDSAndroidConfiguration::buildRenderSettings(JNIEnv* env, MelonDSAndroid::Renderer renderer, jobject renderSettings) {
-    jclass renderSettingsClass = env->GetObjectClass(renderSettings);
-    jmethodID getResolutionScalingMethod = env->GetMethodID(renderSettingsClass, "getResolutionScaling", "()I");
-    jboolean threadedRendering = env->GetBooleanField(renderSettings, env->GetFieldID(renderSettingsClass, "threadedRendering", "Z"));
-    jint internalResolutionScaling = env->CallIntMethod(renderSettings, getResolutionScalingMethod);
+const u8* MelonDSAndroidConfiguration::getConfigurationData(JNIEnv* env, jobject configurationBuffer, size_t& size)
+{
+    auto* data = (const u8*) env->GetDirectBufferAddress(configurationBuffer);
+    jlong capacity = env->GetDirectBufferCapacity(configurationBuffer);
+    size = data == nullptr || capacity < 0 ? 0 : getValidatedDataSize(data, (size_t) capacity);
+    return size > 0 ? data : nullptr;
+}
+
+bool MelonDSAndroidConfiguration::decodeEmulatorConfiguration(const u8* data, size_t size, MelonDSAndroid::EmulatorConfiguration& configuration)
+{
+    using namespace EmulatorConfigurationLayout;
+
+    u32 dataSize = getValidatedDataSize(data, size);
+    if (dataSize == 0)
+        return false;
+
+    bool useCustomBios = data[USE_CUSTOM_BIOS_OFFSET] != 0;
+    auto renderer = static_cast<MelonDSAndroid::Renderer>(readValue<s32>(data, RENDERER_OFFSET));
 
+    configuration.userInternalFirmwareAndBios = !useCustomBios;
+    configuration.dsBios7Path = const_cast<char*>(readString(data, dataSize, STRING_DS_BIOS7));
+    configuration.dsBios9Path = const_cast<char*>(readString(data, dataSize, STRING_DS_BIOS9));
+    configuration.dsFirmwarePath = const_cast<char*>(readString(data, dataSize, STRING_DS_FIRMWARE));
+    configuration.dsiBios7Path = const_cast<char*>(readString(data, dataSize, STRING_DSI_BIOS7));
+    configuration.dsiBios9Path = const_cast<char*>(readString(data, dataSize, STRING_DSI_BIOS9));
+    configuration.dsiFirmwarePath = const_cast<char*>(readString(data, dataSize, STRING_DSI_FIRMWARE));
+    configuration.dsiNandPath = const_cast<char*>(readString(data, dataSize, STRING_DSI_NAND));
+    configuration.internalFilesDir = const_cast<char*>(readString(data, dataSize, STRING_INTERNAL_DIRECTORY));
+    configuration.fastForwardSpeedMultiplier = readValue<float>(data, FAST_FORWARD_SPEED_MULTIPLIER_OFFSET);
+    configuration.showBootScreen = data[SHOW_BOOT_SCREEN_OFFSET] != 0;
+    configuration.useJit = data[USE_JIT_OFFSET] != 0;
+    configuration.consoleType = readValue<s32>(data, CONSOLE_TYPE_OFFSET);
+    configuration.audioSettings = MelonDSAndroid::AudioSettings {
+        .soundEnabled = data[SOUND_ENABLED_OFFSET] != 0,
+        .volume = readValue<s32>(data, VOLUME_OFFSET),
+        .audioInterpolation = readValue<s32>(data, AUDIO_INTERPOLATION_OFFSET),
+        .audioBitrate = readValue<s32>(data, AUDIO_BITRATE_OFFSET),
+        .audioLatency = readValue<s32>(data, AUDIO_LATENCY_OFFSET),
+        .micSource = readValue<s32>(data, MIC_SOURCE_OFFSET),
+    };
+
+    MelonDSAndroid::FirmwareConfiguration& firmwareConfiguration = configuration.firmwareConfiguration;
+    copyString(firmwareConfiguration.username, sizeof(firmwareConfiguration.username), readString(data, dataSize, STRING_FIRMWARE_NICKNAME));
+    copyString(firmwareConfiguration.message, sizeof(firmwareConfiguration.message), readString(data, dataSize, STRING_FIRMWARE_MESSAGE));
+    copyString(firmwareConfiguration.macAddress, sizeof(firmwareConfiguration.macAddress), readString(data, dataSize, STRING_FIRMWARE_MAC_ADDRESS));
+    firmwareConfiguration.language = readValue<s32>(data, FIRMWARE_LANGUAGE_OFFSET);
+    firmwareConfiguration.favouriteColour = readValue<s32>(data, FIRMWARE_FAVOURITE_COLOUR_OFFSET);
+    firmwareConfiguration.birthdayDay = readValue<s32>(data, FIRMWARE_BIRTHDAY_DAY_OFFSET);
+    firmwareConfiguration.birthdayMonth = readValue<s32>(data, FIRMWARE_BIRTHDAY_MONTH_OFFSET);
+    firmwareConfiguration.randomizeMacAddress = data[RANDOMIZE_MAC_ADDRESS_OFFSET] != 0;
+
+    configuration.rewindEnabled = data[REWIND_ENABLED_OFFSET] != 0 ? 1 : 0;
+    configuration.rewindCaptureSpacingSeconds = readValue<s32>(data, REWIND_PERIOD_SECONDS_OFFSET);
+    configuration.rewindLengthSeconds = readValue<s32>(data, REWIND_WINDOW_SECONDS_OFFSET);
+    configuration.renderSettings = buildRenderSettings(renderer, readValue<s32>(data, RESOLUTION_SCALING_OFFSET), data[THREADED_RENDERING_OFFSET] != 0);
+    configuration.dsiSdCardSettings = MelonDSAndroid::SdCardSettings { .enabled = false };
+    configuration.dldiSdCardSettings = MelonDSAndroid::SdCardSettings { .enabled = false };
+    configuration.renderer = renderer;
+    return true;
+}
+
+bool MelonDSAndroidConfiguration::decodeEmulatorConfiguration(JNIEnv* env, jobject configurationBuffer, MelonDSAndroid::EmulatorConfiguration& configuration)
+{
+    size_t size;
+    const u8* data = getConfigurationData(env, configurationBuffer, size);
+    return decodeEmulatorConfiguration(data, size, configuration);
+}
+
+std::unique_ptr<MelonDSAndroid::RenderSettings> MelonDSAndroidConfiguration::buildRenderSettings(MelonDSAndroid::Renderer renderer, int resolutionScaling, bool threadedRendering) {
     std::unique_ptr<MelonDSAndroid::RenderSettings> settings;
     if (renderer == MelonDSAndroid::Renderer::OpenGl)
     {
         settings = std::make_unique<MelonDSAndroid::OpenGlRenderSettings>(
             MelonDSAndroid::OpenGlRenderSettings {
                 .betterPolygons = false,
-                .scale = internalResolutionScaling,
+                .scale = resolutionScaling,
             }
         );
     }
@@ -161,7 +158,7 @@ std::unique_ptr<MelonDSAndroid::RenderSettings> MelonDSAndroidConfiguration::bui
     {
         settings = std::make_unique<MelonDSAndroid::ComputeRenderSettings>(
             MelonDSAndroid::ComputeRenderSettings {
-                .scale = internalResolutionScaling,
+                .scale = resolutionScaling,
                 .highResCoordinates = true,
             }
         );
@@ -170,10 +167,19 @@ std::unique_ptr<MelonDSAndroid::RenderSettings> MelonDSAndroidConfiguration::bui
     {
         settings = std::make_unique<MelonDSAndroid::SoftwareRenderSettings>(
             MelonDSAndroid::SoftwareRenderSettings {
-                .threadedRendering = (bool) threadedRendering
+                .threadedRendering = threadedRendering
             }
         );
     }
 
     return settings;
-}
\ No newline at end of file
+}
+
+int MelonDSAndroidConfiguration::getRewindThumbnailScale(JNIEnv* env, jobject configurationBuffer) {
+    size_t size;
+    const u8* data = getConfigurationData(env, configurationBuffer, size);
+    if (data == nullptr)
+        return 0;
+
+    return readValue<s32>(data, EmulatorConfigurationLayout::REWIND_THUMBNAIL_SCALE_OFFSET);
+}
@@ -1,13 +1,30 @@
 #ifndef MELONDSANDROIDCONFIGURATION_H
 #define MELONDSANDROIDCONFIGURATION_H
 
+#include <cstddef>
 #include "Configuration.h"
 #include "MelonDS.h"
 
 namespace MelonDSAndroidConfiguration {
-    MelonDSAndroid::EmulatorConfiguration buildEmulatorConfiguration(JNIEnv* env, jobject emulatorConfiguration);
-    MelonDSAndroid::FirmwareConfiguration buildFirmwareConfiguration(JNIEnv* env, jobject firmwareConfiguration);
-    std::unique_ptr<MelonDSAndroid::RenderSettings> buildRenderSettings(JNIEnv* env, MelonDSAndroid::Renderer renderer, jobject renderSettings);
+    /**
+     * Returns the address of the configuration stored in the given direct buffer, and sets size to the number of bytes it uses. Returns null if
+     * the buffer is not direct, or if the configuration is truncated or was written with a different layout version.
+     */
+    const melonDS::u8* getConfigurationData(JNIEnv* env, jobject configurationBuffer, size_t& size);
+
+    /**
+     * Decodes a configuration serialized with the layout described in EmulatorConfigurationLayout.h. Strings are interned, so the returned
+     * configuration can keep pointing to them for as long as it needs.
+     *
+     * @return False if the data was written with a different layout version or is truncated
+     */
+    bool decodeEmulatorConfiguration(const melonDS::u8* data, size_t size, MelonDSAndroid::EmulatorConfiguration& configuration);
+    bool decodeEmulatorConfiguration(JNIEnv* env, jobject configurationBuffer, MelonDSAndroid::EmulatorConfiguration& configuration);
+    std::unique_ptr<MelonDSAndroid::RenderSettings> buildRenderSettings(MelonDSAndroid::Renderer renderer, int resolutionScaling, bool threadedRendering);
+    /**
+     * @return The rewind thumbnail scale, or 0 if the buffer does not hold a valid configuration
+     */
+    int getRewindThumbnailScale(JNIEnv* env, jobject configurationBuffer);
 }
 
 #endif //MELONDSANDROIDCONFIGURATION_H
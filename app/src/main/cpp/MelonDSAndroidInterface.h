@@ -2,7 +2,9 @@
 #define MELONDSANDROIDINTERFACE_H
 
 #include "JniEnvHandler.h"
+#include "UriFileHandler.h"
 
 extern JniEnvHandler* jniEnvHandler;
+extern UriFileHandler* fileHandler;
 
 #endif //MELONDSANDROIDINTERFACE_H
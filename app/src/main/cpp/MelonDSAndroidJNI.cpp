@@ -1,6 +1,8 @@
 #include <EGL/egl.h>
 #include <EGL/eglext.h>
 #include <jni.h>
+#include <cstring>
+#include <mutex>
 #include <string>
 #include <sstream>
 #include <stdlib.h>
@@ -17,8 +19,16 @@
 #include "AndroidMelonEventMessenger.h"
 #include "MelonDSAndroidInterface.h"
 #include "MelonDSAndroidConfiguration.h"
+#include "EmulatorConfigurationDiff.h"
+#include "EmulatorConfigurationLayout.h"
 #include "MelonDSAndroidCameraHandler.h"
 #include "RetroAchievementsMapper.h"
+#include "rewind/RewindHistory.h"
+#include "rewind/RewindCaptureWorker.h"
+#include "savestate/SaveStateContainer.h"
+#include "savestate/SaveStateWriter.h"
+#include "sram/SramPersister.h"
+#include "videofilter/VideoFilterPipeline.h"
 #include "performancehint/ThreadSafePerformanceHintSession.h"
 #include "performancehint/PerformanceHintManagerFactory.h"
 
@@ -33,6 +43,18 @@ enum GbaSlotType {
 
 void* emulate(void*);
 MelonDSAndroid::RomGbaSlotConfig* buildGbaSlotConfig(GbaSlotType slotType, const char* romPath, const char* savePath);
+void configureRewindHistory(MelonDSAndroid::EmulatorConfiguration& configuration, int thumbnailScale);
+void copyConfigurationData(JNIEnv* env, jobject configurationBuffer, std::vector<u8>& output);
+void applyPendingConfiguration();
+void updateCoreRewindInterval(const MelonDSAndroid::EmulatorConfiguration& configuration);
+void captureRewindState();
+void clearRewindHistory();
+void logRewindHistoryStats();
+bool loadSaveStateFile(const char* path);
+double getCurrentMillis();
+void startSramPersister(const char* path);
+void flushSramPersisters();
+void stopSramPersisters();
 
 pthread_t emuThread;
 pthread_mutex_t emuThreadMutex;
@@ -52,6 +74,35 @@ bool isFastForwardEnabled = false;
 jobject globalCameraManager;
 MelonDSAndroidCameraHandler* androidCameraHandler;
 
+// The core only keeps the most recent captures. The rest of the rewind window is stored compressed in the rewind history
+static const int CORE_REWIND_STATES = 2;
+RewindHistory rewindHistory;
+RewindCaptureWorker rewindCaptureWorker(rewindHistory);
+std::atomic_bool isRewindEnabled = false;
+int rewindCaptureSpacingSeconds = 0;
+// Frames between two rewind captures of the configuration the core is currently running with. The core keeps every capture for at least that
+// long, so its rewind window only has to be polled once per interval
+int coreRewindIntervalFrames = 0;
+int framesUntilRewindPoll = 0;
+std::vector<u8> rewindStateBuffer;
+std::vector<u8> rewindScreenshotBuffer;
+std::unique_ptr<SaveStateWriter> saveStateWriter;
+std::vector<std::shared_ptr<SramPersister>> sramPersisters;
+// Screenshot buffer shared with the core. Updated by the core on every frame
+u8* emulatorScreenshotBuffer = nullptr;
+VideoFilterPipeline videoFilterPipeline;
+
+// Rewind window descriptor tables exposed to Kotlin as direct ByteBuffers. A table is only replaced when the history grows past its size. Tables
+// are never freed, since rewind windows in Kotlin may still point to them. They are small and only grow when the rewind length is increased
+std::vector<std::unique_ptr<u8[]>> rewindWindowTables;
+size_t rewindWindowTableSize = 0;
+
+// Serialized configuration that was last handed to the core. Used to find which fields change when the configuration is updated
+std::vector<u8> appliedConfigurationData;
+// Configuration update waiting to be applied by the emulator thread at the next frame boundary
+std::mutex pendingConfigurationMutex;
+std::unique_ptr<MelonDSAndroid::EmulatorConfiguration> pendingConfiguration;
+
 static const int64_t FRAME_DURATION_60FPS_NS = 16666666;
 static const int64_t FRAME_DURATION_1000FPS_NS = 1000000; // 1ms. Used as frame time when fast-forward is enabled
 ThreadSafePerformanceHintSession* performanceHintSession = nullptr;
@@ -61,15 +112,30 @@ extern "C"
 JNIEXPORT void JNICALL
 Java_me_magnum_melonds_MelonEmulator_setupEmulator(JNIEnv* env, jobject thiz, jobject emulatorConfiguration, jobject cameraManager, jobject screenshotBuffer)
 {
-    MelonDSAndroid::EmulatorConfiguration finalEmulatorConfiguration = MelonDSAndroidConfiguration::buildEmulatorConfiguration(env, emulatorConfiguration);
+    MelonDSAndroid::EmulatorConfiguration finalEmulatorConfiguration;
+    if (!MelonDSAndroidConfiguration::decodeEmulatorConfiguration(env, emulatorConfiguration, finalEmulatorConfiguration))
+    {
+        melonDS::Platform::Log(melonDS::Platform::LogLevel::Error, "Invalid emulator configuration layout");
+        return;
+    }
+
+    copyConfigurationData(env, emulatorConfiguration, appliedConfigurationData);
     fastForwardSpeedMultiplier = finalEmulatorConfiguration.fastForwardSpeedMultiplier;
+    rewindHistory.clear();
+    configureRewindHistory(finalEmulatorConfiguration, MelonDSAndroidConfiguration::getRewindThumbnailScale(env, emulatorConfiguration));
+    rewindCaptureWorker.start();
+
+    saveStateWriter = std::make_unique<SaveStateWriter>(fileHandler);
+    saveStateWriter->start();
 
     globalCameraManager = env->NewGlobalRef(cameraManager);
 
     auto androidEventMessenger = std::make_shared<AndroidMelonEventMessenger>();
     androidCameraHandler = new MelonDSAndroidCameraHandler(jniEnvHandler, globalCameraManager);
     u32* screenshotBufferPointer = (u32*) env->GetDirectBufferAddress(screenshotBuffer);
+    emulatorScreenshotBuffer = (u8*) screenshotBufferPointer;
 
+    updateCoreRewindInterval(finalEmulatorConfiguration);
     MelonDSAndroid::setConfiguration(std::move(finalEmulatorConfiguration));
     MelonDSAndroid::setup(androidCameraHandler, std::move(androidEventMessenger), screenshotBufferPointer, 0);
     paused = false;
@@ -222,6 +288,15 @@ Java_me_magnum_melonds_MelonEmulator_loadRomInternal(JNIEnv* env, jobject thiz,
     int result = MelonDSAndroid::loadRom(rom, sram, gbaSlotConfig);
     delete gbaSlotConfig;
 
+    // Save files are only redirected once the core has loaded them
+    stopSramPersisters();
+    if (result == 0 || result == 1) {
+        startSramPersister(sram);
+    }
+    if (result == 0 && gbaSlotType == GbaSlotType::GBA_ROM) {
+        startSramPersister(gbaSram);
+    }
+
     if (isCopy == JNI_TRUE) {
         if (romPath) env->ReleaseStringUTFChars(romPath, rom);
         if (sramPath) env->ReleaseStringUTFChars(sramPath, sram);
@@ -283,7 +358,10 @@ Java_me_magnum_melonds_MelonEmulator_presentFrame(JNIEnv* env, jobject thiz, jlo
     if (presentationFrame != nullptr)
     {
         eglWaitSyncKHR(currentDisplay, presentationFrame->renderFence, 0);
-        env->CallVoidMethod(renderFrameCallback, renderFrameMethodId, true, (jint) presentationFrame->frameTexture);
+        // The CPU filters work from the screenshot buffer, so the core's texture is only used when filtering is disabled or no frame is ready yet
+        GLuint filteredTexture = videoFilterPipeline.renderLatestFrame();
+        GLuint frameTexture = filteredTexture != 0 ? filteredTexture : presentationFrame->frameTexture;
+        env->CallVoidMethod(renderFrameCallback, renderFrameMethodId, true, (jint) frameTexture);
         EGLSyncKHR presentFence = eglCreateSyncKHR(currentDisplay, EGL_SYNC_FENCE_KHR, nullptr);
         presentationFrame->presentFence = presentFence;
     }
@@ -315,6 +393,9 @@ Java_me_magnum_melonds_MelonEmulator_pauseEmulation(JNIEnv* env, jobject thiz)
     }
 
     MelonDSAndroid::pause();
+    // Pausing happens when the app goes to the background, so save data must reach storage soon in case the app is killed. The write-back
+    // happens on the persister threads, so the caller is not blocked by storage I/O
+    flushSramPersisters();
 }
 
 JNIEXPORT void JNICALL
@@ -352,6 +433,7 @@ Java_me_magnum_melonds_MelonEmulator_resetEmulation(JNIEnv* env, jobject thiz) {
         // Make sure that the thread is really paused to avoid data corruption
         while (!isThreadReallyPaused);
         MelonDSAndroid::reset();
+        clearRewindHistory();
         Java_me_magnum_melonds_MelonEmulator_resumeEmulation(env, thiz);
     } else {
         // If the emulation is stopping, just ignore it
@@ -360,21 +442,83 @@ Java_me_magnum_melonds_MelonEmulator_resetEmulation(JNIEnv* env, jobject thiz) {
 }
 
 JNIEXPORT jboolean JNICALL
-Java_me_magnum_melonds_MelonEmulator_saveStateInternal(JNIEnv* env, jobject thiz, jstring path)
+Java_me_magnum_melonds_MelonEmulator_saveStateAsyncInternal(JNIEnv* env, jobject thiz, jstring path, jstring temporaryPath, jstring screenshotPath, jint requestId)
 {
-    const char* saveStatePath = path == nullptr ? nullptr : env->GetStringUTFChars(path, JNI_FALSE);
-    return MelonDSAndroid::saveState(saveStatePath);
+    const char* saveStatePathChars = env->GetStringUTFChars(path, JNI_FALSE);
+    const char* temporarySaveStatePathChars = env->GetStringUTFChars(temporaryPath, JNI_FALSE);
+    std::string saveStatePath = saveStatePathChars;
+    std::string temporarySaveStatePath = temporarySaveStatePathChars;
+    env->ReleaseStringUTFChars(path, saveStatePathChars);
+    env->ReleaseStringUTFChars(temporaryPath, temporarySaveStatePathChars);
+
+    std::string screenshotFilePath;
+    if (screenshotPath != nullptr) {
+        const char* screenshotPathChars = env->GetStringUTFChars(screenshotPath, JNI_FALSE);
+        screenshotFilePath = screenshotPathChars;
+        env->ReleaseStringUTFChars(screenshotPath, screenshotPathChars);
+    }
+    std::vector<u8> screenshot;
+
+    bool result = false;
+    char* saveStateData = nullptr;
+    size_t saveStateSize = 0;
+
+    pthread_mutex_lock(&emuThreadMutex);
+    if (!stop) {
+        bool wasPaused = paused;
+        if (paused) {
+            pthread_mutex_unlock(&emuThreadMutex);
+        } else {
+            pthread_mutex_unlock(&emuThreadMutex);
+            Java_me_magnum_melonds_MelonEmulator_pauseEmulation(env, thiz);
+        }
+
+        // Make sure that the thread is really paused so that the state is captured at a frame boundary
+        while (!isThreadReallyPaused);
+
+        // The state is serialized into memory. Writing it to storage is done by the save state writer
+        fileHandler->beginMemoryCapture(temporarySaveStatePath.c_str());
+        result = MelonDSAndroid::saveState(temporarySaveStatePath.c_str());
+        saveStateData = fileHandler->finishMemoryCapture(saveStateSize);
+
+        // The screenshot buffer is updated on every frame, so it must be copied before resuming. It is encoded later by the save state writer
+        if (result && !screenshotFilePath.empty() && emulatorScreenshotBuffer != nullptr) {
+            screenshot.assign(emulatorScreenshotBuffer, emulatorScreenshotBuffer + SaveStateWriter::SCREENSHOT_SIZE);
+        }
+
+        // Resume emulation if it was running
+        if (!wasPaused) {
+            Java_me_magnum_melonds_MelonEmulator_resumeEmulation(env, thiz);
+        }
+    } else {
+        // If the emulation is stopping, just ignore it
+        pthread_mutex_unlock(&emuThreadMutex);
+    }
+
+    if (!result || saveStateData == nullptr)
+    {
+        free(saveStateData);
+        return false;
+    }
+
+    saveStateWriter->enqueue(requestId, saveStateData, saveStateSize, std::move(temporarySaveStatePath), std::move(saveStatePath), std::move(screenshot), std::move(screenshotFilePath));
+    return true;
 }
 
 JNIEXPORT jboolean JNICALL
 Java_me_magnum_melonds_MelonEmulator_loadStateInternal(JNIEnv* env, jobject thiz, jstring path)
 {
-    const char* saveStatePath = path == nullptr ? nullptr : env->GetStringUTFChars(path, JNI_FALSE);
-    return MelonDSAndroid::loadState(saveStatePath);
+    const char* saveStatePath = env->GetStringUTFChars(path, JNI_FALSE);
+    bool result = loadSaveStateFile(saveStatePath);
+    env->ReleaseStringUTFChars(path, saveStatePath);
+    if (result)
+        clearRewindHistory();
+
+    return result;
 }
 
 JNIEXPORT jboolean JNICALL
-Java_me_magnum_melonds_MelonEmulator_loadRewindState(JNIEnv* env, jobject thiz, jobject rewindSaveState) {
+Java_me_magnum_melonds_MelonEmulator_loadRewindStateInternal(JNIEnv* env, jobject thiz, jint frame) {
     bool result = true;
 
     pthread_mutex_lock(&emuThreadMutex);
@@ -387,29 +531,30 @@ Java_me_magnum_melonds_MelonEmulator_loadRewindState(JNIEnv* env, jobject thiz,
             Java_me_magnum_melonds_MelonEmulator_pauseEmulation(env, thiz);
         }
 
-        jclass rewindSaveStateClass = env->FindClass("me/magnum/melonds/ui/emulator/rewind/model/RewindSaveState");
-        jfieldID bufferField = env->GetFieldID(rewindSaveStateClass, "buffer", "Ljava/nio/ByteBuffer;");
-        jfieldID bufferContentSizeField = env->GetFieldID(rewindSaveStateClass, "bufferContentSize", "J");
-        jfieldID screenshotBufferField = env->GetFieldID(rewindSaveStateClass, "screenshotBuffer", "Ljava/nio/ByteBuffer;");
-        jfieldID frameField = env->GetFieldID(rewindSaveStateClass, "frame", "I");
-        jobject buffer = env->GetObjectField(rewindSaveState, bufferField);
-        jlong bufferContentSize = env->GetLongField(rewindSaveState, bufferContentSizeField);
-        jobject screenshotBuffer = env->GetObjectField(rewindSaveState, screenshotBufferField);
-        jint frame = (int) env->GetIntField(rewindSaveState, frameField);
-
         // Make sure that the thread is really paused to avoid data corruption
         while (!isThreadReallyPaused);
 
-        melonDS::RewindSaveState state = melonDS::RewindSaveState {
-            .buffer = (u8*) env->GetDirectBufferAddress(buffer),
-            .bufferSize = (u32) env->GetDirectBufferCapacity(buffer),
-            .bufferContentSize = (u32) bufferContentSize,
-            .screenshot = (u8*) env->GetDirectBufferAddress(screenshotBuffer),
-            .screenshotSize = (u32) env->GetDirectBufferCapacity(screenshotBuffer),
-            .frame = frame
-        };
+        // Captures that have not been inserted yet are newer than any state in the window, so they would be discarded by the rewind anyway
+        rewindCaptureWorker.discardPending();
 
-        result = MelonDSAndroid::loadRewindState(state);
+        u32 stateContentSize;
+        if (rewindHistory.rewindToState(frame, rewindStateBuffer, stateContentSize, rewindScreenshotBuffer))
+        {
+            melonDS::RewindSaveState state = melonDS::RewindSaveState {
+                .buffer = rewindStateBuffer.data(),
+                .bufferSize = (u32) rewindStateBuffer.size(),
+                .bufferContentSize = stateContentSize,
+                .screenshot = rewindScreenshotBuffer.data(),
+                .screenshotSize = (u32) rewindScreenshotBuffer.size(),
+                .frame = frame
+            };
+
+            result = MelonDSAndroid::loadRewindState(state);
+        }
+        else
+        {
+            result = false;
+        }
 
         // Resume emulation if it was running
         if (!wasPaused) {
@@ -423,30 +568,39 @@ Java_me_magnum_melonds_MelonEmulator_loadRewindState(JNIEnv* env, jobject thiz,
     return result;
 }
 
-JNIEXPORT jobject JNICALL
-Java_me_magnum_melonds_MelonEmulator_getRewindWindow(JNIEnv* env, jobject thiz) {
+JNIEXPORT jint JNICALL
+Java_me_magnum_melonds_MelonEmulator_writeRewindWindowTable(JNIEnv* env, jobject thiz) {
+    rewindCaptureWorker.waitUntilIdle();
     auto currentRewindWindow = MelonDSAndroid::getRewindWindow();
 
-    jclass rewindSaveStateClass = env->FindClass("me/magnum/melonds/ui/emulator/rewind/model/RewindSaveState");
-    jmethodID rewindSaveStateConstructor = env->GetMethodID(rewindSaveStateClass, "<init>", "(Ljava/nio/ByteBuffer;JLjava/nio/ByteBuffer;I)V");
+    u32 maxDescriptors = std::max<u32>(rewindHistory.getMaxStates(), 1);
+    size_t tableSize = RewindHistory::getDescriptorTableSize(maxDescriptors);
+    if (tableSize > rewindWindowTableSize)
+    {
+        rewindWindowTables.push_back(std::make_unique<u8[]>(tableSize));
+        rewindWindowTableSize = tableSize;
+    }
 
-    jclass listClass = env->FindClass("java/util/ArrayList");
-    jmethodID listConstructor = env->GetMethodID(listClass, "<init>", "()V");
-    jmethodID listAddMethod = env->GetMethodID(listClass, "add", "(ILjava/lang/Object;)V");
-    jobject rewindStateList = env->NewObject(listClass, listConstructor);
+    rewindHistory.writeDescriptorTable(rewindWindowTables.back().get(), maxDescriptors, currentRewindWindow.currentFrame);
+    return (jint) rewindWindowTableSize;
+}
 
-    int index = 0;
-    for (auto state : currentRewindWindow.rewindStates) {
-        jobject stateBuffer = env->NewDirectByteBuffer(state.buffer, state.bufferSize);
-        jobject stateScreenshot = env->NewDirectByteBuffer(state.screenshot, state.screenshotSize);
-        jobject rewindSaveState = env->NewObject(rewindSaveStateClass, rewindSaveStateConstructor, stateBuffer, (jlong) state.bufferContentSize, stateScreenshot, state.frame);
-        env->CallVoidMethod(rewindStateList, listAddMethod, index++, rewindSaveState);
-    }
+JNIEXPORT jobject JNICALL
+Java_me_magnum_melonds_MelonEmulator_getRewindWindowTable(JNIEnv* env, jobject thiz) {
+    if (rewindWindowTables.empty())
+        return nullptr;
+
+    return env->NewDirectByteBuffer(rewindWindowTables.back().get(), (jlong) rewindWindowTableSize);
+}
 
-    jclass rewindWindowClass = env->FindClass("me/magnum/melonds/ui/emulator/rewind/model/RewindWindow");
-    jmethodID rewindWindowConstructor = env->GetMethodID(rewindWindowClass, "<init>", "(ILjava/util/ArrayList;)V");
-    jobject rewindWindow = env->NewObject(rewindWindowClass, rewindWindowConstructor, currentRewindWindow.currentFrame, rewindStateList);
-    return rewindWindow;
+JNIEXPORT jboolean JNICALL
+Java_me_magnum_melonds_MelonEmulator_getRewindStateThumbnail(JNIEnv* env, jobject thiz, jint frame, jobject thumbnailBuffer) {
+    u8* thumbnailBufferPointer = (u8*) env->GetDirectBufferAddress(thumbnailBuffer);
+    jlong thumbnailBufferSize = env->GetDirectBufferCapacity(thumbnailBuffer);
+    if (thumbnailBufferPointer == nullptr || thumbnailBufferSize <= 0)
+        return false;
+
+    return rewindHistory.copyThumbnail(frame, thumbnailBufferPointer, thumbnailBufferSize);
 }
 
 JNIEXPORT void JNICALL
@@ -466,7 +620,32 @@ Java_me_magnum_melonds_MelonEmulator_stopEmulation(JNIEnv* env, jobject thiz)
         pthread_cond_destroy(&emuThreadCond);
     }
 
+    {
+        std::lock_guard<std::mutex> lock(pendingConfigurationMutex);
+        pendingConfiguration.reset();
+    }
+    appliedConfigurationData.clear();
+    videoFilterPipeline.reset();
+
+    logRewindHistoryStats();
+    rewindCaptureWorker.stop();
+
+    // Pending save states are still written before stopping
+    if (saveStateWriter)
+    {
+        saveStateWriter->stop();
+        saveStateWriter.reset();
+    }
+    isRewindEnabled = false;
+    rewindHistory.clear();
+
     MelonDSAndroid::cleanup();
+    // The core may write save data while cleaning up
+    stopSramPersisters();
+
+    UriFileHandler::DescriptorCacheStats descriptorCacheStats = fileHandler->getDescriptorCacheStats();
+    melonDS::Platform::Log(melonDS::Platform::LogLevel::Info, "File descriptor cache: %u hits, %u misses", descriptorCacheStats.hits, descriptorCacheStats.misses);
+    fileHandler->clearDescriptorCache();
 
     env->DeleteGlobalRef(globalCameraManager);
 
@@ -525,6 +704,12 @@ Java_me_magnum_melonds_MelonEmulator_setFastForwardEnabled(JNIEnv* env, jobject
     }
 }
 
+JNIEXPORT void JNICALL
+Java_me_magnum_melonds_MelonEmulator_setCpuVideoFilter(JNIEnv* env, jobject thiz, jint filter)
+{
+    videoFilterPipeline.setFilter(filter);
+}
+
 JNIEXPORT void JNICALL
 Java_me_magnum_melonds_MelonEmulator_setMicrophoneEnabled(JNIEnv* env, jobject thiz, jboolean enabled)
 {
@@ -534,14 +719,63 @@ Java_me_magnum_melonds_MelonEmulator_setMicrophoneEnabled(JNIEnv* env, jobject t
         MelonDSAndroid::userDisableMic();
 }
 
-JNIEXPORT void JNICALL
+JNIEXPORT jint JNICALL
 Java_me_magnum_melonds_MelonEmulator_updateEmulatorConfiguration(JNIEnv* env, jobject thiz, jobject emulatorConfiguration)
 {
-    MelonDSAndroid::EmulatorConfiguration newConfiguration = MelonDSAndroidConfiguration::buildEmulatorConfiguration(env, emulatorConfiguration);
+    auto newConfiguration = std::make_unique<MelonDSAndroid::EmulatorConfiguration>();
+    if (!MelonDSAndroidConfiguration::decodeEmulatorConfiguration(env, emulatorConfiguration, *newConfiguration))
+    {
+        melonDS::Platform::Log(melonDS::Platform::LogLevel::Error, "Invalid emulator configuration layout");
+        return 0;
+    }
+
+    std::vector<u8> newConfigurationData;
+    copyConfigurationData(env, emulatorConfiguration, newConfigurationData);
+    EmulatorConfigurationDiff::Changes changes;
+    if (appliedConfigurationData.empty())
+    {
+        // Nothing to compare against. Treat everything as changed
+        changes = {
+            .changeClasses = EmulatorConfigurationDiff::CHANGE_HOT | EmulatorConfigurationDiff::CHANGE_WARM | EmulatorConfigurationDiff::CHANGE_COLD,
+            .affectsCore = true,
+        };
+    }
+    else
+    {
+        changes = EmulatorConfigurationDiff::diff(appliedConfigurationData.data(), appliedConfigurationData.size(), newConfigurationData.data(), newConfigurationData.size());
+    }
 
-    fastForwardSpeedMultiplier = newConfiguration.fastForwardSpeedMultiplier;
+    if (changes.changeClasses == 0)
+        return 0;
 
-    MelonDSAndroid::updateEmulatorConfiguration(std::make_unique<MelonDSAndroid::EmulatorConfiguration>(std::move(newConfiguration)));
+    appliedConfigurationData = std::move(newConfigurationData);
+    fastForwardSpeedMultiplier = newConfiguration->fastForwardSpeedMultiplier;
+    configureRewindHistory(*newConfiguration, MelonDSAndroidConfiguration::getRewindThumbnailScale(env, emulatorConfiguration));
+
+    if (changes.affectsCore)
+    {
+        if (started)
+        {
+            // Replacing the configuration in the middle of a frame could leave the renderer and the audio output out of sync with each other.
+            // Let the emulator thread apply it between frames instead. If several updates arrive in the same frame, only the newest one is kept
+            std::lock_guard<std::mutex> lock(pendingConfigurationMutex);
+            pendingConfiguration = std::move(newConfiguration);
+        }
+        else
+        {
+            updateCoreRewindInterval(*newConfiguration);
+            MelonDSAndroid::updateEmulatorConfiguration(std::move(newConfiguration));
+        }
+    }
+
+    melonDS::Platform::Log(
+        melonDS::Platform::LogLevel::Info,
+        "Emulator configuration updated (hot: %d, warm: %d, cold: %d, core: %d)",
+        (changes.changeClasses & EmulatorConfigurationDiff::CHANGE_HOT) != 0,
+        (changes.changeClasses & EmulatorConfigurationDiff::CHANGE_WARM) != 0,
+        (changes.changeClasses & EmulatorConfigurationDiff::CHANGE_COLD) != 0,
+        changes.affectsCore
+    );
 
     if (isFastForwardEnabled) {
         limitFps = fastForwardSpeedMultiplier > 0;
@@ -556,6 +790,8 @@ Java_me_magnum_melonds_MelonEmulator_updateEmulatorConfiguration(JNIEnv* env, jo
             }
         }
     }
+
+    return changes.changeClasses;
 }
 }
 
@@ -583,6 +819,212 @@ MelonDSAndroid::RomGbaSlotConfig* buildGbaSlotConfig(GbaSlotType slotType, const
     }
 }
 
+void configureRewindHistory(MelonDSAndroid::EmulatorConfiguration& configuration, int thumbnailScale)
+{
+    rewindHistory.setThumbnailScale(thumbnailScale);
+
+    if (!configuration.rewindEnabled || configuration.rewindCaptureSpacingSeconds <= 0)
+    {
+        isRewindEnabled = false;
+        rewindHistory.setMaxStates(0);
+        return;
+    }
+
+    u32 maxStates = std::max(1, configuration.rewindLengthSeconds / configuration.rewindCaptureSpacingSeconds);
+    rewindHistory.setMaxStates(maxStates);
+    rewindCaptureSpacingSeconds = configuration.rewindCaptureSpacingSeconds;
+    isRewindEnabled = true;
+
+    configuration.rewindLengthSeconds = configuration.rewindCaptureSpacingSeconds * CORE_REWIND_STATES;
+}
+
+void copyConfigurationData(JNIEnv* env, jobject configurationBuffer, std::vector<u8>& output)
+{
+    size_t size;
+    const u8* data = MelonDSAndroidConfiguration::getConfigurationData(env, configurationBuffer, size);
+    if (data == nullptr)
+    {
+        output.clear();
+        return;
+    }
+
+    output.assign(data, data + size);
+}
+
+void applyPendingConfiguration()
+{
+    std::unique_ptr<MelonDSAndroid::EmulatorConfiguration> configuration;
+    {
+        std::lock_guard<std::mutex> lock(pendingConfigurationMutex);
+        if (!pendingConfiguration)
+            return;
+
+        configuration = std::move(pendingConfiguration);
+    }
+
+    updateCoreRewindInterval(*configuration);
+    MelonDSAndroid::updateEmulatorConfiguration(std::move(configuration));
+}
+
+void updateCoreRewindInterval(const MelonDSAndroid::EmulatorConfiguration& configuration)
+{
+    if (configuration.rewindEnabled && configuration.rewindCaptureSpacingSeconds > 0)
+        coreRewindIntervalFrames = configuration.rewindCaptureSpacingSeconds * 60;
+    else
+        coreRewindIntervalFrames = 0;
+
+    framesUntilRewindPoll = 0;
+}
+
+void captureRewindState()
+{
+    // The core has not applied a configuration with rewind enabled yet
+    if (coreRewindIntervalFrames <= 0)
+        return;
+
+    if (framesUntilRewindPoll > 0)
+    {
+        framesUntilRewindPoll--;
+        return;
+    }
+
+    framesUntilRewindPoll = coreRewindIntervalFrames - 1;
+
+    auto currentRewindWindow = MelonDSAndroid::getRewindWindow();
+    int latestFrame = std::max(rewindHistory.getLatestFrame(), rewindCaptureWorker.getLatestSubmittedFrame());
+
+    if (currentRewindWindow.currentFrame < latestFrame)
+    {
+        // The emulation timeline went backwards without going through the history (reset, for example). The stored states are no longer valid
+        clearRewindHistory();
+        latestFrame = -1;
+    }
+
+    const melonDS::RewindSaveState* newestState = nullptr;
+    for (const auto& state : currentRewindWindow.rewindStates)
+    {
+        // States ahead of the current frame are leftovers from before a rewind
+        if (state.frame <= latestFrame || state.frame > currentRewindWindow.currentFrame)
+            continue;
+
+        if (newestState == nullptr || state.frame > newestState->frame)
+            newestState = &state;
+    }
+
+    if (newestState != nullptr)
+        rewindCaptureWorker.submit(newestState->frame, newestState->buffer, newestState->bufferContentSize, newestState->bufferSize, newestState->screenshot, newestState->screenshotSize);
+}
+
+void clearRewindHistory()
+{
+    rewindCaptureWorker.discardPending();
+    rewindHistory.clear();
+}
+
+bool loadSaveStateFile(const char* path)
+{
+    std::vector<u8> saveStateData;
+    SaveStateContainer::ReadResult readResult = SaveStateContainer::ReadResult::NotContainer;
+
+    double startTime = getCurrentMillis();
+    FILE* file = fileHandler->open(path, melonDS::Platform::FileMode::Read);
+    if (file != nullptr)
+    {
+        readResult = SaveStateContainer::read(file, saveStateData);
+        fclose(file);
+    }
+
+    switch (readResult)
+    {
+        case SaveStateContainer::ReadResult::NotContainer:
+            // Save state from an older version. The core reads it directly
+            return MelonDSAndroid::loadState(path);
+        case SaveStateContainer::ReadResult::Invalid:
+            melonDS::Platform::Log(melonDS::Platform::LogLevel::Error, "Save state file is corrupted or unsupported");
+            return false;
+        case SaveStateContainer::ReadResult::Success:
+            break;
+    }
+
+    double readTime = getCurrentMillis();
+    fileHandler->beginMemoryRead(path, saveStateData.data(), saveStateData.size());
+    bool result = MelonDSAndroid::loadState(path);
+    fileHandler->finishMemoryRead();
+
+    melonDS::Platform::Log(
+        melonDS::Platform::LogLevel::Info,
+        "Loaded %zu KB save state. Read and decompression: %.2f ms. Restore: %.2f ms",
+        saveStateData.size() / 1024,
+        readTime - startTime,
+        getCurrentMillis() - readTime
+    );
+    return result;
+}
+
+void logRewindHistoryStats()
+{
+    rewindCaptureWorker.waitUntilIdle();
+    RewindHistory::Stats stats = rewindHistory.getStats();
+    RewindCaptureWorker::Stats workerStats = rewindCaptureWorker.getStats();
+    if (stats.captureCount == 0 || stats.stateCount == 0 || rewindCaptureSpacingSeconds <= 0)
+        return;
+
+    double statesPerMinute = 60.0 / rewindCaptureSpacingSeconds;
+    melonDS::Platform::Log(
+        melonDS::Platform::LogLevel::Info,
+        "Rewind history: %u states using %llu KB instead of %llu KB (%.0f KB per minute instead of %.0f KB). Thumbnails: %ux%u, %llu KB pool. Average snapshot: %.2f ms. Average capture: %.2f ms. Dropped captures: %u. Average restore: %.2f ms",
+        stats.stateCount,
+        (unsigned long long) (stats.storedSize / 1024),
+        (unsigned long long) (stats.uncompressedSize / 1024),
+        (double) stats.storedSize / stats.stateCount * statesPerMinute / 1024,
+        (double) stats.uncompressedSize / stats.stateCount * statesPerMinute / 1024,
+        stats.thumbnailWidth,
+        stats.thumbnailHeight,
+        (unsigned long long) (stats.thumbnailPoolSize / 1024),
+        workerStats.submittedCount > 0 ? workerStats.totalSnapshotTimeNs / 1000000.0 / workerStats.submittedCount : 0.0,
+        stats.totalCaptureTimeNs / 1000000.0 / stats.captureCount,
+        workerStats.droppedCount,
+        stats.restoreCount > 0 ? stats.totalRestoreTimeNs / 1000000.0 / stats.restoreCount : 0.0
+    );
+}
+
+void startSramPersister(const char* path)
+{
+    if (path == nullptr)
+        return;
+
+    auto persister = std::make_shared<SramPersister>(fileHandler);
+    if (persister->start(path))
+        sramPersisters.push_back(std::move(persister));
+    else
+        melonDS::Platform::Log(melonDS::Platform::LogLevel::Error, "Failed to open save file for write-behind. Saves are written directly");
+}
+
+void flushSramPersisters()
+{
+    for (const auto& persister : sramPersisters)
+        persister->requestFlush();
+}
+
+void stopSramPersisters()
+{
+    for (const auto& persister : sramPersisters)
+    {
+        persister->stop();
+
+        SramPersister::Stats stats = persister->getStats();
+        melonDS::Platform::Log(
+            melonDS::Platform::LogLevel::Info,
+            "Save file write-behind: %llu KB received, %llu KB dirtied, %llu KB written in %u write-backs",
+            (unsigned long long) (stats.bytesReceived / 1024),
+            (unsigned long long) (stats.bytesDirtied / 1024),
+            (unsigned long long) (stats.bytesWritten / 1024),
+            stats.writeBackCount
+        );
+    }
+    sramPersisters.clear();
+}
+
 double getCurrentMillis() {
     timespec now;
     clock_gettime(CLOCK_MONOTONIC, &now);
@@ -624,9 +1066,15 @@ void* emulate(void*)
 
         pthread_mutex_unlock(&emuThreadMutex);
 
+        applyPendingConfiguration();
+
         auto frameStart = std::chrono::steady_clock::now();
 
         u32 nLines = MelonDSAndroid::loop();
+        if (isRewindEnabled)
+            captureRewindState();
+        if (videoFilterPipeline.isEnabled() && emulatorScreenshotBuffer != nullptr)
+            videoFilterPipeline.submitFrame(emulatorScreenshotBuffer);
 
         auto frameDuration = std::chrono::steady_clock::now() - frameStart;
         if (performanceHintSession != nullptr)
@@ -1,14 +1,18 @@
 #include <jni.h>
+#include <chrono>
+#include <cstring>
+#include <memory>
 #include <string>
-#include <locale>
-#include <codecvt>
+#include <vector>
 #include "DSi_NAND.h"
 #include "ROMManager.h"
 #include "Platform.h"
 #include "MelonDSAndroidConfiguration.h"
+#include "MelonDSAndroidInterface.h"
 #include "MelonDS.h"
-#include "RomIconBuilder.h"
 #include "UriFileHandler.h"
+#include "dsinand/DSiWareTitleCache.h"
+#include "dsinand/DSiWareTitleList.h"
 
 #define NAND_INIT_OK 0
 #define NAND_INIT_ERROR_ALREADY_OPEN 1
@@ -26,18 +30,26 @@ const u32 DSI_NAND_FILE_CATEGORY = 0x00030004;
 
 std::unique_ptr<melonDS::DSi_NAND::NANDImage> nand;
 melonDS::DSi_NAND::NANDMount* nandMount;
+DSiWareTitleCache titleCache;
+// Packed title list returned by the last listTitles() call. Cleared whenever the installed titles change
+std::vector<u8> titleListBuffer;
 
-jobject getTitleData(JNIEnv* env, u32 category, u32 titleId);
+static_assert(sizeof(NDSBanner) == DSiWareTitleCache::BANNER_SIZE, "Cached banners must hold a full DSi banner");
+
+void buildTitleList();
 
 extern "C"
 {
 JNIEXPORT jint JNICALL
-Java_me_magnum_melonds_MelonDSiNand_openNand(JNIEnv* env, jobject thiz, jobject emulatorConfiguration)
+Java_me_magnum_melonds_MelonDSiNand_openNand(JNIEnv* env, jobject thiz, jobject emulatorConfiguration, jstring titleCachePath)
 {
     if (nand)
         return NAND_INIT_ERROR_ALREADY_OPEN;
 
-    MelonDSAndroid::EmulatorConfiguration configuration = MelonDSAndroidConfiguration::buildEmulatorConfiguration(env, emulatorConfiguration);
+    MelonDSAndroid::EmulatorConfiguration configuration;
+    if (!MelonDSAndroidConfiguration::decodeEmulatorConfiguration(env, emulatorConfiguration, configuration))
+        return NAND_INIT_ERROR_NAND_FAILED;
+
     MelonDSAndroid::setConfiguration(std::move(configuration));
 
     auto bios7file = Platform::OpenFile(configuration.dsiBios7Path, melonDS::Platform::FileMode::Read);
@@ -62,90 +74,66 @@ Java_me_magnum_melonds_MelonDSiNand_openNand(JNIEnv* env, jobject thiz, jobject
 
     nandMount = new melonDS::DSi_NAND::NANDMount(*nand);
 
+    const char* cachePath = env->GetStringUTFChars(titleCachePath, nullptr);
+    titleCache.load(cachePath);
+    env->ReleaseStringUTFChars(titleCachePath, cachePath);
+
     return NAND_INIT_OK;
 }
 
-JNIEXPORT jobject JNICALL
+JNIEXPORT jbyteArray JNICALL
 Java_me_magnum_melonds_MelonDSiNand_listTitles(JNIEnv* env, jobject thiz)
 {
-    const u32 category = DSI_NAND_FILE_CATEGORY;
-    std::vector<u32> titleList;
-    nandMount->ListTitles(category, titleList);
-
-    jclass listClass = env->FindClass("java/util/ArrayList");
-    jmethodID listConstructor = env->GetMethodID(listClass, "<init>", "()V");
-    jmethodID listAddMethod = env->GetMethodID(listClass, "add", "(ILjava/lang/Object;)V");
-    jobject jniTitleList = env->NewObject(listClass, listConstructor);
+    if (titleListBuffer.empty())
+        buildTitleList();
 
-    int index = 0;
-    for (std::vector<u32>::iterator it = titleList.begin(); it != titleList.end(); it++)
-    {
-        u32 titleId = *it;
-        jobject titleData = getTitleData(env, category, titleId);
-        env->CallVoidMethod(jniTitleList, listAddMethod, index++, titleData);
-    }
-
-    return jniTitleList;
+    jbyteArray titleList = env->NewByteArray(titleListBuffer.size());
+    env->SetByteArrayRegion(titleList, 0, titleListBuffer.size(), (const jbyte*) titleListBuffer.data());
+    return titleList;
 }
 
 JNIEXPORT jint JNICALL
-Java_me_magnum_melonds_MelonDSiNand_importTitle(JNIEnv* env, jobject thiz, jstring titleUri, jbyteArray tmdMetadata)
+Java_me_magnum_melonds_MelonDSiNand_importTitle(JNIEnv* env, jobject thiz, jstring titleUri, jint titleId, jbyteArray tmdMetadata)
 {
     if (!nand)
         return TITLE_IMPORT_NAND_NOT_OPEN;
 
-    u32 titleId[2];
-
-    const char* titlePath = env->GetStringUTFChars(titleUri, NULL);
-
-    auto titleFile = Platform::OpenFile(titlePath, melonDS::Platform::FileMode::Read);
-    if (!titleFile)
-    {
-        env->ReleaseStringUTFChars(titleUri, titlePath);
-        return TITLE_IMPORT_ERROR_OPENING_FILE;
-    }
-
-    Platform::FileSeek(titleFile, 0x230, melonDS::Platform::FileSeekOrigin::Start);
-    Platform::FileRead(titleId, 8, 1, titleFile);
-    Platform::CloseFile(titleFile);
-
-    if (titleId[1] != DSI_NAND_FILE_CATEGORY)
-    {
-        // Not a DSiWare title
-        env->ReleaseStringUTFChars(titleUri, titlePath);
-        return TITLE_IMPORT_NOT_DSIWARE_TITLE;
-    }
-
-    if (nandMount->TitleExists(titleId[1], titleId[0]))
-    {
-        // Title already exists
-        env->ReleaseStringUTFChars(titleUri, titlePath);
+    if (nandMount->TitleExists(DSI_NAND_FILE_CATEGORY, (u32) titleId))
         return TITLE_IMPORT_TITLE_ALREADY_IMPORTED;
-    }
 
-    jbyte* tmdBytes = env->GetByteArrayElements(tmdMetadata, NULL);
+    const char* titlePath = env->GetStringUTFChars(titleUri, nullptr);
+    jbyte* tmdBytes = env->GetByteArrayElements(tmdMetadata, nullptr);
     auto titleMetadata = reinterpret_cast<melonDS::DSi_TMD::TitleMetadata*>(tmdBytes);
 
-    nandMount->DeleteTitle(titleId[0], titleId[1]);
+    auto startTime = std::chrono::steady_clock::now();
+    titleCache.removeEntry((u32) titleId);
+    titleListBuffer.clear();
     bool result = nandMount->ImportTitle(titlePath, *titleMetadata, false);
+    auto elapsedTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime);
 
     env->ReleaseStringUTFChars(titleUri, titlePath);
-    env->ReleaseByteArrayElements(tmdMetadata, tmdBytes, 0);
+    env->ReleaseByteArrayElements(tmdMetadata, tmdBytes, JNI_ABORT);
 
     if (!result)
     {
-        nandMount->DeleteTitle(titleId[0], titleId[1]);
+        // Remove whatever was written before the failure, so that the NAND never holds a partially imported title
+        nandMount->DeleteTitle(DSI_NAND_FILE_CATEGORY, (u32) titleId);
         return TITLE_IMPORT_INSATLL_FAILED;
     }
 
+    Platform::Log(Platform::LogLevel::Debug, "Imported DSiWare title %08X in %.1f ms", (u32) titleId, elapsedTime.count());
     return TITLE_IMPORT_OK;
 }
 
 JNIEXPORT void JNICALL
 Java_me_magnum_melonds_MelonDSiNand_deleteTitle(JNIEnv* env, jobject thiz, jint titleId)
 {
-    if (nand)
-        nandMount->DeleteTitle(DSI_NAND_FILE_CATEGORY, (u32) titleId);
+    if (!nand)
+        return;
+
+    nandMount->DeleteTitle(DSI_NAND_FILE_CATEGORY, (u32) titleId);
+    titleCache.removeEntry((u32) titleId);
+    titleListBuffer.clear();
 }
 
 JNIEXPORT jboolean JNICALL
@@ -182,46 +170,57 @@ Java_me_magnum_melonds_MelonDSiNand_closeNand(JNIEnv* env, jobject thiz)
     if (!nand)
         return;
 
+    titleCache.save();
+    titleCache.clear();
+    titleListBuffer.clear();
+    titleListBuffer.shrink_to_fit();
+
     nand = nullptr;
     delete nandMount;
+    fileHandler->clearDescriptorCache();
 }
 }
 
-jobject getTitleData(JNIEnv* env, u32 category, u32 titleId)
+void buildTitleList()
 {
-    u32 version;
-    NDSHeader header;
-    NDSBanner banner;
-
-    nandMount->GetTitleInfo(category, titleId, version, &header, &banner);
-
-    u32 iconData[32 * 32];
-    MelonDSAndroid::BuildRomIcon(banner.Icon, banner.Palette, iconData);
-    jbyteArray iconBytes = env->NewByteArray(32 * 32 * sizeof(u32));
-    jbyte* iconArrayElements = env->GetByteArrayElements(iconBytes, NULL);
-    memcpy(iconArrayElements, iconData, sizeof(iconData));
-    env->ReleaseByteArrayElements(iconBytes, iconArrayElements, 0);
-
-    jclass dsiWareTitleClass = env->FindClass("me/magnum/melonds/domain/model/DSiWareTitle");
-    jmethodID dsiWareTitleConstructor = env->GetMethodID(dsiWareTitleClass, "<init>", "(Ljava/lang/String;Ljava/lang/String;J[BJJI)V");
-
-    std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t> convert;
-    std::string englishTitle = convert.to_bytes(banner.EnglishTitle);
-
-    size_t pos = englishTitle.find("\n");
-    std::string title = englishTitle.substr(0, pos);
-    std::string producer = englishTitle.substr(pos + 1);
-
-    jobject titleObject = env->NewObject(
-        dsiWareTitleClass,
-        dsiWareTitleConstructor,
-        env->NewStringUTF(title.c_str()),
-        env->NewStringUTF(producer.c_str()),
-        (jlong) titleId,
-        iconBytes,
-        (jlong) header.DSiPublicSavSize,
-        (jlong) header.DSiPrivateSavSize,
-        header.AppFlags
-    );
-    return titleObject;
-}
\ No newline at end of file
+    auto startTime = std::chrono::steady_clock::now();
+
+    std::vector<u32> titleIds;
+    nandMount->ListTitles(DSI_NAND_FILE_CATEGORY, titleIds);
+
+    std::vector<const DSiWareTitleCache::Entry*> entries;
+    entries.reserve(titleIds.size());
+    u32 cacheMisses = 0;
+
+    for (u32 titleId : titleIds)
+    {
+        // Without a banner, only the TMD and the app header are read. The banner is what makes listing titles slow
+        u32 version = 0;
+        NDSHeader header = {};
+        nandMount->GetTitleInfo(DSI_NAND_FILE_CATEGORY, titleId, version, &header, nullptr);
+
+        const DSiWareTitleCache::Entry* entry = titleCache.getEntry(titleId, version);
+        if (entry == nullptr)
+        {
+            auto newEntry = std::make_unique<DSiWareTitleCache::Entry>();
+            nandMount->GetTitleInfo(DSI_NAND_FILE_CATEGORY, titleId, version, &header, (NDSBanner*) newEntry->banner);
+
+            newEntry->titleId = titleId;
+            newEntry->version = version;
+            newEntry->publicSavSize = header.DSiPublicSavSize;
+            newEntry->privateSavSize = header.DSiPrivateSavSize;
+            newEntry->appFlags = header.AppFlags;
+            entry = titleCache.putEntry(*newEntry);
+            cacheMisses++;
+        }
+
+        entries.push_back(entry);
+    }
+
+    titleCache.retainEntries(titleIds);
+    titleCache.save();
+    DSiWareTitleList::build(entries.data(), entries.size(), titleListBuffer);
+
+    auto elapsedTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime);
+    Platform::Log(Platform::LogLevel::Debug, "Listed %zu DSiWare titles (%u not cached) in %.1f ms", titleIds.size(), cacheMisses, elapsedTime.count());
+}
@@ -0,0 +1,34 @@
+#include <jni.h>
+#include "hashing/Crc32.h"
+#include "hashing/Md5.h"
+
+using namespace melonDS;
+
+extern "C"
+{
+JNIEXPORT jint JNICALL
+Java_me_magnum_melonds_MelonHasher_crc32(JNIEnv* env, jobject thiz, jbyteArray data, jint offset, jint length)
+{
+    auto* bytes = (u8*) env->GetPrimitiveArrayCritical(data, nullptr);
+    u32 crc = Crc32::compute(bytes + offset, length);
+    env->ReleasePrimitiveArrayCritical(data, bytes, JNI_ABORT);
+    return (jint) crc;
+}
+
+JNIEXPORT jbyteArray JNICALL
+Java_me_magnum_melonds_MelonHasher_md5(JNIEnv* env, jobject thiz, jbyteArray data)
+{
+    u8 digest[Md5::DIGEST_SIZE];
+    Md5 md5;
+
+    jsize length = env->GetArrayLength(data);
+    auto* bytes = (u8*) env->GetPrimitiveArrayCritical(data, nullptr);
+    md5.update(bytes, length);
+    env->ReleasePrimitiveArrayCritical(data, bytes, JNI_ABORT);
+    md5.finish(digest);
+
+    jbyteArray result = env->NewByteArray(Md5::DIGEST_SIZE);
+    env->SetByteArrayRegion(result, 0, Md5::DIGEST_SIZE, (const jbyte*) digest);
+    return result;
+}
+}
@@ -0,0 +1,55 @@
+#include <jni.h>
+#include <chrono>
+#include <vector>
+#include "Platform.h"
+#include "RomIconBuilder.h"
+#include "romscan/RomMetadataScanner.h"
+
+using namespace melonDS;
+
+extern "C"
+{
+JNIEXPORT jbooleanArray JNICALL
+Java_me_magnum_melonds_MelonRomIconDecoder_decodeRomIcons(JNIEnv* env, jobject thiz, jintArray fds, jobject atlasBuffer)
+{
+    jsize romCount = env->GetArrayLength(fds);
+    u32* atlas = (u32*) env->GetDirectBufferAddress(atlasBuffer);
+    jlong atlasBufferSize = env->GetDirectBufferCapacity(atlasBuffer);
+    if (atlas == nullptr || atlasBufferSize < (jlong) (romCount * MelonDSAndroid::ROM_ICON_PIXEL_COUNT * sizeof(u32)))
+        return nullptr;
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    std::vector<u8> banners(romCount * MelonDSAndroid::ROM_BANNER_STATIC_ICON_END);
+    std::vector<const u8*> bannerPointers(romCount, nullptr);
+    std::vector<jboolean> decodedIcons(romCount, JNI_FALSE);
+
+    jint* fdElements = env->GetIntArrayElements(fds, nullptr);
+    for (jsize i = 0; i < romCount; i++)
+    {
+        u8* banner = banners.data() + i * MelonDSAndroid::ROM_BANNER_STATIC_ICON_END;
+        if (RomMetadataScanner::readBanner(fdElements[i], banner, MelonDSAndroid::ROM_BANNER_STATIC_ICON_END))
+        {
+            bannerPointers[i] = banner;
+            decodedIcons[i] = JNI_TRUE;
+        }
+    }
+    env->ReleaseIntArrayElements(fds, fdElements, JNI_ABORT);
+
+    auto decodeStartTime = std::chrono::steady_clock::now();
+    MelonDSAndroid::BuildRomIcons(bannerPointers.data(), romCount, atlas);
+    auto endTime = std::chrono::steady_clock::now();
+
+    Platform::Log(
+        Platform::LogLevel::Debug,
+        "Decoded %d ROM icons in %.3f ms (%.3f ms reading banners)",
+        romCount,
+        std::chrono::duration<double, std::milli>(endTime - decodeStartTime).count(),
+        std::chrono::duration<double, std::milli>(decodeStartTime - startTime).count()
+    );
+
+    jbooleanArray result = env->NewBooleanArray(romCount);
+    env->SetBooleanArrayRegion(result, 0, romCount, decodedIcons.data());
+    return result;
+}
+}
@@ -0,0 +1,31 @@
+#include <jni.h>
+#include <chrono>
+#include "Platform.h"
+#include "romscan/RomMetadataScanner.h"
+
+// Scanning is mostly I/O bound on storage that handles parallel reads well, so a few more threads than cores is not useful
+constexpr unsigned int MAX_SCANNER_THREADS = 4;
+
+extern "C"
+{
+JNIEXPORT jboolean JNICALL
+Java_me_magnum_melonds_MelonRomScanner_scanRoms(JNIEnv* env, jobject thiz, jintArray fds, jobject resultBuffer)
+{
+    jsize romCount = env->GetArrayLength(fds);
+    auto* results = (RomMetadataScanner::ScanResult*) env->GetDirectBufferAddress(resultBuffer);
+    jlong resultBufferSize = env->GetDirectBufferCapacity(resultBuffer);
+    if (results == nullptr || resultBufferSize < (jlong) (romCount * sizeof(RomMetadataScanner::ScanResult)))
+        return JNI_FALSE;
+
+    jint* fdElements = env->GetIntArrayElements(fds, nullptr);
+
+    auto startTime = std::chrono::steady_clock::now();
+    RomMetadataScanner::scan(fdElements, romCount, results, MAX_SCANNER_THREADS);
+    auto elapsedTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime);
+
+    env->ReleaseIntArrayElements(fds, fdElements, JNI_ABORT);
+
+    melonDS::Platform::Log(melonDS::Platform::LogLevel::Debug, "Scanned %d ROMs in %.1f ms", romCount, elapsedTime.count());
+    return JNI_TRUE;
+}
+}
@@ -1,31 +1,198 @@
 #include "RomIconBuilder.h"
+#include <cstring>
+#include <utility>
 
-void MelonDSAndroid::BuildRomIcon(const melonDS::u8 (&data)[512], const melonDS::u16 (&palette)[16], melonDS::u32 (&iconRef)[32*32])
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+using namespace melonDS;
+
+namespace
 {
-    melonDS::u32 paletteRGBA[16];
-    for (int i = 0; i < 16; i++)
+    constexpr size_t BANNER_VERSION_OFFSET = 0x0;
+    constexpr size_t BANNER_ICON_OFFSET = 0x20;
+    constexpr size_t BANNER_PALETTE_OFFSET = 0x220;
+    constexpr size_t BANNER_DSI_ICONS_OFFSET = 0x1240;
+    constexpr size_t BANNER_DSI_PALETTES_OFFSET = 0x2240;
+    constexpr size_t BANNER_DSI_SEQUENCE_OFFSET = 0x2340;
+    constexpr u16 BANNER_VERSION_DSI = 0x0103;
+    constexpr size_t ICON_DATA_SIZE = 512;
+
+    struct ColorExpansionTable
+    {
+        u8 values[32];
+
+        constexpr ColorExpansionTable() : values()
+        {
+            // Replicates the top bits into the bottom ones, so that 0 maps to 0 and 31 maps to 255
+            for (int i = 0; i < 32; i++)
+                values[i] = (u8) ((i << 3) | (i >> 2));
+        }
+    };
+
+    constexpr ColorExpansionTable COLOR_EXPANSION;
+
+    /**
+     * Converts a BGR555 palette into RGBA, with each component in a separate plane. Planes are what the NEON table lookups need, and the scalar
+     * path builds the packed colors from them.
+     */
+    void convertPalette(const u8* paletteData, u8 (&planes)[4][16])
     {
-        melonDS::u8 r = ((palette[i] >> 0)  & 0x1F) * 255 / 31;
-        melonDS::u8 g = ((palette[i] >> 5)  & 0x1F) * 255 / 31;
-        melonDS::u8 b = ((palette[i] >> 10) & 0x1F) * 255 / 31;
-        melonDS::u8 a = i ? 255 : 0;
-        paletteRGBA[i] = r | (g << 8) | (b << 16) | (a << 24);
+        // Index 0 is transparent. Icons end up in premultiplied bitmaps, so its color must be cleared along with its alpha
+        for (int plane = 0; plane < 4; plane++)
+            planes[plane][0] = 0;
+
+        for (int i = 1; i < 16; i++)
+        {
+            u16 color = paletteData[i * 2] | (paletteData[i * 2 + 1] << 8);
+            planes[0][i] = COLOR_EXPANSION.values[color & 0x1F];
+            planes[1][i] = COLOR_EXPANSION.values[(color >> 5) & 0x1F];
+            planes[2][i] = COLOR_EXPANSION.values[(color >> 10) & 0x1F];
+            planes[3][i] = 255;
+        }
     }
 
-    int count = 0;
-    for (int ytile = 0; ytile < 4; ytile++)
+    void decodeTiles(const u8* data, const u8 (&planes)[4][16], u32* icon)
     {
-        for (int xtile = 0; xtile < 4; xtile++)
+#if defined(__ARM_NEON)
+        uint8x8x2_t redTable = { vld1_u8(planes[0]), vld1_u8(planes[0] + 8) };
+        uint8x8x2_t greenTable = { vld1_u8(planes[1]), vld1_u8(planes[1] + 8) };
+        uint8x8x2_t blueTable = { vld1_u8(planes[2]), vld1_u8(planes[2] + 8) };
+        uint8x8x2_t alphaTable = { vld1_u8(planes[3]), vld1_u8(planes[3] + 8) };
+        uint8x8_t lowNibbleMask = vdup_n_u8(0x0F);
+
+        for (int tile = 0; tile < 16; tile++)
+        {
+            const u8* tileData = data + tile * 32;
+            u32* tileOutput = icon + (tile / 4) * 8 * 32 + (tile % 4) * 8;
+
+            // Each iteration handles two rows of the tile (8 bytes, 16 pixels). The low nibble is the left pixel of each pair
+            for (int row = 0; row < 8; row += 2)
+            {
+                uint8x8_t packed = vld1_u8(tileData + row * 4);
+                uint8x8x2_t indices = vzip_u8(vand_u8(packed, lowNibbleMask), vshr_n_u8(packed, 4));
+
+                for (int i = 0; i < 2; i++)
+                {
+                    uint8x8x4_t pixels;
+                    pixels.val[0] = vtbl2_u8(redTable, indices.val[i]);
+                    pixels.val[1] = vtbl2_u8(greenTable, indices.val[i]);
+                    pixels.val[2] = vtbl2_u8(blueTable, indices.val[i]);
+                    pixels.val[3] = vtbl2_u8(alphaTable, indices.val[i]);
+                    vst4_u8((u8*) (tileOutput + (row + i) * 32), pixels);
+                }
+            }
+        }
+#else
+        u32 palette[16];
+        for (int i = 0; i < 16; i++)
+            palette[i] = planes[0][i] | (planes[1][i] << 8) | (planes[2][i] << 16) | ((u32) planes[3][i] << 24);
+
+        for (int tile = 0; tile < 16; tile++)
         {
-            for (int ypixel = 0; ypixel < 8; ypixel++)
+            const u8* tileData = data + tile * 32;
+            u32* tileOutput = icon + (tile / 4) * 8 * 32 + (tile % 4) * 8;
+
+            for (int row = 0; row < 8; row++)
             {
-                for (int xpixel = 0; xpixel < 8; xpixel++)
+                u32* rowOutput = tileOutput + row * 32;
+                for (int i = 0; i < 4; i++)
                 {
-                    melonDS::u8 pal_index = count % 2 ? data[count/2] >> 4 : data[count/2] & 0x0F;
-                    iconRef[ytile*256 + ypixel*32 + xtile*8 + xpixel] = paletteRGBA[pal_index];
-                    count++;
+                    u8 pixelPair = tileData[row * 4 + i];
+                    rowOutput[i * 2] = palette[pixelPair & 0x0F];
+                    rowOutput[i * 2 + 1] = palette[pixelPair >> 4];
                 }
             }
         }
+#endif
+    }
+
+    void decodeIcon(const u8* data, const u8* paletteData, u32* icon)
+    {
+        u8 planes[4][16];
+        convertPalette(paletteData, planes);
+        decodeTiles(data, planes, icon);
+    }
+
+    void flipIcon(u32* icon, bool horizontal, bool vertical)
+    {
+        if (horizontal)
+        {
+            for (int y = 0; y < MelonDSAndroid::ROM_ICON_SIZE; y++)
+            {
+                u32* row = icon + y * MelonDSAndroid::ROM_ICON_SIZE;
+                for (int x = 0; x < MelonDSAndroid::ROM_ICON_SIZE / 2; x++)
+                    std::swap(row[x], row[MelonDSAndroid::ROM_ICON_SIZE - 1 - x]);
+            }
+        }
+
+        if (vertical)
+        {
+            u32 rowBuffer[MelonDSAndroid::ROM_ICON_SIZE];
+            for (int y = 0; y < MelonDSAndroid::ROM_ICON_SIZE / 2; y++)
+            {
+                u32* top = icon + y * MelonDSAndroid::ROM_ICON_SIZE;
+                u32* bottom = icon + (MelonDSAndroid::ROM_ICON_SIZE - 1 - y) * MelonDSAndroid::ROM_ICON_SIZE;
+                memcpy(rowBuffer, top, sizeof(rowBuffer));
+                memcpy(top, bottom, sizeof(rowBuffer));
+                memcpy(bottom, rowBuffer, sizeof(rowBuffer));
+            }
+        }
+    }
+}
+
+void MelonDSAndroid::BuildRomIcon(const u8 (&data)[512], const u16 (&palette)[16], u32 (&iconRef)[32*32])
+{
+    decodeIcon(data, (const u8*) palette, iconRef);
+}
+
+void MelonDSAndroid::BuildRomIcons(const u8* const* banners, size_t count, u32* atlas)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        u32* icon = atlas + i * ROM_ICON_PIXEL_COUNT;
+        if (banners[i] == nullptr)
+        {
+            memset(icon, 0, ROM_ICON_PIXEL_COUNT * sizeof(u32));
+            continue;
+        }
+
+        decodeIcon(banners[i] + BANNER_ICON_OFFSET, banners[i] + BANNER_PALETTE_OFFSET, icon);
+    }
+}
+
+int MelonDSAndroid::BuildAnimatedRomIcon(const u8* banner, size_t bannerSize, u32* atlas, u16* frameDurations)
+{
+    if (bannerSize < ROM_BANNER_DSI_SIZE)
+        return 0;
+
+    u16 version = banner[BANNER_VERSION_OFFSET] | (banner[BANNER_VERSION_OFFSET + 1] << 8);
+    if (version < BANNER_VERSION_DSI)
+        return 0;
+
+    int frameCount = 0;
+    for (int i = 0; i < MAX_ANIMATED_ICON_FRAMES; i++)
+    {
+        const u8* entryData = banner + BANNER_DSI_SEQUENCE_OFFSET + i * 2;
+        u16 entry = entryData[0] | (entryData[1] << 8);
+        u16 duration = entry & 0xFF;
+        // A step without duration marks the end of the sequence
+        if (duration == 0)
+            break;
+
+        int bitmapIndex = (entry >> 8) & 0x7;
+        int paletteIndex = (entry >> 11) & 0x7;
+        bool flipHorizontal = (entry & (1 << 14)) != 0;
+        bool flipVertical = (entry & (1 << 15)) != 0;
+
+        u32* frame = atlas + frameCount * ROM_ICON_PIXEL_COUNT;
+        decodeIcon(banner + BANNER_DSI_ICONS_OFFSET + bitmapIndex * ICON_DATA_SIZE, banner + BANNER_DSI_PALETTES_OFFSET + paletteIndex * 32, frame);
+        flipIcon(frame, flipHorizontal, flipVertical);
+        frameDurations[frameCount] = duration;
+        frameCount++;
     }
-}
\ No newline at end of file
+
+    // A single frame is not an animation. The static icon is used instead
+    return frameCount > 1 ? frameCount : 0;
+}
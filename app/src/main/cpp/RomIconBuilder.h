@@ -1,13 +1,42 @@
 #ifndef ROMICONBUILDER_H
 #define ROMICONBUILDER_H
 
+#include <cstddef>
 #include "types.h"
 
 namespace MelonDSAndroid
 {
 
+constexpr int ROM_ICON_SIZE = 32;
+constexpr int ROM_ICON_PIXEL_COUNT = ROM_ICON_SIZE * ROM_ICON_SIZE;
+// Size of the part of a banner that holds the static icon
+constexpr size_t ROM_BANNER_STATIC_ICON_END = 0x240;
+// Size of DSi banners (version 0x0103), which include the animated icon
+constexpr size_t ROM_BANNER_DSI_SIZE = 0x23C0;
+constexpr int MAX_ANIMATED_ICON_FRAMES = 64;
+
+/**
+ * Decodes a 4bpp tiled icon into RGBA pixels. Palette index 0 is transparent.
+ */
 void BuildRomIcon(const melonDS::u8 (&data)[512], const melonDS::u16 (&palette)[16], melonDS::u32 (&iconRef)[32*32]);
 
+/**
+ * Decodes the static icons of several banners at once into an atlas. Icons are stacked vertically, so the atlas is a 32 x (32 * count) RGBA image
+ * in which the icon of banner i is the contiguous slice that starts at pixel i * ROM_ICON_PIXEL_COUNT. Null banners produce transparent icons.
+ *
+ * @param banners Pointers to banners of at least ROM_BANNER_STATIC_ICON_END bytes
+ */
+void BuildRomIcons(const melonDS::u8* const* banners, size_t count, melonDS::u32* atlas);
+
+/**
+ * Decodes the animated icon of a DSi banner. Every step of the animation sequence is written as a frame into the atlas, which has the same
+ * layout as the one filled by BuildRomIcons() and must have room for MAX_ANIMATED_ICON_FRAMES icons.
+ *
+ * @param frameDurations Receives the duration of each frame, in 60 Hz frames
+ * @return The number of frames, or 0 if the banner has no animated icon
+ */
+int BuildAnimatedRomIcon(const melonDS::u8* banner, size_t bannerSize, melonDS::u32* atlas, melonDS::u16* frameDurations);
+
 }
 
-#endif
\ No newline at end of file
+#endif
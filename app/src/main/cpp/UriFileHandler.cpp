@@ -1,8 +1,166 @@
 #include "UriFileHandler.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "Platform.h"
 
+using namespace melonDS;
 using namespace melonDS::Platform;
 
+namespace
+{
+    struct RedirectedFile
+    {
+        std::shared_ptr<UriFileHandler::FileRedirect> redirect;
+        std::vector<u8> contents;
+        size_t position;
+        bool append;
+        bool modified;
+    };
+
+    int readRedirectedFile(void* cookie, char* buffer, int size)
+    {
+        RedirectedFile* file = (RedirectedFile*) cookie;
+        size_t available = file->position < file->contents.size() ? file->contents.size() - file->position : 0;
+        size_t readSize = std::min(available, (size_t) size);
+        memcpy(buffer, file->contents.data() + file->position, readSize);
+        file->position += readSize;
+        return (int) readSize;
+    }
+
+    int writeRedirectedFile(void* cookie, const char* buffer, int size)
+    {
+        RedirectedFile* file = (RedirectedFile*) cookie;
+        if (file->append)
+            file->position = file->contents.size();
+
+        if (file->position + size > file->contents.size())
+            file->contents.resize(file->position + size);
+
+        memcpy(file->contents.data() + file->position, buffer, size);
+        file->position += size;
+        file->modified = true;
+        return size;
+    }
+
+    fpos_t seekRedirectedFile(void* cookie, fpos_t offset, int whence)
+    {
+        RedirectedFile* file = (RedirectedFile*) cookie;
+        fpos_t base = whence == SEEK_SET ? 0 : (whence == SEEK_CUR ? (fpos_t) file->position : (fpos_t) file->contents.size());
+        if (base + offset < 0)
+        {
+            errno = EINVAL;
+            return -1;
+        }
+
+        file->position = (size_t) (base + offset);
+        return (fpos_t) file->position;
+    }
+
+    int closeRedirectedFile(void* cookie)
+    {
+        RedirectedFile* file = (RedirectedFile*) cookie;
+        if (file->modified)
+            file->redirect->writeContents(std::move(file->contents));
+
+        delete file;
+        return 0;
+    }
+
+    /**
+     * Read-only file that reads with pread() from its own position, so that several files can share an open file description without sharing
+     * the file offset.
+     */
+    struct PositionalFile
+    {
+        int fd;
+        off_t position;
+    };
+
+    int readPositionalFile(void* cookie, char* buffer, int size)
+    {
+        PositionalFile* file = (PositionalFile*) cookie;
+        ssize_t result;
+        do
+        {
+            result = pread(file->fd, buffer, size, file->position);
+        }
+        while (result == -1 && errno == EINTR);
+
+        if (result > 0)
+            file->position += result;
+
+        return (int) result;
+    }
+
+    fpos_t seekPositionalFile(void* cookie, fpos_t offset, int whence)
+    {
+        PositionalFile* file = (PositionalFile*) cookie;
+        fpos_t base;
+        if (whence == SEEK_SET)
+        {
+            base = 0;
+        }
+        else if (whence == SEEK_CUR)
+        {
+            base = (fpos_t) file->position;
+        }
+        else
+        {
+            struct stat fileStat;
+            if (fstat(file->fd, &fileStat) == -1)
+                return -1;
+
+            base = (fpos_t) fileStat.st_size;
+        }
+
+        if (base + offset < 0)
+        {
+            errno = EINVAL;
+            return -1;
+        }
+
+        file->position = (off_t) (base + offset);
+        return (fpos_t) file->position;
+    }
+
+    int closePositionalFile(void* cookie)
+    {
+        PositionalFile* file = (PositionalFile*) cookie;
+        int result = close(file->fd);
+        delete file;
+        return result;
+    }
+
+    FILE* openPositionalStream(int fd)
+    {
+        PositionalFile* file = new PositionalFile {
+            .fd = fd,
+            .position = 0,
+        };
+
+        FILE* stream = funopen(file, readPositionalFile, nullptr, seekPositionalFile, closePositionalFile);
+        if (stream == nullptr)
+        {
+            close(fd);
+            delete file;
+        }
+
+        return stream;
+    }
+
+    FILE* openStream(int fd, const std::string& nativeMode)
+    {
+        FILE* file = fdopen(fd, nativeMode.c_str());
+        if (file == nullptr)
+            close(fd);
+
+        return file;
+    }
+}
+
 UriFileHandler::UriFileHandler(JniEnvHandler* jniEnvHandler, jobject uriFileHandler)
 {
     this->jniEnvHandler = jniEnvHandler;
@@ -10,21 +168,261 @@ UriFileHandler::UriFileHandler(JniEnvHandler* jniEnvHandler, jobject uriFileHand
 }
 
 FILE* UriFileHandler::open(const char* path, FileMode mode)
+{
+    if (std::shared_ptr<FileRedirect> redirect = findFileRedirect(path))
+    {
+        RedirectedFile* file = new RedirectedFile {
+            .redirect = redirect,
+            .position = 0,
+            .append = (mode & FileMode::Append) != 0,
+            .modified = false,
+        };
+
+        // Opening for writing without preserving the existing contents truncates the file
+        bool truncate = (mode & FileMode::Write) && !(mode & (FileMode::Preserve | FileMode::NoCreate | FileMode::Append));
+        if (truncate)
+            file->modified = true;
+        else
+            file->contents = redirect->readContents();
+
+        return funopen(file, readRedirectedFile, writeRedirectedFile, seekRedirectedFile, closeRedirectedFile);
+    }
+
+    return openWithoutRedirect(path, mode);
+}
+
+FILE* UriFileHandler::openWithoutRedirect(const char* path, FileMode mode)
+{
+    if (mode & FileMode::Write)
+    {
+        std::lock_guard<std::mutex> lock(memoryCaptureMutex);
+        if (!memoryCapturePath.empty() && memoryCapturePath == path)
+        {
+            memoryCapturePath.clear();
+            return open_memstream(&memoryCaptureBuffer, &memoryCaptureSize);
+        }
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(memoryCaptureMutex);
+        if (!memoryReadPath.empty() && memoryReadPath == path)
+            return fmemopen(const_cast<void*>(memoryReadData), memoryReadSize, "rb");
+    }
+
+    std::string accessMode = getAccessMode(mode, false);
+    std::string nativeMode = getNativeAccessMode(mode, false);
+    bool isReadOnly = !(mode & (FileMode::Write | FileMode::Append));
+
+    if (isReadOnly)
+    {
+        int cachedDescriptor = openCachedDescriptor(path, accessMode);
+        if (cachedDescriptor != -1)
+            return openPositionalStream(cachedDescriptor);
+    }
+    else
+    {
+        // The file is about to change, so cached descriptors could point to stale data
+        invalidateCachedDescriptors(path);
+    }
+
+    int fileDescriptor = openDescriptor(path, accessMode);
+    if (fileDescriptor == -1)
+        return nullptr;
+
+    if (isReadOnly)
+        fileDescriptor = cacheDescriptor(path, accessMode, fileDescriptor);
+
+    return openStream(fileDescriptor, nativeMode);
+}
+
+int UriFileHandler::openDescriptor(const char* path, const std::string& accessMode)
 {
     JNIEnv* env = this->jniEnvHandler->getCurrentThreadEnv();
 
     jstring pathString = env->NewStringUTF(path);
-    jstring modeString = env->NewStringUTF(getAccessMode(mode, false).c_str());
+    jstring modeString = env->NewStringUTF(accessMode.c_str());
     jclass handlerClass = env->GetObjectClass(this->uriFileHandler);
     jmethodID openMethod = env->GetMethodID(handlerClass, "open", "(Ljava/lang/String;Ljava/lang/String;)I");
     jint fileDescriptor = env->CallIntMethod(this->uriFileHandler, openMethod, pathString, modeString);
 
-    if (fileDescriptor == -1) {
-        return nullptr;
-    } else {
-        std::string nativeMode = getNativeAccessMode(mode, false);
-        return fdopen(fileDescriptor, nativeMode.c_str());
+    env->DeleteLocalRef(handlerClass);
+    env->DeleteLocalRef(modeString);
+    env->DeleteLocalRef(pathString);
+    return fileDescriptor;
+}
+
+int UriFileHandler::openCachedDescriptor(const char* path, const std::string& accessMode)
+{
+    std::lock_guard<std::mutex> lock(descriptorCacheMutex);
+    for (const CachedDescriptor& entry : descriptorCache)
+    {
+        if (entry.path != path || entry.accessMode != accessMode)
+            continue;
+
+        // The duplicate shares its file offset with the cached descriptor, so it is only read through a positional stream
+        int fd = dup(entry.fd);
+        if (fd == -1)
+            break;
+
+        descriptorCacheStats.hits++;
+        return fd;
     }
+
+    descriptorCacheStats.misses++;
+    return -1;
+}
+
+int UriFileHandler::cacheDescriptor(const char* path, const std::string& accessMode, int fd)
+{
+    // Only seekable descriptors can be reused. Some document providers hand out pipes
+    if (lseek(fd, 0, SEEK_CUR) == -1)
+        return fd;
+
+    int duplicateFd = dup(fd);
+    if (duplicateFd == -1)
+        return fd;
+
+    std::lock_guard<std::mutex> lock(descriptorCacheMutex);
+    for (auto it = descriptorCache.begin(); it != descriptorCache.end(); ++it)
+    {
+        if (it->path == path && it->accessMode == accessMode)
+        {
+            close(it->fd);
+            descriptorCache.erase(it);
+            break;
+        }
+    }
+
+    if (descriptorCache.size() >= MAX_CACHED_DESCRIPTORS)
+    {
+        close(descriptorCache.front().fd);
+        descriptorCache.erase(descriptorCache.begin());
+    }
+
+    descriptorCache.push_back(CachedDescriptor {
+        .path = path,
+        .accessMode = accessMode,
+        .fd = fd,
+    });
+    return duplicateFd;
+}
+
+void UriFileHandler::invalidateCachedDescriptors(const char* path)
+{
+    std::lock_guard<std::mutex> lock(descriptorCacheMutex);
+    for (auto it = descriptorCache.begin(); it != descriptorCache.end();)
+    {
+        if (it->path == path)
+        {
+            close(it->fd);
+            it = descriptorCache.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void UriFileHandler::clearDescriptorCache()
+{
+    std::lock_guard<std::mutex> lock(descriptorCacheMutex);
+    for (const CachedDescriptor& entry : descriptorCache)
+        close(entry.fd);
+
+    descriptorCache.clear();
+    descriptorCacheStats = {};
+}
+
+UriFileHandler::DescriptorCacheStats UriFileHandler::getDescriptorCacheStats()
+{
+    std::lock_guard<std::mutex> lock(descriptorCacheMutex);
+    return descriptorCacheStats;
+}
+
+void UriFileHandler::beginMemoryCapture(const char* path)
+{
+    std::lock_guard<std::mutex> lock(memoryCaptureMutex);
+    memoryCapturePath = path;
+    memoryCaptureBuffer = nullptr;
+    memoryCaptureSize = 0;
+}
+
+char* UriFileHandler::finishMemoryCapture(size_t& size)
+{
+    std::lock_guard<std::mutex> lock(memoryCaptureMutex);
+    memoryCapturePath.clear();
+
+    char* buffer = memoryCaptureBuffer;
+    size = memoryCaptureSize;
+    memoryCaptureBuffer = nullptr;
+    memoryCaptureSize = 0;
+    return buffer;
+}
+
+void UriFileHandler::beginMemoryRead(const char* path, const void* data, size_t size)
+{
+    std::lock_guard<std::mutex> lock(memoryCaptureMutex);
+    memoryReadPath = path;
+    memoryReadData = data;
+    memoryReadSize = size;
+}
+
+void UriFileHandler::finishMemoryRead()
+{
+    std::lock_guard<std::mutex> lock(memoryCaptureMutex);
+    memoryReadPath.clear();
+    memoryReadData = nullptr;
+    memoryReadSize = 0;
+}
+
+void UriFileHandler::setFileRedirect(const char* path, std::shared_ptr<FileRedirect> redirect)
+{
+    std::lock_guard<std::mutex> lock(memoryCaptureMutex);
+    fileRedirects.emplace_back(path, std::move(redirect));
+}
+
+void UriFileHandler::removeFileRedirect(const char* path)
+{
+    std::lock_guard<std::mutex> lock(memoryCaptureMutex);
+    for (auto it = fileRedirects.begin(); it != fileRedirects.end(); ++it)
+    {
+        if (it->first == path)
+        {
+            fileRedirects.erase(it);
+            break;
+        }
+    }
+}
+
+std::shared_ptr<UriFileHandler::FileRedirect> UriFileHandler::findFileRedirect(const char* path)
+{
+    std::lock_guard<std::mutex> lock(memoryCaptureMutex);
+    for (const auto& [redirectPath, redirect] : fileRedirects)
+    {
+        if (redirectPath == path)
+            return redirect;
+    }
+    return nullptr;
+}
+
+bool UriFileHandler::replace(const char* sourcePath, const char* targetPath)
+{
+    invalidateCachedDescriptors(sourcePath);
+    invalidateCachedDescriptors(targetPath);
+
+    JNIEnv* env = this->jniEnvHandler->getCurrentThreadEnv();
+
+    jstring sourceString = env->NewStringUTF(sourcePath);
+    jstring targetString = env->NewStringUTF(targetPath);
+    jclass handlerClass = env->GetObjectClass(this->uriFileHandler);
+    jmethodID replaceMethod = env->GetMethodID(handlerClass, "replace", "(Ljava/lang/String;Ljava/lang/String;)Z");
+    jboolean result = env->CallBooleanMethod(this->uriFileHandler, replaceMethod, sourceString, targetString);
+
+    env->DeleteLocalRef(handlerClass);
+    env->DeleteLocalRef(targetString);
+    env->DeleteLocalRef(sourceString);
+    return result;
 }
 
 std::string UriFileHandler::getNativeAccessMode(FileMode mode, bool fileExists)
@@ -78,4 +476,5 @@ std::string UriFileHandler::getAccessMode(FileMode mode, bool fileExists)
 
 UriFileHandler::~UriFileHandler()
 {
+    clearDescriptorCache();
 }
\ No newline at end of file
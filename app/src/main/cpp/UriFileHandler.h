@@ -3,20 +3,115 @@
 
 #include <jni.h>
 #include <stdio.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 #include <AndroidFileHandler.h>
 #include "JniEnvHandler.h"
+#include "types.h"
 
 class UriFileHandler : public MelonDSAndroid::AndroidFileHandler {
+public:
+    struct DescriptorCacheStats
+    {
+        unsigned int hits;
+        unsigned int misses;
+    };
+
+    /**
+     * Backing store for a file whose accesses are redirected away from storage. Files opened through the handler work on a copy of the contents,
+     * which is handed back when a modified file is closed.
+     */
+    class FileRedirect
+    {
+    public:
+        virtual ~FileRedirect() = default;
+        virtual std::vector<melonDS::u8> readContents() = 0;
+        virtual void writeContents(std::vector<melonDS::u8> contents) = 0;
+    };
+
 private:
+    struct CachedDescriptor
+    {
+        std::string path;
+        std::string accessMode;
+        int fd;
+    };
+
+    static constexpr size_t MAX_CACHED_DESCRIPTORS = 16;
+
     JniEnvHandler* jniEnvHandler;
     jobject uriFileHandler;
+    std::mutex memoryCaptureMutex;
+    std::string memoryCapturePath;
+    char* memoryCaptureBuffer = nullptr;
+    size_t memoryCaptureSize = 0;
+    std::string memoryReadPath;
+    const void* memoryReadData = nullptr;
+    size_t memoryReadSize = 0;
+    std::vector<std::pair<std::string, std::shared_ptr<FileRedirect>>> fileRedirects;
+    // Files opened read-only keep their descriptor open so that reopening them does not go through the content resolver again. Each open
+    // returns a dup() of the cached descriptor, read with pread() so that it keeps its own position
+    std::mutex descriptorCacheMutex;
+    // Oldest entries first
+    std::vector<CachedDescriptor> descriptorCache;
+    DescriptorCacheStats descriptorCacheStats = {};
 
 public:
     UriFileHandler(JniEnvHandler* jniEnvHandler, jobject uriFileHandler);
     FILE* open(const char* path, melonDS::Platform::FileMode mode);
+    /**
+     * Opens the file at the given path, ignoring any redirect set for it.
+     */
+    FILE* openWithoutRedirect(const char* path, melonDS::Platform::FileMode mode);
+
+    /**
+     * Redirects the next file opened for writing at the given path to a memory buffer instead. The buffer can be retrieved with
+     * finishMemoryCapture() once the file has been closed.
+     */
+    void beginMemoryCapture(const char* path);
+
+    /**
+     * Stops redirecting writes to memory and returns the captured data. The returned buffer must be released with free().
+     *
+     * @return The captured data, or nullptr if no file was written
+     */
+    char* finishMemoryCapture(size_t& size);
+
+    /**
+     * Serves files opened for reading at the given path from the given memory buffer instead, until finishMemoryRead() is called. The buffer must
+     * remain valid until then.
+     */
+    void beginMemoryRead(const char* path, const void* data, size_t size);
+    void finishMemoryRead();
+
+    /**
+     * Redirects every open of the file at the given path to the given redirect, until removeFileRedirect() is called. Files opened through the
+     * redirect keep it alive until they are closed.
+     */
+    void setFileRedirect(const char* path, std::shared_ptr<FileRedirect> redirect);
+    void removeFileRedirect(const char* path);
+
+    /**
+     * Replaces the file at targetPath with the file at sourcePath.
+     */
+    bool replace(const char* sourcePath, const char* targetPath);
+
+    /**
+     * Closes all cached descriptors. Should be called when the emulation session ends, so that files replaced outside of the emulator are picked
+     * up by the next session.
+     */
+    void clearDescriptorCache();
+    DescriptorCacheStats getDescriptorCacheStats();
     virtual ~UriFileHandler();
 
 private:
+    std::shared_ptr<FileRedirect> findFileRedirect(const char* path);
+    int openDescriptor(const char* path, const std::string& accessMode);
+    int openCachedDescriptor(const char* path, const std::string& accessMode);
+    int cacheDescriptor(const char* path, const std::string& accessMode, int fd);
+    void invalidateCachedDescriptors(const char* path);
     std::string getNativeAccessMode(melonDS::Platform::FileMode mode, bool fileExists);
     std::string getAccessMode(melonDS::Platform::FileMode mode, bool fileExists);
 };
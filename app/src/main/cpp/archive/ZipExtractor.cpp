@@ -0,0 +1,495 @@
+#include "ZipExtractor.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+#include "../hashing/Crc32.h"
+
+using namespace melonDS;
+
+namespace
+{
+    constexpr u32 LOCAL_HEADER_SIGNATURE = 0x04034B50;
+    constexpr u32 CENTRAL_HEADER_SIGNATURE = 0x02014B50;
+    constexpr u32 END_OF_CENTRAL_DIRECTORY_SIGNATURE = 0x06054B50;
+    constexpr u32 ZIP64_END_OF_CENTRAL_DIRECTORY_SIGNATURE = 0x06064B50;
+    constexpr u32 ZIP64_END_OF_CENTRAL_DIRECTORY_LOCATOR_SIGNATURE = 0x07064B50;
+    constexpr u16 ZIP64_EXTRA_FIELD_ID = 0x0001;
+
+    constexpr size_t LOCAL_HEADER_SIZE = 30;
+    constexpr size_t CENTRAL_HEADER_SIZE = 46;
+    constexpr size_t END_OF_CENTRAL_DIRECTORY_SIZE = 22;
+    constexpr size_t ZIP64_END_OF_CENTRAL_DIRECTORY_SIZE = 56;
+    constexpr size_t ZIP64_END_OF_CENTRAL_DIRECTORY_LOCATOR_SIZE = 20;
+    constexpr size_t MAX_COMMENT_SIZE = 0xFFFF;
+
+    constexpr u16 METHOD_STORED = 0;
+    constexpr u16 METHOD_DEFLATED = 8;
+    constexpr u16 FLAG_ENCRYPTED = 1 << 0;
+    constexpr size_t BUFFER_ALIGNMENT = 4096;
+
+    inline u16 read16(const u8* data)
+    {
+        return (u16) (data[0] | (data[1] << 8));
+    }
+
+    inline u32 read32(const u8* data)
+    {
+        return (u32) read16(data) | ((u32) read16(data + 2) << 16);
+    }
+
+    inline u64 read64(const u8* data)
+    {
+        return (u64) read32(data) | ((u64) read32(data + 4) << 32);
+    }
+
+    /**
+     * The central directory location comes straight from the archive, so it has to be checked before a buffer is allocated for it. Written so
+     * that offset + size cannot overflow.
+     */
+    inline bool isCentralDirectoryInArchive(u64 offset, u64 size, u64 archiveSize)
+    {
+        return offset <= archiveSize && size <= archiveSize - offset;
+    }
+
+    bool writeFully(int fd, const u8* data, size_t size)
+    {
+        while (size > 0)
+        {
+            ssize_t written = write(fd, data, size);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                return false;
+            }
+
+            data += written;
+            size -= written;
+        }
+
+        return true;
+    }
+
+    struct ReadBuffer
+    {
+        u8* data;
+        size_t size;
+    };
+
+    /**
+     * Hands buffers between the reader thread, which fills free buffers in archive order, and the consumer, which processes filled buffers in the
+     * same order and then returns them.
+     */
+    class ReadPipeline
+    {
+    public:
+        bool waitForFreeBuffer(ReadBuffer*& buffer)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this] { return cancelled || !freeBuffers.empty(); });
+            if (cancelled)
+                return false;
+
+            buffer = freeBuffers.front();
+            freeBuffers.pop_front();
+            return true;
+        }
+
+        /**
+         * Waits for the next filled buffer. Returns null once the reader has finished, or if reading failed.
+         */
+        ReadBuffer* waitForFilledBuffer(double& waitTimeMs)
+        {
+            auto waitStart = std::chrono::steady_clock::now();
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this] { return readerFinished || !filledBuffers.empty(); });
+            waitTimeMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - waitStart).count();
+
+            if (filledBuffers.empty())
+                return nullptr;
+
+            ReadBuffer* buffer = filledBuffers.front();
+            filledBuffers.pop_front();
+            return buffer;
+        }
+
+        void pushFreeBuffer(ReadBuffer* buffer)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                freeBuffers.push_back(buffer);
+            }
+            condition.notify_all();
+        }
+
+        void pushFilledBuffer(ReadBuffer* buffer)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                filledBuffers.push_back(buffer);
+            }
+            condition.notify_all();
+        }
+
+        void finishReading(bool success)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                readerFinished = true;
+                readFailed = !success;
+            }
+            condition.notify_all();
+        }
+
+        void cancel()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                cancelled = true;
+            }
+            condition.notify_all();
+        }
+
+        bool hasReadFailed()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return readFailed;
+        }
+
+    private:
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::deque<ReadBuffer*> freeBuffers;
+        std::deque<ReadBuffer*> filledBuffers;
+        bool readerFinished = false;
+        bool readFailed = false;
+        bool cancelled = false;
+    };
+
+    struct AlignedBufferDeleter
+    {
+        void operator()(u8* buffer) const
+        {
+            free(buffer);
+        }
+    };
+
+    using AlignedBuffer = std::unique_ptr<u8, AlignedBufferDeleter>;
+
+    AlignedBuffer allocateAlignedBuffer(size_t size)
+    {
+        void* buffer = nullptr;
+        if (posix_memalign(&buffer, BUFFER_ALIGNMENT, size) != 0)
+            return nullptr;
+
+        return AlignedBuffer((u8*) buffer);
+    }
+}
+
+ZipExtractor::ZipExtractor(int archiveFd) : archiveFd(archiveFd)
+{
+}
+
+bool ZipExtractor::readFully(u64 offset, void* buffer, size_t size)
+{
+    u8* output = (u8*) buffer;
+    while (size > 0)
+    {
+        ssize_t result = pread(archiveFd, output, size, (off_t) offset);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            return false;
+        }
+
+        if (result == 0)
+            return false;
+
+        output += result;
+        offset += result;
+        size -= result;
+    }
+
+    return true;
+}
+
+bool ZipExtractor::findCentralDirectory(u64& offset, u64& size, u64& entryCount)
+{
+    struct stat archiveStat;
+    if (fstat(archiveFd, &archiveStat) != 0 || (u64) archiveStat.st_size < END_OF_CENTRAL_DIRECTORY_SIZE)
+        return false;
+
+    u64 archiveSize = (u64) archiveStat.st_size;
+    size_t tailSize = (size_t) std::min<u64>(archiveSize, END_OF_CENTRAL_DIRECTORY_SIZE + MAX_COMMENT_SIZE);
+    u64 tailOffset = archiveSize - tailSize;
+    std::vector<u8> tail(tailSize);
+    if (!readFully(tailOffset, tail.data(), tailSize))
+        return false;
+
+    // The end of central directory record is followed by a variable length comment, so it has to be searched backwards
+    for (size_t position = tailSize - END_OF_CENTRAL_DIRECTORY_SIZE + 1; position-- > 0;)
+    {
+        const u8* record = tail.data() + position;
+        if (read32(record) != END_OF_CENTRAL_DIRECTORY_SIGNATURE)
+            continue;
+
+        entryCount = read16(record + 10);
+        size = read32(record + 12);
+        offset = read32(record + 16);
+
+        if (entryCount != 0xFFFF && size != 0xFFFFFFFF && offset != 0xFFFFFFFF)
+            return isCentralDirectoryInArchive(offset, size, archiveSize);
+
+        // ZIP64 archive. The real values are in the ZIP64 record, which is referenced by the locator right before this record
+        u64 recordOffset = tailOffset + position;
+        if (recordOffset < ZIP64_END_OF_CENTRAL_DIRECTORY_LOCATOR_SIZE)
+            return false;
+
+        u8 locator[ZIP64_END_OF_CENTRAL_DIRECTORY_LOCATOR_SIZE];
+        if (!readFully(recordOffset - sizeof(locator), locator, sizeof(locator)) || read32(locator) != ZIP64_END_OF_CENTRAL_DIRECTORY_LOCATOR_SIGNATURE)
+            return false;
+
+        u8 zip64Record[ZIP64_END_OF_CENTRAL_DIRECTORY_SIZE];
+        if (!readFully(read64(locator + 8), zip64Record, sizeof(zip64Record)) || read32(zip64Record) != ZIP64_END_OF_CENTRAL_DIRECTORY_SIGNATURE)
+            return false;
+
+        entryCount = read64(zip64Record + 32);
+        size = read64(zip64Record + 40);
+        offset = read64(zip64Record + 48);
+        return isCentralDirectoryInArchive(offset, size, archiveSize);
+    }
+
+    return false;
+}
+
+bool ZipExtractor::findEntry(const std::function<bool(const std::string&)>& predicate, Entry& entry)
+{
+    u64 directoryOffset;
+    u64 directorySize;
+    u64 entryCount;
+    if (!findCentralDirectory(directoryOffset, directorySize, entryCount))
+        return false;
+
+    std::vector<u8> directory(directorySize);
+    if (!readFully(directoryOffset, directory.data(), directory.size()))
+        return false;
+
+    size_t position = 0;
+    for (u64 i = 0; i < entryCount; i++)
+    {
+        if (position + CENTRAL_HEADER_SIZE > directory.size())
+            return false;
+
+        const u8* header = directory.data() + position;
+        if (read32(header) != CENTRAL_HEADER_SIGNATURE)
+            return false;
+
+        u16 nameLength = read16(header + 28);
+        u16 extraLength = read16(header + 30);
+        u16 commentLength = read16(header + 32);
+        size_t nextPosition = position + CENTRAL_HEADER_SIZE + nameLength + extraLength + commentLength;
+        if (nextPosition > directory.size())
+            return false;
+
+        std::string name((const char*) header + CENTRAL_HEADER_SIZE, nameLength);
+        bool isDirectory = !name.empty() && name.back() == '/';
+        if (isDirectory || !predicate(name))
+        {
+            position = nextPosition;
+            continue;
+        }
+
+        entry = Entry {
+            .name = std::move(name),
+            .flags = read16(header + 8),
+            .method = read16(header + 10),
+            .crc = read32(header + 16),
+            .compressedSize = read32(header + 20),
+            .uncompressedSize = read32(header + 24),
+            .localHeaderOffset = read32(header + 42),
+        };
+
+        // Values that do not fit in 32 bits are stored in the ZIP64 extra field, in this order
+        const u8* extra = header + CENTRAL_HEADER_SIZE + nameLength;
+        const u8* extraEnd = extra + extraLength;
+        while (extra + 4 <= extraEnd)
+        {
+            u16 fieldId = read16(extra);
+            u16 fieldSize = read16(extra + 2);
+            const u8* field = extra + 4;
+            const u8* fieldEnd = std::min(field + fieldSize, extraEnd);
+            if (fieldId == ZIP64_EXTRA_FIELD_ID)
+            {
+                for (u64* value : { &entry.uncompressedSize, &entry.compressedSize, &entry.localHeaderOffset })
+                {
+                    if (*value == 0xFFFFFFFF && field + 8 <= fieldEnd)
+                    {
+                        *value = read64(field);
+                        field += 8;
+                    }
+                }
+            }
+            extra += 4 + fieldSize;
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+bool ZipExtractor::getEntryDataOffset(const Entry& entry, u64& dataOffset)
+{
+    u8 header[LOCAL_HEADER_SIZE];
+    if (!readFully(entry.localHeaderOffset, header, sizeof(header)) || read32(header) != LOCAL_HEADER_SIGNATURE)
+        return false;
+
+    // The local header can have a different extra field than the central directory
+    dataOffset = entry.localHeaderOffset + LOCAL_HEADER_SIZE + read16(header + 26) + read16(header + 28);
+    return true;
+}
+
+bool ZipExtractor::extractEntry(const Entry& entry, int outputFd)
+{
+    auto extractionStart = std::chrono::steady_clock::now();
+    stats = Stats {
+        .compressedSize = entry.compressedSize,
+        .uncompressedSize = entry.uncompressedSize,
+    };
+
+    if ((entry.flags & FLAG_ENCRYPTED) || (entry.method != METHOD_STORED && entry.method != METHOD_DEFLATED))
+        return false;
+
+    u64 dataOffset;
+    if (!getEntryDataOffset(entry, dataOffset))
+        return false;
+
+    AlignedBuffer bufferMemory[READ_BUFFER_COUNT];
+    ReadBuffer buffers[READ_BUFFER_COUNT];
+    ReadPipeline pipeline;
+    for (size_t i = 0; i < READ_BUFFER_COUNT; i++)
+    {
+        bufferMemory[i] = allocateAlignedBuffer(READ_BUFFER_SIZE);
+        if (!bufferMemory[i])
+            return false;
+
+        buffers[i] = ReadBuffer { .data = bufferMemory[i].get(), .size = 0 };
+        pipeline.pushFreeBuffer(&buffers[i]);
+    }
+
+    AlignedBuffer writeBuffer = allocateAlignedBuffer(WRITE_BUFFER_SIZE);
+    if (!writeBuffer)
+        return false;
+
+    std::thread readerThread([this, &pipeline, dataOffset, &entry] {
+        u64 offset = dataOffset;
+        u64 remaining = entry.compressedSize;
+        bool success = true;
+
+        while (remaining > 0)
+        {
+            ReadBuffer* buffer;
+            if (!pipeline.waitForFreeBuffer(buffer))
+                break;
+
+            buffer->size = (size_t) std::min<u64>(READ_BUFFER_SIZE, remaining);
+            if (!readFully(offset, buffer->data, buffer->size))
+            {
+                success = false;
+                break;
+            }
+
+            offset += buffer->size;
+            remaining -= buffer->size;
+            pipeline.pushFilledBuffer(buffer);
+        }
+
+        pipeline.finishReading(success);
+    });
+    pthread_setname_np(readerThread.native_handle(), "ZipReader");
+
+    z_stream stream = {};
+    bool isDeflated = entry.method == METHOD_DEFLATED;
+    // Negative window bits select a raw deflate stream, without the zlib header
+    bool success = !isDeflated || inflateInit2(&stream, -MAX_WBITS) == Z_OK;
+    bool streamFinished = !isDeflated;
+    u32 crc = 0;
+    u64 written = 0;
+
+    while (success)
+    {
+        ReadBuffer* buffer = pipeline.waitForFilledBuffer(stats.readWaitTimeMs);
+        if (buffer == nullptr)
+            break;
+
+        if (!isDeflated)
+        {
+            crc = Crc32::update(crc, buffer->data, buffer->size);
+            success = writeFully(outputFd, buffer->data, buffer->size);
+            written += buffer->size;
+        }
+        else
+        {
+            stream.next_in = buffer->data;
+            stream.avail_in = buffer->size;
+
+            // Inflate can hold back output when the write buffer fills up, even after it has consumed all the input, so it is called again
+            // until it stops filling the whole buffer
+            do
+            {
+                stream.next_out = writeBuffer.get();
+                stream.avail_out = WRITE_BUFFER_SIZE;
+
+                int result = inflate(&stream, Z_NO_FLUSH);
+                // No progress was possible without more input
+                if (result == Z_BUF_ERROR)
+                    break;
+
+                if (result != Z_OK && result != Z_STREAM_END)
+                {
+                    success = false;
+                    break;
+                }
+
+                size_t outputSize = WRITE_BUFFER_SIZE - stream.avail_out;
+                crc = Crc32::update(crc, writeBuffer.get(), outputSize);
+                success = writeFully(outputFd, writeBuffer.get(), outputSize);
+                written += outputSize;
+                streamFinished = result == Z_STREAM_END;
+            }
+            while (success && !streamFinished && (stream.avail_in > 0 || stream.avail_out == 0));
+        }
+
+        pipeline.pushFreeBuffer(buffer);
+    }
+
+    pipeline.cancel();
+    readerThread.join();
+
+    if (isDeflated)
+        inflateEnd(&stream);
+
+    stats.totalTimeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - extractionStart).count();
+    // A deflate stream that ends before Z_STREAM_END is truncated, even if the expected number of bytes was written
+    return success && streamFinished && !pipeline.hasReadFailed() && written == entry.uncompressedSize && crc == entry.crc;
+}
+
+ZipExtractor::Stats ZipExtractor::getStats() const
+{
+    return stats;
+}
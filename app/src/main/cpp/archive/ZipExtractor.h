@@ -0,0 +1,63 @@
+#ifndef MELONDS_ANDROID_ZIPEXTRACTOR_H
+#define MELONDS_ANDROID_ZIPEXTRACTOR_H
+
+#include <functional>
+#include <string>
+#include "types.h"
+
+/**
+ * Extracts entries from ZIP archives using only positional reads on the archive's file descriptor. Reading and decompression overlap: a reader
+ * thread fills a small pool of large aligned buffers while the calling thread inflates them and writes the result to the output descriptor.
+ */
+class ZipExtractor
+{
+public:
+    struct Entry
+    {
+        std::string name;
+        melonDS::u16 flags;
+        melonDS::u16 method;
+        melonDS::u32 crc;
+        melonDS::u64 compressedSize;
+        melonDS::u64 uncompressedSize;
+        melonDS::u64 localHeaderOffset;
+    };
+
+    struct Stats
+    {
+        melonDS::u64 compressedSize;
+        melonDS::u64 uncompressedSize;
+        double readWaitTimeMs;
+        double totalTimeMs;
+    };
+
+    /**
+     * @param archiveFd Descriptor of the archive. It is not closed by the extractor
+     */
+    explicit ZipExtractor(int archiveFd);
+
+    /**
+     * Finds the first file entry in the central directory whose name matches the predicate.
+     */
+    bool findEntry(const std::function<bool(const std::string&)>& predicate, Entry& entry);
+
+    /**
+     * Extracts the entry into the output descriptor, starting at its current position, and validates its CRC.
+     */
+    bool extractEntry(const Entry& entry, int outputFd);
+    Stats getStats() const;
+
+private:
+    static constexpr size_t READ_BUFFER_SIZE = 1024 * 1024;
+    static constexpr size_t READ_BUFFER_COUNT = 3;
+    static constexpr size_t WRITE_BUFFER_SIZE = 1024 * 1024;
+
+    int archiveFd;
+    Stats stats = {};
+
+    bool readFully(melonDS::u64 offset, void* buffer, size_t size);
+    bool findCentralDirectory(melonDS::u64& offset, melonDS::u64& size, melonDS::u64& entryCount);
+    bool getEntryDataOffset(const Entry& entry, melonDS::u64& dataOffset);
+};
+
+#endif //MELONDS_ANDROID_ZIPEXTRACTOR_H
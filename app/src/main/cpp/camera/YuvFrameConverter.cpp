@@ -0,0 +1,194 @@
+#include "YuvFrameConverter.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+using namespace melonDS;
+using YuvFrameConverter::FRAME_WIDTH;
+using YuvFrameConverter::FRAME_HEIGHT;
+
+namespace
+{
+    // Y is 0 and U and V are neutral, to match BlackDSiCameraSource
+    constexpr u8 BLACK_LUMA = 0;
+    constexpr u8 BLACK_CHROMA = 127;
+
+    /**
+     * Source sampling offsets for one frame. With rotations that are multiples of 90 degrees, each output column always maps to the same source
+     * column (or row, for 90 and 270 degrees) and each output row to the same source row (or column), so the source offset of every output
+     * pixel is the sum of a row offset and a column offset.
+     */
+    struct SamplingTables
+    {
+        u32 yColumnOffsets[FRAME_WIDTH];
+        u32 uvColumnOffsets[FRAME_WIDTH];
+        u32 yRowOffsets[FRAME_HEIGHT];
+        u32 uvRowOffsets[FRAME_HEIGHT];
+        // Whether each output row reads a contiguous run of source pixels, without scaling
+        bool isRowContiguous;
+    };
+
+    inline u32 clampCoordinate(float coordinate, u32 size)
+    {
+        int value = (int) coordinate;
+        return (u32) std::clamp(value, 0, (int) size - 1);
+    }
+
+    void buildSamplingTables(const YuvFrameConverter::Yuv420Image& image, SamplingTables& tables)
+    {
+        bool isRotated = image.rotationDegrees == 90 || image.rotationDegrees == 270;
+        float realWidth = isRotated ? image.height : image.width;
+        float realHeight = isRotated ? image.width : image.height;
+
+        // Scale so that the image fills the whole frame, cropping the side that does not fit the frame's aspect ratio
+        float targetAspectRatio = (float) FRAME_WIDTH / FRAME_HEIGHT;
+        float scale = (realWidth / realHeight > targetAspectRatio) ? realHeight / FRAME_HEIGHT : realWidth / FRAME_WIDTH;
+        float centerX = (FRAME_WIDTH - 1) / 2.0f;
+        float centerY = (FRAME_HEIGHT - 1) / 2.0f;
+        float sourceCenterX = isRotated ? centerY * (realHeight / FRAME_HEIGHT) : centerX * (realWidth / FRAME_WIDTH);
+        float sourceCenterY = isRotated ? centerX * (realWidth / FRAME_WIDTH) : centerY * (realHeight / FRAME_HEIGHT);
+
+        // Direction in which source coordinates advance when moving right or down in the frame. Columns advance along the source X axis, or
+        // along the Y axis for rotated images, and rows along the other one
+        float columnDirection = (image.rotationDegrees == 0 || image.rotationDegrees == 270) ? scale : -scale;
+        float rowDirection = (image.rotationDegrees == 0 || image.rotationDegrees == 90) ? scale : -scale;
+
+        for (u32 x = 0; x < FRAME_WIDTH; x++)
+        {
+            float offset = (x - centerX) * columnDirection;
+            if (isRotated)
+            {
+                u32 sourceY = clampCoordinate(sourceCenterY + offset, image.height);
+                tables.yColumnOffsets[x] = sourceY * image.yRowStride;
+                tables.uvColumnOffsets[x] = (sourceY / 2) * image.uvRowStride;
+            }
+            else
+            {
+                u32 sourceX = clampCoordinate(sourceCenterX + offset, image.width);
+                tables.yColumnOffsets[x] = sourceX;
+                tables.uvColumnOffsets[x] = (sourceX / 2) * image.uvPixelStride;
+            }
+        }
+
+        for (u32 y = 0; y < FRAME_HEIGHT; y++)
+        {
+            float offset = (y - centerY) * rowDirection;
+            if (isRotated)
+            {
+                u32 sourceX = clampCoordinate(sourceCenterX + offset, image.width);
+                tables.yRowOffsets[y] = sourceX;
+                tables.uvRowOffsets[y] = (sourceX / 2) * image.uvPixelStride;
+            }
+            else
+            {
+                u32 sourceY = clampCoordinate(sourceCenterY + offset, image.height);
+                tables.yRowOffsets[y] = sourceY * image.yRowStride;
+                tables.uvRowOffsets[y] = (sourceY / 2) * image.uvRowStride;
+            }
+        }
+
+        tables.isRowContiguous = image.rotationDegrees == 0;
+        for (u32 x = 0; x < FRAME_WIDTH && tables.isRowContiguous; x += 2)
+        {
+            tables.isRowContiguous = tables.yColumnOffsets[x] == tables.yColumnOffsets[0] + x &&
+                                     tables.yColumnOffsets[x + 1] == tables.yColumnOffsets[0] + x + 1 &&
+                                     tables.uvColumnOffsets[x] == tables.uvColumnOffsets[0] + (x / 2) * image.uvPixelStride;
+        }
+    }
+
+    void convertRow(const u8* y, const u8* u, const u8* v, const SamplingTables& tables, u32 row, u8* output)
+    {
+        const u8* yRow = y + tables.yRowOffsets[row];
+        const u8* uRow = u + tables.uvRowOffsets[row];
+        const u8* vRow = v + tables.uvRowOffsets[row];
+
+        for (u32 x = 0; x < FRAME_WIDTH; x += 2)
+        {
+            // Both pixels of the pair share the chroma of the first one
+            output[0] = yRow[tables.yColumnOffsets[x]];
+            output[1] = uRow[tables.uvColumnOffsets[x]];
+            output[2] = yRow[tables.yColumnOffsets[x + 1]];
+            output[3] = vRow[tables.uvColumnOffsets[x]];
+            output += 4;
+        }
+    }
+
+#if defined(__ARM_NEON)
+    /**
+     * Converts a row that maps to a contiguous run of source pixels. Produces 16 pixels per iteration. Returns false if the chroma layout is not
+     * supported, in which case nothing is written.
+     */
+    bool convertContiguousRowNeon(const YuvFrameConverter::Yuv420Image& image, const SamplingTables& tables, u32 row, u8* output)
+    {
+        const u8* yRow = image.y + tables.yRowOffsets[row] + tables.yColumnOffsets[0];
+        u32 uvOffset = tables.uvRowOffsets[row] + tables.uvColumnOffsets[0];
+
+        if (image.uvPixelStride == 2 && (image.v == image.u + 1 || image.u == image.v + 1))
+        {
+            // Semi-planar chroma (NV12 or NV21). U and V are already paired, and only need to be interleaved with Y
+            bool isVFirst = image.u == image.v + 1;
+            const u8* uvRow = (isVFirst ? image.v : image.u) + uvOffset;
+            for (u32 x = 0; x < FRAME_WIDTH; x += 16)
+            {
+                uint8x16x2_t yuyv;
+                yuyv.val[0] = vld1q_u8(yRow + x);
+                yuyv.val[1] = vld1q_u8(uvRow + x);
+                if (isVFirst)
+                    yuyv.val[1] = vrev16q_u8(yuyv.val[1]);
+
+                vst2q_u8(output + x * 2, yuyv);
+            }
+            return true;
+        }
+
+        if (image.uvPixelStride == 1)
+        {
+            const u8* uRow = image.u + uvOffset;
+            const u8* vRow = image.v + uvOffset;
+            for (u32 x = 0; x < FRAME_WIDTH; x += 16)
+            {
+                uint8x8x2_t uv = vzip_u8(vld1_u8(uRow + x / 2), vld1_u8(vRow + x / 2));
+                uint8x16x2_t yuyv;
+                yuyv.val[0] = vld1q_u8(yRow + x);
+                yuyv.val[1] = vcombine_u8(uv.val[0], uv.val[1]);
+                vst2q_u8(output + x * 2, yuyv);
+            }
+            return true;
+        }
+
+        return false;
+    }
+#endif
+}
+
+void YuvFrameConverter::convert(const Yuv420Image& image, u8* frame)
+{
+    if (image.width == 0 || image.height == 0)
+    {
+        fillBlack(frame);
+        return;
+    }
+
+    SamplingTables tables;
+    buildSamplingTables(image, tables);
+
+    for (u32 row = 0; row < FRAME_HEIGHT; row++)
+    {
+        u8* output = frame + row * FRAME_WIDTH * 2;
+#if defined(__ARM_NEON)
+        if (tables.isRowContiguous && convertContiguousRowNeon(image, tables, row, output))
+            continue;
+#endif
+        convertRow(image.y, image.u, image.v, tables, row, output);
+    }
+}
+
+void YuvFrameConverter::fillBlack(u8* frame)
+{
+    u8 pattern[4] = { BLACK_LUMA, BLACK_CHROMA, BLACK_LUMA, BLACK_CHROMA };
+    for (u32 i = 0; i < FRAME_SIZE; i += 4)
+        memcpy(frame + i, pattern, sizeof(pattern));
+}
@@ -0,0 +1,38 @@
+#ifndef MELONDS_ANDROID_YUVFRAMECONVERTER_H
+#define MELONDS_ANDROID_YUVFRAMECONVERTER_H
+
+#include "types.h"
+
+/**
+ * Conversion of camera images to the frame format expected by the DSi cameras: 640x480 YUV 4:2:2, with the byte structure YUYV YUYV (4 bytes per
+ * 2 pixels). Images are rotated to be upright, scaled to fill the whole frame and cropped to its aspect ratio, using nearest neighbour sampling.
+ */
+namespace YuvFrameConverter
+{
+    constexpr melonDS::u32 FRAME_WIDTH = 640;
+    constexpr melonDS::u32 FRAME_HEIGHT = 480;
+    constexpr melonDS::u32 FRAME_SIZE = FRAME_WIDTH * FRAME_HEIGHT * 2;
+
+    /**
+     * A YUV 4:2:0 image, as delivered by the Android camera APIs. The chroma planes can either be planar (pixel stride of 1) or interleaved
+     * (pixel stride of 2, with the U and V pointers 1 byte apart).
+     */
+    struct Yuv420Image
+    {
+        const melonDS::u8* y;
+        const melonDS::u8* u;
+        const melonDS::u8* v;
+        melonDS::u32 width;
+        melonDS::u32 height;
+        melonDS::u32 yRowStride;
+        melonDS::u32 uvRowStride;
+        melonDS::u32 uvPixelStride;
+        // Clockwise rotation that must be applied to the image to make it upright. Must be 0, 90, 180 or 270
+        melonDS::u32 rotationDegrees;
+    };
+
+    void convert(const Yuv420Image& image, melonDS::u8* frame);
+    void fillBlack(melonDS::u8* frame);
+}
+
+#endif //MELONDS_ANDROID_YUVFRAMECONVERTER_H
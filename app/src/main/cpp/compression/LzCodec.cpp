@@ -0,0 +1,213 @@
+#include "LzCodec.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace melonDS;
+
+namespace
+{
+    constexpr size_t MIN_MATCH = 4;
+    constexpr size_t LAST_LITERALS = 5;
+    // A match must start at least this many bytes before the end of the input
+    constexpr size_t MATCH_FIND_LIMIT = 12;
+    constexpr size_t MAX_OFFSET = 65535;
+    constexpr int HASH_BITS = 14;
+
+    inline u32 read32(const u8* data)
+    {
+        u32 value;
+        memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    inline u32 hashSequence(u32 sequence)
+    {
+        return (sequence * 2654435761u) >> (32 - HASH_BITS);
+    }
+
+    inline u8* writeExtendedLength(u8* output, size_t length)
+    {
+        while (length >= 255)
+        {
+            *output++ = 255;
+            length -= 255;
+        }
+        *output++ = (u8) length;
+        return output;
+    }
+
+    inline bool readExtendedLength(const u8*& input, const u8* inputEnd, size_t& length)
+    {
+        u8 value;
+        do
+        {
+            if (input >= inputEnd)
+                return false;
+
+            value = *input++;
+            length += value;
+        } while (value == 255);
+
+        return true;
+    }
+
+    u8* writeSequence(u8* output, const u8* literals, size_t literalLength, size_t offset, size_t matchLength)
+    {
+        u8* token = output++;
+        *token = (u8) (std::min<size_t>(literalLength, 15) << 4);
+        if (literalLength >= 15)
+            output = writeExtendedLength(output, literalLength - 15);
+
+        memcpy(output, literals, literalLength);
+        output += literalLength;
+
+        if (offset == 0)
+            return output;
+
+        *output++ = (u8) (offset & 0xFF);
+        *output++ = (u8) (offset >> 8);
+
+        size_t encodedMatchLength = matchLength - MIN_MATCH;
+        *token |= (u8) std::min<size_t>(encodedMatchLength, 15);
+        if (encodedMatchLength >= 15)
+            output = writeExtendedLength(output, encodedMatchLength - 15);
+
+        return output;
+    }
+}
+
+size_t LzCodec::getMaxCompressedSize(size_t inputSize)
+{
+    return inputSize + inputSize / 255 + 16;
+}
+
+size_t LzCodec::compress(const u8* input, size_t inputSize, u8* output, size_t outputCapacity)
+{
+    if (outputCapacity < getMaxCompressedSize(inputSize))
+        return 0;
+
+    u8* op = output;
+    const u8* anchor = input;
+
+    if (inputSize > MATCH_FIND_LIMIT)
+    {
+        u32 hashTable[1 << HASH_BITS] = {};
+
+        const u8* ip = input + 1;
+        const u8* matchFindLimit = input + inputSize - MATCH_FIND_LIMIT;
+        const u8* matchLimit = input + inputSize - LAST_LITERALS;
+
+        while (ip < matchFindLimit)
+        {
+            u32 sequence = read32(ip);
+            u32 hash = hashSequence(sequence);
+            const u8* reference = input + hashTable[hash];
+            hashTable[hash] = (u32) (ip - input);
+
+            if (reference >= ip || (size_t) (ip - reference) > MAX_OFFSET || read32(reference) != sequence)
+            {
+                // Skip faster through data that does not compress
+                ip += 1 + ((ip - anchor) >> 6);
+                continue;
+            }
+
+            while (ip > anchor && reference > input && ip[-1] == reference[-1])
+            {
+                ip--;
+                reference--;
+            }
+
+            const u8* matchEnd = ip + MIN_MATCH;
+            const u8* referenceEnd = reference + MIN_MATCH;
+            while (matchEnd < matchLimit && *matchEnd == *referenceEnd)
+            {
+                matchEnd++;
+                referenceEnd++;
+            }
+
+            op = writeSequence(op, anchor, ip - anchor, ip - reference, matchEnd - ip);
+
+            ip = matchEnd;
+            anchor = ip;
+
+            if (ip < matchFindLimit)
+                hashTable[hashSequence(read32(ip - 2))] = (u32) (ip - 2 - input);
+        }
+    }
+
+    op = writeSequence(op, anchor, input + inputSize - anchor, 0, 0);
+    return op - output;
+}
+
+bool LzCodec::decompress(const u8* input, size_t inputSize, u8* output, size_t outputSize)
+{
+    const u8* ip = input;
+    const u8* inputEnd = input + inputSize;
+    u8* op = output;
+    u8* outputEnd = output + outputSize;
+
+    while (ip < inputEnd)
+    {
+        u8 token = *ip++;
+
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && !readExtendedLength(ip, inputEnd, literalLength))
+            return false;
+
+        if (literalLength > (size_t) (inputEnd - ip) || literalLength > (size_t) (outputEnd - op))
+            return false;
+
+        memcpy(op, ip, literalLength);
+        op += literalLength;
+        ip += literalLength;
+
+        // The last sequence only contains literals
+        if (ip == inputEnd)
+            break;
+
+        if (inputEnd - ip < 2)
+            return false;
+
+        size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (size_t) (op - output))
+            return false;
+
+        size_t matchLength = token & 0x0F;
+        if (matchLength == 15 && !readExtendedLength(ip, inputEnd, matchLength))
+            return false;
+
+        matchLength += MIN_MATCH;
+        if (matchLength > (size_t) (outputEnd - op))
+            return false;
+
+        const u8* match = op - offset;
+        if (offset >= matchLength)
+        {
+            memcpy(op, match, matchLength);
+        }
+        else if (offset == 1)
+        {
+            memset(op, *match, matchLength);
+        }
+        else
+        {
+            // Overlapping match. Replicate the repeating pattern, doubling the copied span on every step so that source and destination never overlap
+            u8* destination = op;
+            size_t remaining = matchLength;
+            size_t span = offset;
+            while (remaining > 0)
+            {
+                size_t chunk = std::min(span, remaining);
+                memcpy(destination, match, chunk);
+                destination += chunk;
+                remaining -= chunk;
+                span *= 2;
+            }
+        }
+
+        op += matchLength;
+    }
+
+    return op == outputEnd;
+}
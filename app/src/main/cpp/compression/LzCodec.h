@@ -0,0 +1,30 @@
+#ifndef MELONDS_ANDROID_LZCODEC_H
+#define MELONDS_ANDROID_LZCODEC_H
+
+#include <cstddef>
+#include "types.h"
+
+/**
+ * Fast LZ77 block codec using the LZ4 block layout (token, literals, 16-bit offset, match length). It favours speed over ratio and is meant
+ * for data that is compressed and decompressed within the app, like rewind states.
+ */
+namespace LzCodec
+{
+    size_t getMaxCompressedSize(size_t inputSize);
+
+    /**
+     * Compresses the input into the output buffer.
+     *
+     * @return The size of the compressed data, or 0 if the output buffer is smaller than getMaxCompressedSize(inputSize)
+     */
+    size_t compress(const melonDS::u8* input, size_t inputSize, melonDS::u8* output, size_t outputCapacity);
+
+    /**
+     * Decompresses a block created by compress(). The output buffer must have exactly the size of the original data.
+     *
+     * @return True if the block was valid and fully decompressed
+     */
+    bool decompress(const melonDS::u8* input, size_t inputSize, melonDS::u8* output, size_t outputSize);
+}
+
+#endif //MELONDS_ANDROID_LZCODEC_H
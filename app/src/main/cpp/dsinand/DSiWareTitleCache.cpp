@@ -0,0 +1,122 @@
+#include "DSiWareTitleCache.h"
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include "Platform.h"
+
+using namespace melonDS;
+
+void DSiWareTitleCache::load(const std::string& path)
+{
+    this->path = path;
+    entries.clear();
+    isDirty = false;
+
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr)
+        return;
+
+    FileHeader header;
+    bool isValid = fread(&header, sizeof(header), 1, file) == 1 && header.magic == MAGIC && header.formatVersion == FORMAT_VERSION && header.entrySize == sizeof(Entry);
+    if (isValid)
+    {
+        auto entry = std::make_unique<Entry>();
+        for (u32 i = 0; i < header.entryCount; i++)
+        {
+            if (fread(entry.get(), sizeof(Entry), 1, file) != 1)
+            {
+                isValid = false;
+                break;
+            }
+
+            entries[entry->titleId] = *entry;
+        }
+    }
+
+    fclose(file);
+
+    if (!isValid)
+    {
+        Platform::Log(Platform::LogLevel::Warn, "Discarding invalid DSiWare title cache");
+        entries.clear();
+        remove(path.c_str());
+    }
+}
+
+bool DSiWareTitleCache::save()
+{
+    if (!isDirty || path.empty())
+        return true;
+
+    std::string temporaryPath = path + ".tmp";
+    FILE* file = fopen(temporaryPath.c_str(), "wb");
+    if (file == nullptr)
+        return false;
+
+    FileHeader header = {
+        .magic = MAGIC,
+        .formatVersion = FORMAT_VERSION,
+        .entryCount = (u32) entries.size(),
+        .entrySize = sizeof(Entry),
+    };
+
+    bool success = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (auto it = entries.begin(); success && it != entries.end(); it++)
+        success = fwrite(&it->second, sizeof(Entry), 1, file) == 1;
+
+    success = fclose(file) == 0 && success;
+    if (!success || rename(temporaryPath.c_str(), path.c_str()) != 0)
+    {
+        remove(temporaryPath.c_str());
+        return false;
+    }
+
+    isDirty = false;
+    return true;
+}
+
+const DSiWareTitleCache::Entry* DSiWareTitleCache::getEntry(u32 titleId, u32 version) const
+{
+    auto it = entries.find(titleId);
+    if (it == entries.end() || it->second.version != version)
+        return nullptr;
+
+    return &it->second;
+}
+
+const DSiWareTitleCache::Entry* DSiWareTitleCache::putEntry(const Entry& entry)
+{
+    Entry& storedEntry = entries[entry.titleId];
+    storedEntry = entry;
+    isDirty = true;
+    return &storedEntry;
+}
+
+void DSiWareTitleCache::removeEntry(u32 titleId)
+{
+    if (entries.erase(titleId) > 0)
+        isDirty = true;
+}
+
+void DSiWareTitleCache::retainEntries(const std::vector<u32>& titleIds)
+{
+    for (auto it = entries.begin(); it != entries.end();)
+    {
+        if (std::find(titleIds.begin(), titleIds.end(), it->first) == titleIds.end())
+        {
+            it = entries.erase(it);
+            isDirty = true;
+        }
+        else
+        {
+            it++;
+        }
+    }
+}
+
+void DSiWareTitleCache::clear()
+{
+    entries.clear();
+    isDirty = false;
+    path.clear();
+}
@@ -0,0 +1,72 @@
+#ifndef MELONDS_ANDROID_DSIWARETITLECACHE_H
+#define MELONDS_ANDROID_DSIWARETITLECACHE_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "types.h"
+
+/**
+ * Persistent cache of the metadata of the titles installed in a DSi NAND. Reading the header and banner of a title requires decrypting its app file
+ * through the NAND FAT, so they are only read once per title version. Since a title ID and TMD version always identify the same app, entries stay
+ * valid even if a different NAND is opened.
+ */
+class DSiWareTitleCache
+{
+public:
+    static constexpr size_t BANNER_SIZE = 0x23C0;
+
+    struct Entry
+    {
+        melonDS::u32 titleId;
+        melonDS::u32 version;
+        melonDS::u32 publicSavSize;
+        melonDS::u32 privateSavSize;
+        melonDS::u32 appFlags;
+        melonDS::u8 banner[BANNER_SIZE];
+    };
+
+    /**
+     * Loads the cache from the given file. The cache is left empty if the file does not exist or is not valid.
+     */
+    void load(const std::string& path);
+
+    /**
+     * Writes the cache back to the file it was loaded from, if it has been modified since.
+     */
+    bool save();
+
+    /**
+     * Returns the entry of the given title, or null if it is not cached or if it was cached for a different version.
+     */
+    const Entry* getEntry(melonDS::u32 titleId, melonDS::u32 version) const;
+    /**
+     * Adds or replaces the entry of a title. Returned pointers stay valid until the entry is removed.
+     */
+    const Entry* putEntry(const Entry& entry);
+    void removeEntry(melonDS::u32 titleId);
+
+    /**
+     * Removes the entries of all titles that are not in the given list.
+     */
+    void retainEntries(const std::vector<melonDS::u32>& titleIds);
+    void clear();
+
+private:
+    static constexpr melonDS::u32 MAGIC = 0x43545744; // "DWTC"
+    static constexpr melonDS::u32 FORMAT_VERSION = 1;
+
+    struct FileHeader
+    {
+        melonDS::u32 magic;
+        melonDS::u32 formatVersion;
+        melonDS::u32 entryCount;
+        melonDS::u32 entrySize;
+    };
+
+    std::string path;
+    std::unordered_map<melonDS::u32, Entry> entries;
+    bool isDirty = false;
+};
+
+#endif //MELONDS_ANDROID_DSIWARETITLECACHE_H
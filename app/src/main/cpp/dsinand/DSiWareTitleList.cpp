@@ -0,0 +1,64 @@
+#include "DSiWareTitleList.h"
+#include <cstring>
+#include "../RomIconBuilder.h"
+
+using namespace melonDS;
+
+namespace
+{
+    // Offset of the English title in a banner
+    constexpr size_t BANNER_ENGLISH_TITLE_OFFSET = 0x340;
+}
+
+void DSiWareTitleList::build(const DSiWareTitleCache::Entry* const* entries, size_t count, std::vector<u8>& output)
+{
+    size_t recordsEnd = sizeof(Header) + count * sizeof(TitleRecord);
+    output.assign(recordsEnd, 0);
+
+    Header header = {
+        .titleCount = (u32) count,
+        .recordSize = sizeof(TitleRecord),
+    };
+    memcpy(output.data(), &header, sizeof(header));
+
+    std::vector<const u8*> banners(count);
+    for (size_t i = 0; i < count; i++)
+        banners[i] = entries[i]->banner;
+
+    std::vector<u32> icons(count * MelonDSAndroid::ROM_ICON_PIXEL_COUNT);
+    MelonDSAndroid::BuildRomIcons(banners.data(), count, icons.data());
+
+    std::vector<u32> animationFrames(MelonDSAndroid::MAX_ANIMATED_ICON_FRAMES * MelonDSAndroid::ROM_ICON_PIXEL_COUNT);
+    u16 frameDurations[MelonDSAndroid::MAX_ANIMATED_ICON_FRAMES];
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const DSiWareTitleCache::Entry* entry = entries[i];
+        TitleRecord record = {
+            .titleId = entry->titleId,
+            .version = entry->version,
+            .publicSavSize = entry->publicSavSize,
+            .privateSavSize = entry->privateSavSize,
+            .appFlags = entry->appFlags,
+        };
+        memcpy(record.title, entry->banner + BANNER_ENGLISH_TITLE_OFFSET, sizeof(record.title));
+        memcpy(record.icon, icons.data() + i * MelonDSAndroid::ROM_ICON_PIXEL_COUNT, sizeof(record.icon));
+
+        int frameCount = MelonDSAndroid::BuildAnimatedRomIcon(entry->banner, sizeof(entry->banner), animationFrames.data(), frameDurations);
+        if (frameCount > 0)
+        {
+            size_t framesSize = frameCount * MelonDSAndroid::ROM_ICON_PIXEL_COUNT * sizeof(u32);
+            record.animationFrameCount = frameCount;
+            record.animationOffset = (u32) output.size();
+
+            output.insert(output.end(), (const u8*) animationFrames.data(), (const u8*) animationFrames.data() + framesSize);
+            for (int frame = 0; frame < frameCount; frame++)
+            {
+                u32 duration = frameDurations[frame];
+                output.insert(output.end(), (const u8*) &duration, (const u8*) &duration + sizeof(duration));
+            }
+        }
+
+        memcpy(output.data() + sizeof(Header) + i * sizeof(TitleRecord), &record, sizeof(record));
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef MELONDS_ANDROID_DSIWARETITLELIST_H
+#define MELONDS_ANDROID_DSIWARETITLELIST_H
+
+#include <vector>
+#include "types.h"
+#include "DSiWareTitleCache.h"
+
+/**
+ * Packs the metadata of a list of DSiWare titles into a single buffer, so that it can be handed to Kotlin at once (see DSiWareTitleList.kt). The
+ * header is followed by one fixed-size record per title, and then by the frames of the animated icons. All fields are in native byte order.
+ */
+namespace DSiWareTitleList
+{
+    struct Header
+    {
+        melonDS::u32 titleCount;
+        melonDS::u32 recordSize;
+    };
+
+    struct TitleRecord
+    {
+        melonDS::u32 titleId;
+        melonDS::u32 version;
+        melonDS::u32 publicSavSize;
+        melonDS::u32 privateSavSize;
+        melonDS::u32 appFlags;
+        melonDS::u32 animationFrameCount;
+        // Offset of the animation in the buffer. The frames are stored as a vertical RGBA atlas followed by one u32 duration per frame
+        melonDS::u32 animationOffset;
+        melonDS::u32 reserved;
+        // UTF-16 English title from the banner
+        melonDS::u16 title[128];
+        melonDS::u32 icon[32 * 32];
+    };
+
+    static_assert(sizeof(TitleRecord) == 4384, "The title record layout must match DSiWareTitleList.kt");
+
+    void build(const DSiWareTitleCache::Entry* const* entries, size_t count, std::vector<melonDS::u8>& output);
+}
+
+#endif //MELONDS_ANDROID_DSIWARETITLELIST_H
@@ -0,0 +1,139 @@
+#include "Crc32.h"
+#include <cstring>
+
+#if defined(__aarch64__)
+#include <arm_acle.h>
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
+using namespace melonDS;
+
+namespace
+{
+    constexpr u32 POLYNOMIAL = 0xEDB88320;
+
+    struct SlicingTables
+    {
+        u32 values[8][256];
+
+        constexpr SlicingTables() : values()
+        {
+            for (u32 i = 0; i < 256; i++)
+            {
+                u32 value = i;
+                for (int bit = 0; bit < 8; bit++)
+                    value = (value & 1) ? (value >> 1) ^ POLYNOMIAL : value >> 1;
+
+                values[0][i] = value;
+            }
+
+            // Table n gives the contribution of a byte that is followed by n more bytes
+            for (u32 i = 0; i < 256; i++)
+            {
+                for (int table = 1; table < 8; table++)
+                    values[table][i] = (values[table - 1][i] >> 8) ^ values[0][values[table - 1][i] & 0xFF];
+            }
+        }
+    };
+
+    constexpr SlicingTables TABLES;
+
+    u32 updateSlicingBy8(u32 crc, const u8* data, size_t size)
+    {
+        while (size >= 8)
+        {
+            u32 low;
+            u32 high;
+            memcpy(&low, data, sizeof(low));
+            memcpy(&high, data + 4, sizeof(high));
+            // Little endian is assumed, as on all Android ABIs
+            low ^= crc;
+
+            crc = TABLES.values[7][low & 0xFF] ^
+                  TABLES.values[6][(low >> 8) & 0xFF] ^
+                  TABLES.values[5][(low >> 16) & 0xFF] ^
+                  TABLES.values[4][low >> 24] ^
+                  TABLES.values[3][high & 0xFF] ^
+                  TABLES.values[2][(high >> 8) & 0xFF] ^
+                  TABLES.values[1][(high >> 16) & 0xFF] ^
+                  TABLES.values[0][high >> 24];
+
+            data += 8;
+            size -= 8;
+        }
+
+        while (size > 0)
+        {
+            crc = TABLES.values[0][(crc ^ *data) & 0xFF] ^ (crc >> 8);
+            data++;
+            size--;
+        }
+
+        return crc;
+    }
+
+#if defined(__aarch64__)
+    __attribute__((target("crc")))
+    u32 updateHardware(u32 crc, const u8* data, size_t size)
+    {
+        while (size > 0 && ((uintptr_t) data & 7) != 0)
+        {
+            crc = __crc32b(crc, *data);
+            data++;
+            size--;
+        }
+
+        while (size >= 32)
+        {
+            u64 values[4];
+            memcpy(values, data, sizeof(values));
+            crc = __crc32d(crc, values[0]);
+            crc = __crc32d(crc, values[1]);
+            crc = __crc32d(crc, values[2]);
+            crc = __crc32d(crc, values[3]);
+            data += 32;
+            size -= 32;
+        }
+
+        while (size >= 8)
+        {
+            u64 value;
+            memcpy(&value, data, sizeof(value));
+            crc = __crc32d(crc, value);
+            data += 8;
+            size -= 8;
+        }
+
+        while (size > 0)
+        {
+            crc = __crc32b(crc, *data);
+            data++;
+            size--;
+        }
+
+        return crc;
+    }
+
+    const bool hasCrcInstructions = (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+#endif
+}
+
+u32 Crc32::update(u32 crc, const u8* data, size_t size)
+{
+    crc = ~crc;
+#if defined(__aarch64__)
+    if (hasCrcInstructions)
+        return ~updateHardware(crc, data, size);
+#endif
+    return ~updateSlicingBy8(crc, data, size);
+}
+
+bool Crc32::isHardwareAccelerated()
+{
+#if defined(__aarch64__)
+    return hasCrcInstructions;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,27 @@
+#ifndef MELONDS_ANDROID_CRC32_H
+#define MELONDS_ANDROID_CRC32_H
+
+#include <cstddef>
+#include "types.h"
+
+/**
+ * CRC-32 (the IEEE polynomial used by ZIP, PNG and zlib). Uses the ARMv8 CRC32 instructions when the CPU supports them, and slicing-by-8 tables
+ * otherwise.
+ */
+namespace Crc32
+{
+    /**
+     * Continues a CRC computation. Like zlib's crc32(), the initial value is 0 and the returned value is final, so it can be passed again to
+     * process more data.
+     */
+    melonDS::u32 update(melonDS::u32 crc, const melonDS::u8* data, size_t size);
+
+    inline melonDS::u32 compute(const melonDS::u8* data, size_t size)
+    {
+        return update(0, data, size);
+    }
+
+    bool isHardwareAccelerated();
+}
+
+#endif //MELONDS_ANDROID_CRC32_H
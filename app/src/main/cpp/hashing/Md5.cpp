@@ -0,0 +1,142 @@
+#include "Md5.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace melonDS;
+
+namespace
+{
+    constexpr u32 ROUND_CONSTANTS[64] = {
+        0xD76AA478, 0xE8C7B756, 0x242070DB, 0xC1BDCEEE, 0xF57C0FAF, 0x4787C62A, 0xA8304613, 0xFD469501,
+        0x698098D8, 0x8B44F7AF, 0xFFFF5BB1, 0x895CD7BE, 0x6B901122, 0xFD987193, 0xA679438E, 0x49B40821,
+        0xF61E2562, 0xC040B340, 0x265E5A51, 0xE9B6C7AA, 0xD62F105D, 0x02441453, 0xD8A1E681, 0xE7D3FBC8,
+        0x21E1CDE6, 0xC33707D6, 0xF4D50D87, 0x455A14ED, 0xA9E3E905, 0xFCEFA3F8, 0x676F02D9, 0x8D2A4C8A,
+        0xFFFA3942, 0x8771F681, 0x6D9D6122, 0xFDE5380C, 0xA4BEEA44, 0x4BDECFA9, 0xF6BB4B60, 0xBEBFBC70,
+        0x289B7EC6, 0xEAA127FA, 0xD4EF3085, 0x04881D05, 0xD9D4D039, 0xE6DB99E5, 0x1FA27CF8, 0xC4AC5665,
+        0xF4292244, 0x432AFF97, 0xAB9423A7, 0xFC93A039, 0x655B59C3, 0x8F0CCC92, 0xFFEFF47D, 0x85845DD1,
+        0x6FA87E4F, 0xFE2CE6E0, 0xA3014314, 0x4E0811A1, 0xF7537E82, 0xBD3AF235, 0x2AD7D2BB, 0xEB86D391,
+    };
+
+    constexpr u32 ROTATIONS[64] = {
+        7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+        5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
+        4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+        6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21,
+    };
+
+    inline u32 rotateLeft(u32 value, u32 amount)
+    {
+        return (value << amount) | (value >> (32 - amount));
+    }
+
+    inline u32 readLittleEndian32(const u8* data)
+    {
+        return data[0] | (data[1] << 8) | (data[2] << 16) | ((u32) data[3] << 24);
+    }
+}
+
+Md5::Md5() : state { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476 }, totalSize(0), block {}, blockSize(0)
+{
+}
+
+void Md5::update(const u8* data, size_t size)
+{
+    totalSize += size;
+
+    if (blockSize > 0)
+    {
+        size_t toCopy = std::min(size, sizeof(block) - blockSize);
+        memcpy(block + blockSize, data, toCopy);
+        blockSize += toCopy;
+        data += toCopy;
+        size -= toCopy;
+
+        if (blockSize < sizeof(block))
+            return;
+
+        processBlock(block);
+        blockSize = 0;
+    }
+
+    while (size >= sizeof(block))
+    {
+        processBlock(data);
+        data += sizeof(block);
+        size -= sizeof(block);
+    }
+
+    if (size > 0)
+    {
+        memcpy(block, data, size);
+        blockSize = size;
+    }
+}
+
+void Md5::finish(u8 (&digest)[DIGEST_SIZE])
+{
+    u64 totalBits = totalSize * 8;
+
+    u8 padding[72] = { 0x80 };
+    size_t paddingSize = (blockSize < 56 ? 56 : 120) - blockSize;
+    for (int i = 0; i < 8; i++)
+        padding[paddingSize + i] = (u8) (totalBits >> (i * 8));
+
+    update(padding, paddingSize + 8);
+
+    for (int i = 0; i < 4; i++)
+    {
+        digest[i * 4 + 0] = (u8) (state[i]);
+        digest[i * 4 + 1] = (u8) (state[i] >> 8);
+        digest[i * 4 + 2] = (u8) (state[i] >> 16);
+        digest[i * 4 + 3] = (u8) (state[i] >> 24);
+    }
+}
+
+void Md5::processBlock(const u8* data)
+{
+    u32 words[16];
+    for (int i = 0; i < 16; i++)
+        words[i] = readLittleEndian32(data + i * 4);
+
+    u32 a = state[0];
+    u32 b = state[1];
+    u32 c = state[2];
+    u32 d = state[3];
+
+    for (int i = 0; i < 64; i++)
+    {
+        u32 f;
+        int wordIndex;
+        if (i < 16)
+        {
+            f = (b & c) | (~b & d);
+            wordIndex = i;
+        }
+        else if (i < 32)
+        {
+            f = (d & b) | (~d & c);
+            wordIndex = (5 * i + 1) & 15;
+        }
+        else if (i < 48)
+        {
+            f = b ^ c ^ d;
+            wordIndex = (3 * i + 5) & 15;
+        }
+        else
+        {
+            f = c ^ (b | ~d);
+            wordIndex = (7 * i) & 15;
+        }
+
+        u32 rotated = rotateLeft(a + f + ROUND_CONSTANTS[i] + words[wordIndex], ROTATIONS[i]);
+        a = d;
+        d = c;
+        c = b;
+        b += rotated;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+}
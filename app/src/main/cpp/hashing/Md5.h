@@ -0,0 +1,30 @@
+#ifndef MELONDS_ANDROID_MD5_H
+#define MELONDS_ANDROID_MD5_H
+
+#include <cstddef>
+#include "types.h"
+
+/**
+ * Incremental MD5 (RFC 1321). Used for RetroAchievements hashes, so data can be hashed while it is being read instead of being gathered in a
+ * single buffer first.
+ */
+class Md5
+{
+public:
+    static constexpr size_t DIGEST_SIZE = 16;
+
+    Md5();
+
+    void update(const melonDS::u8* data, size_t size);
+    void finish(melonDS::u8 (&digest)[DIGEST_SIZE]);
+
+private:
+    melonDS::u32 state[4];
+    melonDS::u64 totalSize;
+    melonDS::u8 block[64];
+    size_t blockSize;
+
+    void processBlock(const melonDS::u8* data);
+};
+
+#endif //MELONDS_ANDROID_MD5_H
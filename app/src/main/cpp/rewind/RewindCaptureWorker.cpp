@@ -0,0 +1,156 @@
+#include "RewindCaptureWorker.h"
+#include <chrono>
+#include <pthread.h>
+
+using namespace melonDS;
+
+RewindCaptureWorker::RewindCaptureWorker(RewindHistory& history) : history(history)
+{
+    for (Capture& capture : capturePool)
+        freeCaptures.push_back(&capture);
+}
+
+RewindCaptureWorker::~RewindCaptureWorker()
+{
+    stop();
+}
+
+void RewindCaptureWorker::start()
+{
+    std::lock_guard<std::mutex> lock(workerMutex);
+    if (running)
+        return;
+
+    running = true;
+    workerThread = std::thread(&RewindCaptureWorker::run, this);
+    pthread_setname_np(workerThread.native_handle(), "RewindCapture");
+}
+
+void RewindCaptureWorker::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(workerMutex);
+        if (!running)
+            return;
+
+        running = false;
+        while (!pendingCaptures.empty())
+        {
+            freeCaptures.push_back(pendingCaptures.front());
+            pendingCaptures.pop_front();
+        }
+    }
+
+    workerCondition.notify_all();
+    workerThread.join();
+
+    // Release the pooled buffers. They will grow again on the next session
+    std::lock_guard<std::mutex> lock(workerMutex);
+    for (Capture& capture : capturePool)
+    {
+        std::vector<u8>().swap(capture.state);
+        std::vector<u8>().swap(capture.screenshot);
+    }
+    latestSubmittedFrame = -1;
+    stats = {};
+}
+
+bool RewindCaptureWorker::submit(int frame, const u8* state, u32 stateSize, u32 stateBufferSize, const u8* screenshot, u32 screenshotSize)
+{
+    auto snapshotStart = std::chrono::steady_clock::now();
+
+    Capture* capture;
+    {
+        std::lock_guard<std::mutex> lock(workerMutex);
+        if (!running || freeCaptures.empty())
+        {
+            // Still mark the frame as handled so that the same capture is not submitted again on the next frame
+            latestSubmittedFrame = frame;
+            stats.droppedCount++;
+            return false;
+        }
+
+        capture = freeCaptures.back();
+        freeCaptures.pop_back();
+    }
+
+    // The buffers keep their capacity between captures, so this is usually just a copy
+    capture->frame = frame;
+    capture->stateSize = stateSize;
+    capture->stateBufferSize = stateBufferSize;
+    capture->state.assign(state, state + stateSize);
+    capture->hasScreenshot = screenshot != nullptr;
+    if (capture->hasScreenshot)
+        capture->screenshot.assign(screenshot, screenshot + screenshotSize);
+
+    auto snapshotDuration = std::chrono::steady_clock::now() - snapshotStart;
+
+    {
+        std::lock_guard<std::mutex> lock(workerMutex);
+        pendingCaptures.push_back(capture);
+        latestSubmittedFrame = frame;
+        stats.submittedCount++;
+        stats.totalSnapshotTimeNs += std::chrono::duration_cast<std::chrono::nanoseconds>(snapshotDuration).count();
+    }
+
+    workerCondition.notify_all();
+    return true;
+}
+
+void RewindCaptureWorker::waitUntilIdle()
+{
+    std::unique_lock<std::mutex> lock(workerMutex);
+    workerCondition.wait(lock, [this] { return !running || (pendingCaptures.empty() && !processing); });
+}
+
+void RewindCaptureWorker::discardPending()
+{
+    std::unique_lock<std::mutex> lock(workerMutex);
+    while (!pendingCaptures.empty())
+    {
+        freeCaptures.push_back(pendingCaptures.front());
+        pendingCaptures.pop_front();
+    }
+
+    latestSubmittedFrame = -1;
+    workerCondition.wait(lock, [this] { return !processing; });
+}
+
+int RewindCaptureWorker::getLatestSubmittedFrame()
+{
+    std::lock_guard<std::mutex> lock(workerMutex);
+    return latestSubmittedFrame;
+}
+
+RewindCaptureWorker::Stats RewindCaptureWorker::getStats()
+{
+    std::lock_guard<std::mutex> lock(workerMutex);
+    return stats;
+}
+
+void RewindCaptureWorker::run()
+{
+    std::unique_lock<std::mutex> lock(workerMutex);
+    for (;;)
+    {
+        workerCondition.wait(lock, [this] { return !running || !pendingCaptures.empty(); });
+        if (!running)
+            break;
+
+        Capture* capture = pendingCaptures.front();
+        pendingCaptures.pop_front();
+        processing = true;
+        lock.unlock();
+
+        const u8* screenshot = capture->hasScreenshot ? capture->screenshot.data() : nullptr;
+        history.pushState(capture->frame, capture->state.data(), capture->stateSize, capture->stateBufferSize, screenshot, capture->screenshot.size());
+
+        lock.lock();
+        processing = false;
+        freeCaptures.push_back(capture);
+        workerCondition.notify_all();
+    }
+
+    processing = false;
+    workerCondition.notify_all();
+}
@@ -0,0 +1,85 @@
+#ifndef MELONDS_ANDROID_REWINDCAPTUREWORKER_H
+#define MELONDS_ANDROID_REWINDCAPTUREWORKER_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "RewindHistory.h"
+
+/**
+ * Moves the expensive part of rewind captures (delta encoding, compression and thumbnail generation) off the emulator thread. Submitting a capture
+ * only copies the state and screenshot into one of a small number of pooled buffers. If every buffer is still waiting to be processed, the capture
+ * is dropped instead of blocking emulation.
+ */
+class RewindCaptureWorker
+{
+public:
+    struct Stats
+    {
+        melonDS::u32 submittedCount;
+        melonDS::u32 droppedCount;
+        melonDS::u64 totalSnapshotTimeNs;
+    };
+
+    explicit RewindCaptureWorker(RewindHistory& history);
+    ~RewindCaptureWorker();
+
+    void start();
+    void stop();
+
+    /**
+     * Queues a capture for insertion into the history. Must only be called from the emulator thread.
+     *
+     * @return False if the capture was dropped because the worker is falling behind
+     */
+    bool submit(int frame, const melonDS::u8* state, melonDS::u32 stateSize, melonDS::u32 stateBufferSize, const melonDS::u8* screenshot, melonDS::u32 screenshotSize);
+
+    /**
+     * Blocks until all queued captures have been inserted into the history.
+     */
+    void waitUntilIdle();
+
+    /**
+     * Discards all queued captures and waits for the one being processed, if any. After this call the history is not modified until a new capture
+     * is submitted.
+     */
+    void discardPending();
+
+    /**
+     * Frame of the newest capture that was submitted or dropped since the last call to discardPending(), or -1 if there is none.
+     */
+    int getLatestSubmittedFrame();
+    Stats getStats();
+
+private:
+    static constexpr size_t CAPTURE_POOL_SIZE = 2;
+
+    struct Capture
+    {
+        int frame;
+        melonDS::u32 stateSize;
+        melonDS::u32 stateBufferSize;
+        bool hasScreenshot;
+        std::vector<melonDS::u8> state;
+        std::vector<melonDS::u8> screenshot;
+    };
+
+    RewindHistory& history;
+    std::thread workerThread;
+    std::mutex workerMutex;
+    std::condition_variable workerCondition;
+    bool running = false;
+    bool processing = false;
+    int latestSubmittedFrame = -1;
+
+    Capture capturePool[CAPTURE_POOL_SIZE];
+    std::vector<Capture*> freeCaptures;
+    std::deque<Capture*> pendingCaptures;
+    Stats stats = {};
+
+    void run();
+};
+
+#endif //MELONDS_ANDROID_REWINDCAPTUREWORKER_H
@@ -0,0 +1,356 @@
+#include "RewindHistory.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include "RewindThumbnail.h"
+#include "../compression/LzCodec.h"
+
+using namespace melonDS;
+
+void RewindHistory::setMaxStates(u32 newMaxStates)
+{
+    std::lock_guard<std::mutex> lock(historyMutex);
+    if (newMaxStates == maxStates)
+        return;
+
+    maxStates = newMaxStates;
+    clearLocked();
+    releaseThumbnailPoolLocked();
+    generation++;
+}
+
+void RewindHistory::setThumbnailScale(u32 newThumbnailScale)
+{
+    std::lock_guard<std::mutex> lock(historyMutex);
+    if (!RewindThumbnail::isValidScale(newThumbnailScale))
+        newThumbnailScale = DEFAULT_THUMBNAIL_SCALE;
+
+    if (newThumbnailScale == thumbnailScale)
+        return;
+
+    thumbnailScale = newThumbnailScale;
+    clearLocked();
+    releaseThumbnailPoolLocked();
+    generation++;
+}
+
+void RewindHistory::pushState(int frame, const u8* state, u32 stateSize, u32 stateBufferSize, const u8* screenshot, u32 screenshotSize)
+{
+    std::lock_guard<std::mutex> lock(historyMutex);
+    if (maxStates == 0)
+        return;
+
+    auto captureStart = std::chrono::steady_clock::now();
+
+    // Whole keyframe groups are evicted at once, so that no state has to be re-encoded as a keyframe. The oldest group is only dropped once the
+    // history would still hold maxStates states without it
+    size_t oldestGroupSize = 1;
+    while (oldestGroupSize < entries.size() && !entries[oldestGroupSize].isKeyframe)
+        oldestGroupSize++;
+
+    if (!entries.empty() && entries.size() - oldestGroupSize + 1 >= maxStates)
+        evictOldestKeyframeGroup();
+
+    Entry entry = {
+        .frame = frame,
+        .isKeyframe = entries.empty() || statesSinceKeyframe + 1 >= KEYFRAME_INTERVAL,
+        .stateSize = stateSize,
+        .stateBufferSize = stateBufferSize,
+        .thumbnailSlot = NO_THUMBNAIL,
+    };
+
+    if (entry.isKeyframe)
+    {
+        compressInto(state, stateSize, entry.data);
+        statesSinceKeyframe = 0;
+    }
+    else
+    {
+        deltaBuffer.resize(stateSize);
+        u32 commonSize = std::min<u32>(stateSize, latestState.size());
+        for (u32 i = 0; i < commonSize; i++)
+            deltaBuffer[i] = state[i] ^ latestState[i];
+
+        // Bytes past the end of the previous state are XORed against zero
+        if (stateSize > commonSize)
+            memcpy(deltaBuffer.data() + commonSize, state + commonSize, stateSize - commonSize);
+
+        compressInto(deltaBuffer.data(), stateSize, entry.data);
+        statesSinceKeyframe++;
+    }
+
+    if (screenshot != nullptr && screenshotSize >= RewindThumbnail::SCREENSHOT_SIZE)
+    {
+        entry.thumbnailSlot = allocateThumbnailSlot();
+        u16* thumbnail = thumbnailPool.data() + entry.thumbnailSlot * getThumbnailPixelCount();
+        RewindThumbnail::downscale(screenshot, thumbnailScale, thumbnail);
+    }
+
+    latestState.assign(state, state + stateSize);
+
+    stats.uncompressedSize += stateSize;
+    stats.storedSize += entry.data.size();
+    if (entry.thumbnailSlot != NO_THUMBNAIL)
+    {
+        stats.uncompressedSize += RewindThumbnail::SCREENSHOT_SIZE;
+        stats.storedSize += RewindThumbnail::getSize(thumbnailScale);
+    }
+    entries.push_back(std::move(entry));
+    generation++;
+
+    auto captureDuration = std::chrono::steady_clock::now() - captureStart;
+    stats.captureCount++;
+    stats.totalCaptureTimeNs += std::chrono::duration_cast<std::chrono::nanoseconds>(captureDuration).count();
+}
+
+bool RewindHistory::rewindToState(int frame, std::vector<u8>& stateOutput, u32& stateContentSize, std::vector<u8>& screenshotOutput)
+{
+    std::lock_guard<std::mutex> lock(historyMutex);
+
+    auto restoreStart = std::chrono::steady_clock::now();
+
+    size_t index = entries.size();
+    for (size_t i = entries.size(); i > 0; i--)
+    {
+        if (entries[i - 1].frame == frame)
+        {
+            index = i - 1;
+            break;
+        }
+    }
+
+    if (index == entries.size())
+        return false;
+
+    // The restored state becomes the newest one, so it is decoded straight into the delta reference
+    if (!decodeState(index, latestState))
+    {
+        clearLocked();
+        return false;
+    }
+
+    while (entries.size() > index + 1)
+    {
+        removeEntryStats(entries.back());
+        entries.pop_back();
+    }
+
+    statesSinceKeyframe = 0;
+    for (size_t i = entries.size() - 1; i > 0 && !entries[i].isKeyframe; i--)
+        statesSinceKeyframe++;
+
+    const Entry& restoredEntry = entries.back();
+    stateContentSize = restoredEntry.stateSize;
+    stateOutput.assign(latestState.begin(), latestState.end());
+    stateOutput.resize(std::max(restoredEntry.stateBufferSize, restoredEntry.stateSize));
+    if (restoredEntry.thumbnailSlot != NO_THUMBNAIL)
+    {
+        screenshotOutput.resize(RewindThumbnail::SCREENSHOT_SIZE);
+        const u16* thumbnail = thumbnailPool.data() + restoredEntry.thumbnailSlot * getThumbnailPixelCount();
+        RewindThumbnail::upscale(thumbnail, thumbnailScale, screenshotOutput.data());
+    }
+    else
+    {
+        screenshotOutput.clear();
+    }
+    generation++;
+
+    auto restoreDuration = std::chrono::steady_clock::now() - restoreStart;
+    stats.restoreCount++;
+    stats.totalRestoreTimeNs += std::chrono::duration_cast<std::chrono::nanoseconds>(restoreDuration).count();
+    return true;
+}
+
+size_t RewindHistory::getDescriptorTableSize(u32 descriptorCount)
+{
+    return sizeof(DescriptorTableHeader) + descriptorCount * sizeof(StateDescriptor);
+}
+
+void RewindHistory::writeDescriptorTable(u8* table, u32 maxDescriptors, int currentFrame)
+{
+    std::lock_guard<std::mutex> lock(historyMutex);
+
+    u32 descriptorCount = std::min<u32>(entries.size(), maxDescriptors);
+    DescriptorTableHeader header = {
+        .generation = generation,
+        .currentFrame = currentFrame,
+        .stateCount = descriptorCount,
+        .descriptorSize = sizeof(StateDescriptor),
+        .thumbnailWidth = RewindThumbnail::getWidth(thumbnailScale),
+        .thumbnailHeight = RewindThumbnail::getHeight(thumbnailScale),
+    };
+    memcpy(table, &header, sizeof(header));
+
+    u8* descriptorPosition = table + sizeof(header);
+    auto it = entries.rbegin();
+    for (u32 i = 0; i < descriptorCount; i++, it++)
+    {
+        StateDescriptor descriptor = {
+            .frame = it->frame,
+            .flags = it->isKeyframe ? STATE_FLAG_KEYFRAME : 0,
+            .stateSize = it->stateSize,
+            .storedSize = (u32) it->data.size(),
+        };
+        memcpy(descriptorPosition, &descriptor, sizeof(descriptor));
+        descriptorPosition += sizeof(descriptor);
+    }
+}
+
+bool RewindHistory::copyThumbnail(int frame, u8* output, size_t outputSize)
+{
+    std::lock_guard<std::mutex> lock(historyMutex);
+
+    u32 thumbnailSize = RewindThumbnail::getSize(thumbnailScale);
+    for (auto it = entries.rbegin(); it != entries.rend(); it++)
+    {
+        if (it->frame != frame)
+            continue;
+
+        if (it->thumbnailSlot == NO_THUMBNAIL || thumbnailSize > outputSize)
+            return false;
+
+        memcpy(output, thumbnailPool.data() + it->thumbnailSlot * getThumbnailPixelCount(), thumbnailSize);
+        return true;
+    }
+
+    return false;
+}
+
+u32 RewindHistory::getMaxStates()
+{
+    std::lock_guard<std::mutex> lock(historyMutex);
+    return maxStates;
+}
+
+int RewindHistory::getLatestFrame()
+{
+    std::lock_guard<std::mutex> lock(historyMutex);
+    return entries.empty() ? -1 : entries.back().frame;
+}
+
+RewindHistory::Stats RewindHistory::getStats()
+{
+    std::lock_guard<std::mutex> lock(historyMutex);
+
+    Stats currentStats = stats;
+    currentStats.stateCount = entries.size();
+    currentStats.thumbnailWidth = RewindThumbnail::getWidth(thumbnailScale);
+    currentStats.thumbnailHeight = RewindThumbnail::getHeight(thumbnailScale);
+    currentStats.thumbnailPoolSize = thumbnailPool.size() * sizeof(u16);
+    return currentStats;
+}
+
+void RewindHistory::clear()
+{
+    std::lock_guard<std::mutex> lock(historyMutex);
+    clearLocked();
+    generation++;
+}
+
+void RewindHistory::evictOldestKeyframeGroup()
+{
+    // Deltas only refer to states in their own group, so the states after the group stay decodable
+    do
+    {
+        removeEntryStats(entries.front());
+        entries.pop_front();
+    }
+    while (!entries.empty() && !entries.front().isKeyframe);
+}
+
+void RewindHistory::removeEntryStats(const Entry& entry)
+{
+    stats.uncompressedSize -= entry.stateSize;
+    stats.storedSize -= entry.data.size();
+    if (entry.thumbnailSlot != NO_THUMBNAIL)
+    {
+        stats.uncompressedSize -= RewindThumbnail::SCREENSHOT_SIZE;
+        stats.storedSize -= RewindThumbnail::getSize(thumbnailScale);
+        freeThumbnailSlots.push_back(entry.thumbnailSlot);
+    }
+}
+
+u32 RewindHistory::allocateThumbnailSlot()
+{
+    if (thumbnailPool.empty())
+        thumbnailPool.resize((size_t) getMaxEntryCount() * getThumbnailPixelCount());
+
+    if (!freeThumbnailSlots.empty())
+    {
+        u32 slot = freeThumbnailSlots.back();
+        freeThumbnailSlots.pop_back();
+        return slot;
+    }
+
+    // There are never more entries than getMaxEntryCount(), so there is always a slot available
+    return usedThumbnailSlots++;
+}
+
+u32 RewindHistory::getMaxEntryCount() const
+{
+    return maxStates + KEYFRAME_INTERVAL - 1;
+}
+
+u32 RewindHistory::getThumbnailPixelCount() const
+{
+    return RewindThumbnail::getWidth(thumbnailScale) * RewindThumbnail::getHeight(thumbnailScale);
+}
+
+void RewindHistory::compressInto(const u8* data, u32 size, std::vector<u8>& output)
+{
+    compressionBuffer.resize(LzCodec::getMaxCompressedSize(size));
+    size_t compressedSize = LzCodec::compress(data, size, compressionBuffer.data(), compressionBuffer.size());
+
+    // Copy into an exactly sized buffer so that no memory is wasted on the compression bound
+    output.assign(compressionBuffer.begin(), compressionBuffer.begin() + compressedSize);
+}
+
+bool RewindHistory::decodeState(size_t index, std::vector<u8>& output)
+{
+    // The oldest entry is always a keyframe
+    size_t keyframeIndex = index;
+    while (keyframeIndex > 0 && !entries[keyframeIndex].isKeyframe)
+        keyframeIndex--;
+
+    const Entry& keyframe = entries[keyframeIndex];
+    output.resize(keyframe.stateSize);
+    if (!LzCodec::decompress(keyframe.data.data(), keyframe.data.size(), output.data(), keyframe.stateSize))
+        return false;
+
+    for (size_t i = keyframeIndex + 1; i <= index; i++)
+    {
+        const Entry& deltaEntry = entries[i];
+        deltaBuffer.resize(deltaEntry.stateSize);
+        if (!LzCodec::decompress(deltaEntry.data.data(), deltaEntry.data.size(), deltaBuffer.data(), deltaEntry.stateSize))
+            return false;
+
+        applyDelta(output, deltaBuffer.data(), deltaEntry.stateSize);
+    }
+
+    return true;
+}
+
+void RewindHistory::applyDelta(std::vector<u8>& state, const u8* delta, u32 deltaSize)
+{
+    // Growing the state zero-fills the new bytes, which matches how deltas are created
+    state.resize(deltaSize);
+
+    u8* stateData = state.data();
+    for (u32 i = 0; i < deltaSize; i++)
+        stateData[i] ^= delta[i];
+}
+
+void RewindHistory::clearLocked()
+{
+    entries.clear();
+    freeThumbnailSlots.clear();
+    usedThumbnailSlots = 0;
+    std::vector<u8>().swap(latestState);
+    statesSinceKeyframe = 0;
+    stats = {};
+}
+
+void RewindHistory::releaseThumbnailPoolLocked()
+{
+    std::vector<u16>().swap(thumbnailPool);
+}
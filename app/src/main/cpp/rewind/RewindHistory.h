@@ -0,0 +1,136 @@
+#ifndef MELONDS_ANDROID_REWINDHISTORY_H
+#define MELONDS_ANDROID_REWINDHISTORY_H
+
+#include <deque>
+#include <mutex>
+#include <vector>
+#include "types.h"
+
+/**
+ * Compressed storage for rewind states. States are stored as periodic keyframes followed by XOR deltas against the previous state, with both
+ * keyframes and deltas compressed with LzCodec. States are only decompressed when rewinding to them.
+ *
+ * Screenshots are not kept at full size. Each state only keeps an RGB565 thumbnail, stored in a pool that is allocated once for the whole history.
+ */
+class RewindHistory
+{
+public:
+    struct Stats
+    {
+        melonDS::u32 stateCount;
+        melonDS::u64 uncompressedSize;
+        melonDS::u64 storedSize;
+        melonDS::u32 thumbnailWidth;
+        melonDS::u32 thumbnailHeight;
+        melonDS::u64 thumbnailPoolSize;
+        melonDS::u32 captureCount;
+        melonDS::u64 totalCaptureTimeNs;
+        melonDS::u32 restoreCount;
+        melonDS::u64 totalRestoreTimeNs;
+    };
+
+    /**
+     * Layout of the descriptor table that describes the rewind window to Kotlin (see RewindWindow.kt). The header is followed by one descriptor
+     * per state, from newest to oldest. All fields are 32-bit values in native byte order.
+     */
+    struct DescriptorTableHeader
+    {
+        melonDS::u32 generation;
+        melonDS::s32 currentFrame;
+        melonDS::u32 stateCount;
+        melonDS::u32 descriptorSize;
+        melonDS::u32 thumbnailWidth;
+        melonDS::u32 thumbnailHeight;
+    };
+
+    struct StateDescriptor
+    {
+        melonDS::s32 frame;
+        melonDS::u32 flags;
+        melonDS::u32 stateSize;
+        melonDS::u32 storedSize;
+    };
+
+    static constexpr melonDS::u32 STATE_FLAG_KEYFRAME = 1 << 0;
+    static constexpr melonDS::u32 NO_THUMBNAIL = 0xFFFFFFFF;
+    static constexpr melonDS::u32 DEFAULT_THUMBNAIL_SCALE = 2;
+
+    static size_t getDescriptorTableSize(melonDS::u32 descriptorCount);
+
+    /**
+     * Updates the maximum number of states kept in the history. The history is cleared if the value changes.
+     */
+    void setMaxStates(melonDS::u32 maxStates);
+    /**
+     * Updates the factor by which screenshots are downscaled to create thumbnails. Must be a power of 2. The history is cleared if the value
+     * changes.
+     */
+    void setThumbnailScale(melonDS::u32 thumbnailScale);
+    void pushState(int frame, const melonDS::u8* state, melonDS::u32 stateSize, melonDS::u32 stateBufferSize, const melonDS::u8* screenshot, melonDS::u32 screenshotSize);
+
+    /**
+     * Decompresses the state captured at the given frame and discards all states captured after it.
+     *
+     * @param stateOutput Receives the state buffer. It is resized to the buffer size of the captured state
+     * @param stateContentSize Receives the size of the actual state data inside the buffer
+     * @param screenshotOutput Receives the screenshot associated with the state, upscaled from its thumbnail
+     * @return True if the state was found and successfully decompressed
+     */
+    bool rewindToState(int frame, std::vector<melonDS::u8>& stateOutput, melonDS::u32& stateContentSize, std::vector<melonDS::u8>& screenshotOutput);
+    /**
+     * Writes the descriptor table for the current history into the given buffer. Only the newest maxDescriptors states are described.
+     */
+    void writeDescriptorTable(melonDS::u8* table, melonDS::u32 maxDescriptors, int currentFrame);
+    bool copyThumbnail(int frame, melonDS::u8* output, size_t outputSize);
+    melonDS::u32 getMaxStates();
+    int getLatestFrame();
+    Stats getStats();
+    void clear();
+
+private:
+    static constexpr melonDS::u32 KEYFRAME_INTERVAL = 10;
+
+    struct Entry
+    {
+        int frame;
+        bool isKeyframe;
+        melonDS::u32 stateSize;
+        melonDS::u32 stateBufferSize;
+        std::vector<melonDS::u8> data;
+        melonDS::u32 thumbnailSlot;
+    };
+
+    std::mutex historyMutex;
+    std::deque<Entry> entries;
+    melonDS::u32 maxStates = 0;
+    melonDS::u32 statesSinceKeyframe = 0;
+    // Incremented whenever the set of stored states changes
+    melonDS::u32 generation = 0;
+    // Uncompressed contents of the newest state. Used as the reference for the next delta
+    std::vector<melonDS::u8> latestState;
+    std::vector<melonDS::u8> deltaBuffer;
+    std::vector<melonDS::u8> compressionBuffer;
+    melonDS::u32 thumbnailScale = DEFAULT_THUMBNAIL_SCALE;
+    // One thumbnail slot per state. Only allocated once the first state is captured
+    std::vector<melonDS::u16> thumbnailPool;
+    std::vector<melonDS::u32> freeThumbnailSlots;
+    melonDS::u32 usedThumbnailSlots = 0;
+    Stats stats = {};
+
+    void evictOldestKeyframeGroup();
+    void removeEntryStats(const Entry& entry);
+    melonDS::u32 allocateThumbnailSlot();
+    /**
+     * Returns the maximum number of states stored at once. Since whole keyframe groups are evicted, up to KEYFRAME_INTERVAL - 1 states more
+     * than maxStates can be kept.
+     */
+    melonDS::u32 getMaxEntryCount() const;
+    melonDS::u32 getThumbnailPixelCount() const;
+    void compressInto(const melonDS::u8* data, melonDS::u32 size, std::vector<melonDS::u8>& output);
+    bool decodeState(size_t index, std::vector<melonDS::u8>& output);
+    static void applyDelta(std::vector<melonDS::u8>& state, const melonDS::u8* delta, melonDS::u32 deltaSize);
+    void clearLocked();
+    void releaseThumbnailPoolLocked();
+};
+
+#endif //MELONDS_ANDROID_REWINDHISTORY_H
@@ -0,0 +1,157 @@
+#include "RewindThumbnail.h"
+#include <cstring>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+using namespace melonDS;
+
+namespace
+{
+    inline u16 toRgb565(u32 r, u32 g, u32 b)
+    {
+        return (u16) (((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+    }
+
+    inline u32 log2(u32 value)
+    {
+        u32 result = 0;
+        while (value > 1)
+        {
+            value >>= 1;
+            result++;
+        }
+        return result;
+    }
+
+    /**
+     * Generic box filter. Channels are accumulated in pairs inside 16-bit lanes of a 32-bit integer (B and R in one, G and A in the other), which
+     * is enough to hold the sum of MAX_SCALE * MAX_SCALE pixels.
+     */
+    void downscaleBox(const u8* screenshot, u32 scale, u16* thumbnail)
+    {
+        u32 width = RewindThumbnail::getWidth(scale);
+        u32 height = RewindThumbnail::getHeight(scale);
+        u32 shift = log2(scale * scale);
+
+        for (u32 ty = 0; ty < height; ty++)
+        {
+            const u8* blockRow = screenshot + ty * scale * RewindThumbnail::SCREENSHOT_WIDTH * 4;
+            for (u32 tx = 0; tx < width; tx++)
+            {
+                u32 blueRed = 0;
+                u32 greenAlpha = 0;
+                for (u32 y = 0; y < scale; y++)
+                {
+                    const u8* row = blockRow + (y * RewindThumbnail::SCREENSHOT_WIDTH + tx * scale) * 4;
+                    for (u32 x = 0; x < scale; x++)
+                    {
+                        u32 pixel;
+                        memcpy(&pixel, row + x * 4, sizeof(pixel));
+                        blueRed += pixel & 0x00FF00FF;
+                        greenAlpha += (pixel >> 8) & 0x00FF00FF;
+                    }
+                }
+
+                u32 b = (blueRed & 0xFFFF) >> shift;
+                u32 r = (blueRed >> 16) >> shift;
+                u32 g = (greenAlpha & 0xFFFF) >> shift;
+                *thumbnail++ = toRgb565(r, g, b);
+            }
+        }
+    }
+
+#if defined(__ARM_NEON)
+    /**
+     * 2x2 box filter for the default thumbnail size. Produces 4 thumbnail pixels per iteration from 8 pixels of 2 consecutive rows.
+     */
+    void downscaleBox2xNeon(const u8* screenshot, u16* thumbnail)
+    {
+        u32 height = RewindThumbnail::getHeight(2);
+        u32 rowStride = RewindThumbnail::SCREENSHOT_WIDTH * 4;
+
+        for (u32 ty = 0; ty < height; ty++)
+        {
+            const u8* topRow = screenshot + ty * 2 * rowStride;
+            const u8* bottomRow = topRow + rowStride;
+
+            for (u32 x = 0; x < RewindThumbnail::SCREENSHOT_WIDTH; x += 8)
+            {
+                uint8x8x4_t top = vld4_u8(topRow + x * 4);
+                uint8x8x4_t bottom = vld4_u8(bottomRow + x * 4);
+
+                uint16x8_t blueColumns = vaddl_u8(top.val[0], bottom.val[0]);
+                uint16x8_t greenColumns = vaddl_u8(top.val[1], bottom.val[1]);
+                uint16x8_t redColumns = vaddl_u8(top.val[2], bottom.val[2]);
+
+                // Sum of adjacent columns, divided by 4 and reduced to 5/6/5 bits in a single shift
+                uint16x4_t blue = vshr_n_u16(vpadd_u16(vget_low_u16(blueColumns), vget_high_u16(blueColumns)), 5);
+                uint16x4_t green = vshr_n_u16(vpadd_u16(vget_low_u16(greenColumns), vget_high_u16(greenColumns)), 4);
+                uint16x4_t red = vshr_n_u16(vpadd_u16(vget_low_u16(redColumns), vget_high_u16(redColumns)), 5);
+
+                uint16x4_t pixels = vorr_u16(vorr_u16(vshl_n_u16(red, 11), vshl_n_u16(green, 5)), blue);
+                vst1_u16(thumbnail, pixels);
+                thumbnail += 4;
+            }
+        }
+    }
+#endif
+}
+
+bool RewindThumbnail::isValidScale(u32 scale)
+{
+    return scale >= 1 && scale <= MAX_SCALE && (scale & (scale - 1)) == 0;
+}
+
+u32 RewindThumbnail::getWidth(u32 scale)
+{
+    return SCREENSHOT_WIDTH / scale;
+}
+
+u32 RewindThumbnail::getHeight(u32 scale)
+{
+    return SCREENSHOT_HEIGHT / scale;
+}
+
+u32 RewindThumbnail::getSize(u32 scale)
+{
+    return getWidth(scale) * getHeight(scale) * sizeof(u16);
+}
+
+void RewindThumbnail::downscale(const u8* screenshot, u32 scale, u16* thumbnail)
+{
+#if defined(__ARM_NEON)
+    if (scale == 2)
+    {
+        downscaleBox2xNeon(screenshot, thumbnail);
+        return;
+    }
+#endif
+
+    downscaleBox(screenshot, scale, thumbnail);
+}
+
+void RewindThumbnail::upscale(const u16* thumbnail, u32 scale, u8* screenshot)
+{
+    u32 width = getWidth(scale);
+
+    for (u32 y = 0; y < SCREENSHOT_HEIGHT; y++)
+    {
+        const u16* thumbnailRow = thumbnail + (y / scale) * width;
+        u8* screenshotRow = screenshot + y * SCREENSHOT_WIDTH * 4;
+        for (u32 x = 0; x < SCREENSHOT_WIDTH; x++)
+        {
+            u16 pixel = thumbnailRow[x / scale];
+            u32 r = (pixel >> 11) & 0x1F;
+            u32 g = (pixel >> 5) & 0x3F;
+            u32 b = pixel & 0x1F;
+
+            u8* output = screenshotRow + x * 4;
+            output[0] = (u8) ((b << 3) | (b >> 2));
+            output[1] = (u8) ((g << 2) | (g >> 4));
+            output[2] = (u8) ((r << 3) | (r >> 2));
+            output[3] = 0xFF;
+        }
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef MELONDS_ANDROID_REWINDTHUMBNAIL_H
+#define MELONDS_ANDROID_REWINDTHUMBNAIL_H
+
+#include "types.h"
+
+/**
+ * Conversion between full size screenshots (both screens, BGRA) and the RGB565 thumbnails kept in the rewind history. Thumbnails are created with
+ * a box filter, so the scale must be a power of 2.
+ */
+namespace RewindThumbnail
+{
+    constexpr melonDS::u32 SCREENSHOT_WIDTH = 256;
+    constexpr melonDS::u32 SCREENSHOT_HEIGHT = 384;
+    constexpr melonDS::u32 SCREENSHOT_SIZE = SCREENSHOT_WIDTH * SCREENSHOT_HEIGHT * 4;
+    constexpr melonDS::u32 MAX_SCALE = 8;
+
+    bool isValidScale(melonDS::u32 scale);
+    melonDS::u32 getWidth(melonDS::u32 scale);
+    melonDS::u32 getHeight(melonDS::u32 scale);
+    melonDS::u32 getSize(melonDS::u32 scale);
+
+    void downscale(const melonDS::u8* screenshot, melonDS::u32 scale, melonDS::u16* thumbnail);
+
+    /**
+     * Expands a thumbnail back to a full size BGRA screenshot using nearest neighbour sampling.
+     */
+    void upscale(const melonDS::u16* thumbnail, melonDS::u32 scale, melonDS::u8* screenshot);
+}
+
+#endif //MELONDS_ANDROID_REWINDTHUMBNAIL_H
@@ -0,0 +1,193 @@
+#include "RomMetadataScanner.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <pthread.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "../hashing/Md5.h"
+
+using namespace melonDS;
+
+namespace
+{
+    // Only the part of the header that RetroAchievements hashes. The DSi category is read separately since it's past this point
+    constexpr size_t HASHED_HEADER_SIZE = 0x160;
+    constexpr size_t HEADER_SIZE = 0x238;
+    constexpr size_t BANNER_SIZE = 0xA00;
+    constexpr size_t BANNER_OFFSET_OFFSET = 0x68;
+    constexpr size_t BANNER_ENGLISH_TITLE_OFFSET = 0x340;
+    // Matches the limit applied by RetroAchievements to avoid hashing corrupted headers
+    constexpr u32 MAX_BOOT_CODE_SIZE = 16 * 1024 * 1024;
+    constexpr size_t READ_CHUNK_SIZE = 256 * 1024;
+    constexpr u32 DSIWARE_CATEGORY = 0x00030004;
+
+    inline u32 read32(const u8* data)
+    {
+        u32 value;
+        memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    /**
+     * Reads up to size bytes at the given offset, stopping early only at the end of the file.
+     *
+     * @return The number of bytes read, or -1 on error
+     */
+    ssize_t readAt(int fd, u8* buffer, size_t size, u64 offset)
+    {
+        size_t totalRead = 0;
+        while (totalRead < size)
+        {
+            ssize_t result = pread(fd, buffer + totalRead, size - totalRead, (off_t) (offset + totalRead));
+            if (result < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                return -1;
+            }
+
+            if (result == 0)
+                break;
+
+            totalRead += result;
+        }
+
+        return (ssize_t) totalRead;
+    }
+
+    /**
+     * Feeds a region of the file into the hash. Data past the end of the file is hashed as zeros.
+     */
+    bool hashRegion(int fd, u64 offset, u32 size, std::vector<u8>& buffer, Md5& md5)
+    {
+        u32 remaining = size;
+        while (remaining > 0)
+        {
+            size_t chunkSize = std::min<size_t>(remaining, buffer.size());
+            ssize_t bytesRead = readAt(fd, buffer.data(), chunkSize, offset);
+            if (bytesRead < 0)
+                return false;
+
+            memset(buffer.data() + bytesRead, 0, chunkSize - bytesRead);
+            md5.update(buffer.data(), chunkSize);
+            offset += chunkSize;
+            remaining -= chunkSize;
+        }
+
+        return true;
+    }
+
+    void scanRom(int fd, RomMetadataScanner::ScanResult& result, std::vector<u8>& readBuffer)
+    {
+        memset(&result, 0, sizeof(result));
+
+        u8 header[HEADER_SIZE] = {};
+        ssize_t headerSize = readAt(fd, header, sizeof(header), 0);
+        if (headerSize < 0)
+        {
+            result.status = RomMetadataScanner::STATUS_READ_FAILED;
+            return;
+        }
+        if ((size_t) headerSize < HASHED_HEADER_SIZE)
+        {
+            result.status = RomMetadataScanner::STATUS_INVALID_ROM;
+            return;
+        }
+
+        u32 arm9Offset = read32(header + 0x20);
+        u32 arm9Size = read32(header + 0x2C);
+        u32 arm7Offset = read32(header + 0x30);
+        u32 arm7Size = read32(header + 0x3C);
+        u32 bannerOffset = read32(header + BANNER_OFFSET_OFFSET);
+        if (arm9Size > MAX_BOOT_CODE_SIZE || arm7Size > MAX_BOOT_CODE_SIZE)
+        {
+            result.status = RomMetadataScanner::STATUS_INVALID_ROM;
+            return;
+        }
+
+        char gameCodeCategory = (char) header[0x0C];
+        bool isDsiCategory = gameCodeCategory == 'H' || gameCodeCategory == 'K';
+        if (isDsiCategory && read32(header + 0x234) == DSIWARE_CATEGORY)
+            result.flags |= RomMetadataScanner::FLAG_DSIWARE;
+
+        Md5 md5;
+        md5.update(header, HASHED_HEADER_SIZE);
+        if (!hashRegion(fd, arm9Offset, arm9Size, readBuffer, md5) || !hashRegion(fd, arm7Offset, arm7Size, readBuffer, md5))
+        {
+            result.status = RomMetadataScanner::STATUS_READ_FAILED;
+            return;
+        }
+
+        // ROMs without a banner (mostly homebrew) have a banner offset of 0. They are hashed without it, like RetroAchievements does
+        if (bannerOffset != 0)
+        {
+            u8 banner[BANNER_SIZE] = {};
+            if (readAt(fd, banner, sizeof(banner), bannerOffset) < 0)
+            {
+                result.status = RomMetadataScanner::STATUS_READ_FAILED;
+                return;
+            }
+
+            md5.update(banner, sizeof(banner));
+            result.flags |= RomMetadataScanner::FLAG_HAS_BANNER;
+            memcpy(result.bannerTitle, banner + BANNER_ENGLISH_TITLE_OFFSET, sizeof(result.bannerTitle));
+        }
+
+        md5.finish(result.retroAchievementsHash);
+        result.status = RomMetadataScanner::STATUS_OK;
+    }
+}
+
+void RomMetadataScanner::scan(const int* fds, size_t count, ScanResult* output, unsigned int maxThreads)
+{
+    if (count == 0)
+        return;
+
+    std::atomic_size_t nextIndex = 0;
+    auto worker = [&]() {
+        std::vector<u8> readBuffer(READ_CHUNK_SIZE);
+        size_t index;
+        while ((index = nextIndex.fetch_add(1)) < count)
+            scanRom(fds[index], output[index], readBuffer);
+    };
+
+    unsigned int hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    size_t threadCount = std::min<size_t>({ count, hardwareThreads, std::max(1u, maxThreads) });
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for (size_t i = 1; i < threadCount; i++)
+    {
+        threads.emplace_back([&worker]() {
+            pthread_setname_np(pthread_self(), "RomScanner");
+            worker();
+        });
+    }
+
+    worker();
+
+    for (std::thread& thread : threads)
+        thread.join();
+}
+
+bool RomMetadataScanner::readBanner(int fd, u8* banner, size_t bannerSize)
+{
+    u8 bannerOffsetData[4];
+    if (readAt(fd, bannerOffsetData, sizeof(bannerOffsetData), BANNER_OFFSET_OFFSET) != sizeof(bannerOffsetData))
+        return false;
+
+    u32 bannerOffset = read32(bannerOffsetData);
+    if (bannerOffset == 0)
+        return false;
+
+    ssize_t bytesRead = readAt(fd, banner, bannerSize, bannerOffset);
+    if (bytesRead <= 0)
+        return false;
+
+    memset(banner + bytesRead, 0, bannerSize - bytesRead);
+    return true;
+}
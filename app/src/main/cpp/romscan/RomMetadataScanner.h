@@ -0,0 +1,53 @@
+#ifndef MELONDS_ANDROID_ROMMETADATASCANNER_H
+#define MELONDS_ANDROID_ROMMETADATASCANNER_H
+
+#include <cstddef>
+#include "types.h"
+
+/**
+ * Extracts the metadata shown in the ROM list from a batch of NDS ROM files. ROMs are processed in parallel by a small pool of threads, and only
+ * the regions that are needed (header, ARM9 and ARM7 boot code, and banner) are read with pread(), so descriptors are never seeked.
+ *
+ * Results are written into a packed buffer with one ScanResult per ROM, in the same order as the descriptors. The layout must match
+ * RomScanResults.kt.
+ */
+namespace RomMetadataScanner
+{
+    constexpr melonDS::u32 STATUS_OK = 0;
+    constexpr melonDS::u32 STATUS_READ_FAILED = 1;
+    constexpr melonDS::u32 STATUS_INVALID_ROM = 2;
+
+    constexpr melonDS::u32 FLAG_DSIWARE = 1 << 0;
+    constexpr melonDS::u32 FLAG_HAS_BANNER = 1 << 1;
+
+    /**
+     * Per-ROM result. All fields are in native byte order.
+     */
+    struct ScanResult
+    {
+        melonDS::u32 status;
+        melonDS::u32 flags;
+        // MD5 of the header, ARM9 and ARM7 boot code, and banner, as computed by RetroAchievements
+        melonDS::u8 retroAchievementsHash[16];
+        // UTF-16 English title from the banner, including the developer name on its last line
+        melonDS::u16 bannerTitle[128];
+    };
+
+    static_assert(sizeof(ScanResult) == 280, "ScanResult layout changed. Update RomScanResults.kt");
+
+    /**
+     * Scans all the given descriptors, which are not closed. The output buffer must have room for count results.
+     *
+     * @param maxThreads Maximum number of threads used, including the calling thread
+     */
+    void scan(const int* fds, size_t count, ScanResult* output, unsigned int maxThreads);
+
+    /**
+     * Reads the first bannerSize bytes of the banner of the ROM behind the given descriptor. Data past the end of the file is zero-filled.
+     *
+     * @return False if the ROM has no banner or it could not be read
+     */
+    bool readBanner(int fd, melonDS::u8* banner, size_t bannerSize);
+}
+
+#endif //MELONDS_ANDROID_ROMMETADATASCANNER_H
@@ -0,0 +1,117 @@
+#include "SaveStateContainer.h"
+#include <algorithm>
+#include <cstring>
+#include "../compression/LzCodec.h"
+#include "../hashing/Crc32.h"
+
+using namespace melonDS;
+
+namespace
+{
+    constexpr u32 MAX_SECTION_COUNT = 1 << 16;
+
+    inline size_t getSectionStateSize(u64 stateSize, u32 sectionIndex)
+    {
+        u64 sectionStart = (u64) sectionIndex * SaveStateContainer::SECTION_SIZE;
+        return (size_t) std::min<u64>(SaveStateContainer::SECTION_SIZE, stateSize - sectionStart);
+    }
+}
+
+void SaveStateContainer::encode(const u8* state, size_t stateSize, std::vector<u8>& output)
+{
+    u32 sectionCount = (u32) ((stateSize + SECTION_SIZE - 1) / SECTION_SIZE);
+    size_t tableSize = sectionCount * sizeof(SectionEntry);
+    size_t dataOffset = sizeof(Header) + tableSize;
+
+    output.resize(dataOffset + LzCodec::getMaxCompressedSize(SECTION_SIZE) * sectionCount);
+
+    std::vector<SectionEntry> sections(sectionCount);
+    size_t outputPosition = dataOffset;
+
+    for (u32 i = 0; i < sectionCount; i++)
+    {
+        const u8* section = state + (size_t) i * SECTION_SIZE;
+        size_t sectionSize = getSectionStateSize(stateSize, i);
+        u8* sectionOutput = output.data() + outputPosition;
+        u32 checksum = Crc32::compute(section, sectionSize);
+
+        size_t compressedSize = LzCodec::compress(section, sectionSize, sectionOutput, output.size() - outputPosition);
+        if (compressedSize >= sectionSize)
+        {
+            memcpy(sectionOutput, section, sectionSize);
+            sections[i] = SectionEntry { .storedSize = (u32) sectionSize, .flags = SECTION_FLAG_STORED, .checksum = checksum };
+        }
+        else
+        {
+            sections[i] = SectionEntry { .storedSize = (u32) compressedSize, .flags = 0, .checksum = checksum };
+        }
+
+        outputPosition += sections[i].storedSize;
+    }
+
+    Header header = {
+        .magic = MAGIC,
+        .version = VERSION,
+        .sectionSize = SECTION_SIZE,
+        .sectionCount = sectionCount,
+        .stateSize = stateSize,
+        .tableChecksum = Crc32::compute((const u8*) sections.data(), tableSize),
+        .reserved = 0,
+    };
+
+    memcpy(output.data(), &header, sizeof(Header));
+    if (tableSize > 0)
+        memcpy(output.data() + sizeof(Header), sections.data(), tableSize);
+    output.resize(outputPosition);
+}
+
+SaveStateContainer::ReadResult SaveStateContainer::read(FILE* file, std::vector<u8>& output)
+{
+    Header header;
+    if (fread(&header, sizeof(Header), 1, file) != 1 || header.magic != MAGIC)
+        return ReadResult::NotContainer;
+
+    if (header.version > VERSION || header.sectionSize != SECTION_SIZE || header.sectionCount > MAX_SECTION_COUNT)
+        return ReadResult::Invalid;
+
+    if (header.stateSize > (u64) header.sectionCount * SECTION_SIZE || header.stateSize + SECTION_SIZE <= (u64) header.sectionCount * SECTION_SIZE)
+        return ReadResult::Invalid;
+
+    std::vector<SectionEntry> sections(header.sectionCount);
+    size_t tableSize = sections.size() * sizeof(SectionEntry);
+    if (fread(sections.data(), 1, tableSize, file) != tableSize || Crc32::compute((const u8*) sections.data(), tableSize) != header.tableChecksum)
+        return ReadResult::Invalid;
+
+    output.resize(header.stateSize);
+    std::vector<u8> compressedSection;
+
+    for (u32 i = 0; i < header.sectionCount; i++)
+    {
+        const SectionEntry& entry = sections[i];
+        u8* section = output.data() + (size_t) i * SECTION_SIZE;
+        size_t sectionSize = getSectionStateSize(header.stateSize, i);
+
+        if (entry.flags & SECTION_FLAG_STORED)
+        {
+            if (entry.storedSize != sectionSize || fread(section, 1, sectionSize, file) != sectionSize)
+                return ReadResult::Invalid;
+        }
+        else
+        {
+            if (entry.storedSize > LzCodec::getMaxCompressedSize(sectionSize))
+                return ReadResult::Invalid;
+
+            compressedSection.resize(entry.storedSize);
+            if (fread(compressedSection.data(), 1, entry.storedSize, file) != entry.storedSize)
+                return ReadResult::Invalid;
+
+            if (!LzCodec::decompress(compressedSection.data(), entry.storedSize, section, sectionSize))
+                return ReadResult::Invalid;
+        }
+
+        if (Crc32::compute(section, sectionSize) != entry.checksum)
+            return ReadResult::Invalid;
+    }
+
+    return ReadResult::Success;
+}
@@ -0,0 +1,68 @@
+#ifndef MELONDS_ANDROID_SAVESTATECONTAINER_H
+#define MELONDS_ANDROID_SAVESTATECONTAINER_H
+
+#include <cstdio>
+#include <vector>
+#include "types.h"
+
+/**
+ * Container format for save state files. The serialized state is split into fixed size sections that are compressed independently with LzCodec
+ * and protected by a CRC32 checksum, so that a state can be decompressed section by section while it is read from storage.
+ *
+ * Layout (all fields are in native byte order, which is little-endian on every ABI the app is built for):
+ *   Header        32 bytes, see Header
+ *   Section table one SectionEntry per section
+ *   Section data  the stored bytes of each section, in order
+ *
+ * Files that do not start with the container magic are save states written by older versions, which contain the raw serialized state.
+ */
+namespace SaveStateContainer
+{
+    constexpr melonDS::u32 MAGIC = 0x5A53444D; // "MDSZ"
+    constexpr melonDS::u32 VERSION = 1;
+    constexpr melonDS::u32 SECTION_SIZE = 256 * 1024;
+    // The section is stored uncompressed because compression did not reduce its size
+    constexpr melonDS::u32 SECTION_FLAG_STORED = 1 << 0;
+
+    struct Header
+    {
+        melonDS::u32 magic;
+        melonDS::u32 version;
+        melonDS::u32 sectionSize;
+        melonDS::u32 sectionCount;
+        melonDS::u64 stateSize;
+        // CRC32 of the section table
+        melonDS::u32 tableChecksum;
+        melonDS::u32 reserved;
+    };
+
+    struct SectionEntry
+    {
+        melonDS::u32 storedSize;
+        melonDS::u32 flags;
+        // CRC32 of the uncompressed section
+        melonDS::u32 checksum;
+    };
+
+    enum class ReadResult
+    {
+        Success,
+        // The file is not a container. It should be handed to the core as is
+        NotContainer,
+        // The file is a container, but it is corrupted or was written by a newer version
+        Invalid,
+    };
+
+    /**
+     * Encodes a serialized state into a container. The output is resized to the size of the container.
+     */
+    void encode(const melonDS::u8* state, size_t stateSize, std::vector<melonDS::u8>& output);
+
+    /**
+     * Reads a container from the current position of the file, decompressing each section into its final place in the output as soon as it has
+     * been read. The output is resized to the size of the state. If the file is not a container, only the header is consumed.
+     */
+    ReadResult read(FILE* file, std::vector<melonDS::u8>& output);
+}
+
+#endif //MELONDS_ANDROID_SAVESTATECONTAINER_H
@@ -0,0 +1,154 @@
+#include "SaveStateWriter.h"
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <pthread.h>
+#include <unistd.h>
+#include "../EmulatorMessageQueueJNI.h"
+#include "../MelonDSAndroidInterface.h"
+#include "SaveStateContainer.h"
+#include "ScreenshotEncoder.h"
+#include "Platform.h"
+
+using namespace melonDS;
+
+SaveStateWriter::SaveStateWriter(UriFileHandler* fileHandler) : fileHandler(fileHandler)
+{
+}
+
+SaveStateWriter::~SaveStateWriter()
+{
+    stop();
+}
+
+void SaveStateWriter::start()
+{
+    std::lock_guard<std::mutex> lock(writerMutex);
+    if (running)
+        return;
+
+    running = true;
+    writerThread = std::thread(&SaveStateWriter::run, this);
+    pthread_setname_np(writerThread.native_handle(), "SaveStateWriter");
+}
+
+void SaveStateWriter::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        if (!running)
+            return;
+
+        running = false;
+    }
+
+    writerCondition.notify_all();
+    writerThread.join();
+}
+
+void SaveStateWriter::enqueue(int requestId, char* data, size_t dataSize, std::string temporaryPath, std::string targetPath, std::vector<u8> screenshot, std::string screenshotPath)
+{
+    {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        pendingRequests.push_back(WriteRequest {
+            .requestId = requestId,
+            .data = data,
+            .dataSize = dataSize,
+            .temporaryPath = std::move(temporaryPath),
+            .targetPath = std::move(targetPath),
+            .screenshot = std::move(screenshot),
+            .screenshotPath = std::move(screenshotPath),
+        });
+    }
+
+    writerCondition.notify_all();
+}
+
+void SaveStateWriter::run()
+{
+    JNIEnv* env = jniEnvHandler->getCurrentThreadEnv();
+    std::unique_lock<std::mutex> lock(writerMutex);
+
+    for (;;)
+    {
+        // Pending requests are always written, even when stopping, so that no save state is lost
+        writerCondition.wait(lock, [this] { return !running || !pendingRequests.empty(); });
+        if (pendingRequests.empty())
+            break;
+
+        WriteRequest request = std::move(pendingRequests.front());
+        pendingRequests.pop_front();
+        lock.unlock();
+
+        // This thread never returns to Java, so local references must be released explicitly
+        env->PushLocalFrame(16);
+        bool success = writeSaveState(request);
+        env->PopLocalFrame(nullptr);
+        free(request.data);
+
+        // The screenshot is written before reporting completion so that it is up to date once the save state is reported as written
+        if (success)
+            writeScreenshot(request);
+
+        struct {
+            int32_t requestId;
+            int32_t success;
+        } eventData = {
+            .requestId = request.requestId,
+            .success = success ? 1 : 0,
+        };
+        MelonDSAndroid::fireEmulatorEvent(EVENT_SAVE_STATE_WRITTEN, sizeof(eventData), &eventData);
+
+        lock.lock();
+    }
+}
+
+bool SaveStateWriter::writeSaveState(const WriteRequest& request)
+{
+    auto encodeStart = std::chrono::steady_clock::now();
+    SaveStateContainer::encode((const u8*) request.data, request.dataSize, containerBuffer);
+    auto encodeTimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - encodeStart).count();
+    Platform::Log(Platform::LogLevel::Info, "Save state compressed from %zu KB to %zu KB in %lld ms", request.dataSize / 1024, containerBuffer.size() / 1024, (long long) encodeTimeMs);
+
+    FILE* file = fileHandler->open(request.temporaryPath.c_str(), Platform::FileMode::Write);
+    if (file == nullptr)
+    {
+        Platform::Log(Platform::LogLevel::Error, "Failed to open temporary save state file");
+        return false;
+    }
+
+    bool success = fwrite(containerBuffer.data(), 1, containerBuffer.size(), file) == containerBuffer.size();
+    success = success && fflush(file) == 0;
+    // Some document providers hand out descriptors that cannot be synced, like pipes
+    success = success && (fsync(fileno(file)) == 0 || errno == EINVAL);
+    success = fclose(file) == 0 && success;
+
+    if (!success)
+    {
+        Platform::Log(Platform::LogLevel::Error, "Failed to write save state");
+        return false;
+    }
+
+    if (!fileHandler->replace(request.temporaryPath.c_str(), request.targetPath.c_str()))
+    {
+        Platform::Log(Platform::LogLevel::Error, "Failed to move save state into place");
+        return false;
+    }
+
+    return true;
+}
+
+void SaveStateWriter::writeScreenshot(const WriteRequest& request)
+{
+    if (request.screenshot.empty() || request.screenshotPath.empty())
+        return;
+
+    auto encodeStart = std::chrono::steady_clock::now();
+    bool success = ScreenshotEncoder::writePng(request.screenshot.data(), SCREENSHOT_WIDTH, SCREENSHOT_HEIGHT, request.screenshotPath.c_str());
+    auto encodeTimeUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - encodeStart).count();
+
+    if (success)
+        Platform::Log(Platform::LogLevel::Info, "Save state screenshot encoded and written in %.2f ms", encodeTimeUs / 1000.0);
+    else
+        Platform::Log(Platform::LogLevel::Error, "Failed to write save state screenshot");
+}
@@ -0,0 +1,69 @@
+#ifndef MELONDS_ANDROID_SAVESTATEWRITER_H
+#define MELONDS_ANDROID_SAVESTATEWRITER_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../UriFileHandler.h"
+
+/**
+ * Writes save states that have already been serialized into memory on a background thread. Each state is packed into a SaveStateContainer,
+ * written to a temporary file, synced to storage and then moved over the target file, so that an interrupted write never corrupts an
+ * existing save state. The screenshot of the save state is encoded afterwards on the same thread. Completion is reported through the
+ * emulator event channel.
+ */
+class SaveStateWriter
+{
+public:
+    static constexpr int EVENT_SAVE_STATE_WRITTEN = 300;
+    static constexpr melonDS::u32 SCREENSHOT_WIDTH = 256;
+    static constexpr melonDS::u32 SCREENSHOT_HEIGHT = 384;
+    static constexpr melonDS::u32 SCREENSHOT_SIZE = SCREENSHOT_WIDTH * SCREENSHOT_HEIGHT * 4;
+
+    explicit SaveStateWriter(UriFileHandler* fileHandler);
+    ~SaveStateWriter();
+
+    void start();
+
+    /**
+     * Stops the writer after all queued save states have been written.
+     */
+    void stop();
+
+    /**
+     * Queues a save state for writing. Takes ownership of the data, which must have been allocated with malloc().
+     *
+     * @param screenshot BGRA screenshot of both screens, or empty if no screenshot should be written
+     * @param screenshotPath Filesystem path of the PNG screenshot, which is only written if the save state is written successfully
+     */
+    void enqueue(int requestId, char* data, size_t dataSize, std::string temporaryPath, std::string targetPath, std::vector<melonDS::u8> screenshot, std::string screenshotPath);
+
+private:
+    struct WriteRequest
+    {
+        int requestId;
+        char* data;
+        size_t dataSize;
+        std::string temporaryPath;
+        std::string targetPath;
+        std::vector<melonDS::u8> screenshot;
+        std::string screenshotPath;
+    };
+
+    UriFileHandler* fileHandler;
+    std::thread writerThread;
+    std::mutex writerMutex;
+    std::condition_variable writerCondition;
+    std::deque<WriteRequest> pendingRequests;
+    bool running = false;
+    std::vector<melonDS::u8> containerBuffer;
+
+    void run();
+    bool writeSaveState(const WriteRequest& request);
+    void writeScreenshot(const WriteRequest& request);
+};
+
+#endif //MELONDS_ANDROID_SAVESTATEWRITER_H
@@ -0,0 +1,178 @@
+#include "ScreenshotEncoder.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+#include <zlib.h>
+#include "../hashing/Crc32.h"
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+using namespace melonDS;
+
+namespace
+{
+    constexpr u8 PNG_SIGNATURE[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    constexpr u8 COLOR_TYPE_RGB = 2;
+    constexpr u8 FILTER_TYPE_UP = 2;
+
+    inline void writeBigEndian32(u8* output, u32 value)
+    {
+        output[0] = (u8) (value >> 24);
+        output[1] = (u8) (value >> 16);
+        output[2] = (u8) (value >> 8);
+        output[3] = (u8) value;
+    }
+
+    /**
+     * Appends a chunk header for a chunk of the given size. The chunk data must be written right after it, followed by finishChunk().
+     */
+    size_t beginChunk(std::vector<u8>& output, const char* type, u32 dataSize)
+    {
+        size_t chunkStart = output.size();
+        output.resize(chunkStart + 8 + dataSize);
+        writeBigEndian32(output.data() + chunkStart, dataSize);
+        memcpy(output.data() + chunkStart + 4, type, 4);
+        return chunkStart;
+    }
+
+    void finishChunk(std::vector<u8>& output, size_t chunkStart)
+    {
+        // The CRC covers the chunk type and data, but not the length
+        u32 crc = Crc32::compute(output.data() + chunkStart + 4, output.size() - chunkStart - 4);
+        output.resize(output.size() + 4);
+        writeBigEndian32(output.data() + output.size() - 4, crc);
+    }
+
+    /**
+     * Converts a BGRA row to RGB and applies the Up filter against the previous row. The previous row of the first row is null, in which case it
+     * is treated as black, as the PNG specification requires.
+     */
+    void filterRow(const u8* row, const u8* previousRow, u32 width, u8* output)
+    {
+        u32 x = 0;
+
+#if defined(__ARM_NEON)
+        for (; x + 16 <= width; x += 16)
+        {
+            uint8x16x4_t pixels = vld4q_u8(row + x * 4);
+            uint8x16x3_t filtered;
+            if (previousRow != nullptr)
+            {
+                uint8x16x4_t previousPixels = vld4q_u8(previousRow + x * 4);
+                filtered.val[0] = vsubq_u8(pixels.val[2], previousPixels.val[2]);
+                filtered.val[1] = vsubq_u8(pixels.val[1], previousPixels.val[1]);
+                filtered.val[2] = vsubq_u8(pixels.val[0], previousPixels.val[0]);
+            }
+            else
+            {
+                filtered.val[0] = pixels.val[2];
+                filtered.val[1] = pixels.val[1];
+                filtered.val[2] = pixels.val[0];
+            }
+            vst3q_u8(output + x * 3, filtered);
+        }
+#endif
+
+        for (; x < width; x++)
+        {
+            const u8* pixel = row + x * 4;
+            u8* filtered = output + x * 3;
+            if (previousRow != nullptr)
+            {
+                const u8* previousPixel = previousRow + x * 4;
+                filtered[0] = (u8) (pixel[2] - previousPixel[2]);
+                filtered[1] = (u8) (pixel[1] - previousPixel[1]);
+                filtered[2] = (u8) (pixel[0] - previousPixel[0]);
+            }
+            else
+            {
+                filtered[0] = pixel[2];
+                filtered[1] = pixel[1];
+                filtered[2] = pixel[0];
+            }
+        }
+    }
+}
+
+bool ScreenshotEncoder::encodePng(const u8* screenshot, u32 width, u32 height, std::vector<u8>& output)
+{
+    size_t rowSize = 1 + (size_t) width * 3;
+    std::vector<u8> filteredImage(rowSize * height);
+
+    for (u32 y = 0; y < height; y++)
+    {
+        u8* filteredRow = filteredImage.data() + y * rowSize;
+        const u8* row = screenshot + (size_t) y * width * 4;
+        const u8* previousRow = y > 0 ? row - (size_t) width * 4 : nullptr;
+
+        filteredRow[0] = FILTER_TYPE_UP;
+        filterRow(row, previousRow, width, filteredRow + 1);
+    }
+
+    output.assign(PNG_SIGNATURE, PNG_SIGNATURE + sizeof(PNG_SIGNATURE));
+
+    size_t headerChunk = beginChunk(output, "IHDR", 13);
+    u8* header = output.data() + headerChunk + 8;
+    writeBigEndian32(header, width);
+    writeBigEndian32(header + 4, height);
+    header[8] = 8; // Bit depth
+    header[9] = COLOR_TYPE_RGB;
+    header[10] = 0; // Compression method
+    header[11] = 0; // Filter method
+    header[12] = 0; // No interlacing
+    finishChunk(output, headerChunk);
+
+    uLongf compressedSize = compressBound(filteredImage.size());
+    size_t dataChunk = beginChunk(output, "IDAT", compressedSize);
+    if (compress2(output.data() + dataChunk + 8, &compressedSize, filteredImage.data(), filteredImage.size(), Z_DEFAULT_COMPRESSION) != Z_OK)
+        return false;
+
+    // Shrink the chunk to the actual size of the compressed data
+    output.resize(dataChunk + 8 + compressedSize);
+    writeBigEndian32(output.data() + dataChunk, compressedSize);
+    finishChunk(output, dataChunk);
+
+    size_t endChunk = beginChunk(output, "IEND", 0);
+    finishChunk(output, endChunk);
+    return true;
+}
+
+bool ScreenshotEncoder::writePng(const u8* screenshot, u32 width, u32 height, const char* path)
+{
+    std::vector<u8> png;
+    if (!encodePng(screenshot, width, height, png))
+        return false;
+
+    std::string temporaryPath = std::string(path) + ".tmp";
+    int fd = ::open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return false;
+
+    size_t written = 0;
+    while (written < png.size())
+    {
+        ssize_t result = write(fd, png.data() + written, png.size() - written);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            break;
+        }
+        written += result;
+    }
+
+    bool success = close(fd) == 0 && written == png.size();
+    if (!success || rename(temporaryPath.c_str(), path) != 0)
+    {
+        unlink(temporaryPath.c_str());
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,27 @@
+#ifndef MELONDS_ANDROID_SCREENSHOTENCODER_H
+#define MELONDS_ANDROID_SCREENSHOTENCODER_H
+
+#include <vector>
+#include "types.h"
+
+/**
+ * Encodes BGRA screenshots as opaque RGB PNG images. Every row uses the PNG "Up" filter, which is applied together with the BGRA to RGB
+ * conversion in a single pass over the screenshot.
+ */
+namespace ScreenshotEncoder
+{
+    /**
+     * Encodes the screenshot into the output, which is resized to the size of the PNG file.
+     *
+     * @return False if the image data could not be compressed
+     */
+    bool encodePng(const melonDS::u8* screenshot, melonDS::u32 width, melonDS::u32 height, std::vector<melonDS::u8>& output);
+
+    /**
+     * Writes a PNG file at the given filesystem path. The image is written to a temporary file first and then renamed, so that readers never see
+     * a partially written file.
+     */
+    bool writePng(const melonDS::u8* screenshot, melonDS::u32 width, melonDS::u32 height, const char* path);
+}
+
+#endif //MELONDS_ANDROID_SCREENSHOTENCODER_H
@@ -0,0 +1,295 @@
+#include "SramPersister.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <pthread.h>
+#include <unistd.h>
+#include "Platform.h"
+
+using namespace melonDS;
+
+namespace
+{
+    bool writeFully(int fd, const u8* data, size_t size, off_t offset)
+    {
+        while (size > 0)
+        {
+            ssize_t written = pwrite(fd, data, size, offset);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                return false;
+            }
+
+            data += written;
+            offset += written;
+            size -= written;
+        }
+
+        return true;
+    }
+}
+
+SramPersister::SramPersister(UriFileHandler* fileHandler) : fileHandler(fileHandler)
+{
+}
+
+SramPersister::~SramPersister()
+{
+    stop();
+    closeFile();
+}
+
+bool SramPersister::start(const std::string& savePath)
+{
+    if (running)
+        return false;
+
+    // A missing file is not an error. The game has not saved yet
+    contents.clear();
+    if (FILE* existingFile = fileHandler->open(savePath.c_str(), Platform::FileMode::Read))
+    {
+        u8 buffer[READ_CHUNK_SIZE];
+        size_t bytesRead;
+        while ((bytesRead = fread(buffer, 1, sizeof(buffer), existingFile)) > 0)
+            contents.insert(contents.end(), buffer, buffer + bytesRead);
+
+        bool readFailed = ferror(existingFile) != 0;
+        fclose(existingFile);
+        if (readFailed)
+            return false;
+    }
+
+    path = savePath;
+    dirtyRanges.clear();
+    truncatePending = false;
+    flushRequested = false;
+    stats = {};
+    running = true;
+    persisterThread = std::thread(&SramPersister::run, this);
+    pthread_setname_np(persisterThread.native_handle(), "SramPersister");
+
+    fileHandler->setFileRedirect(path.c_str(), shared_from_this());
+    return true;
+}
+
+void SramPersister::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (!running)
+            return;
+
+        running = false;
+    }
+
+    fileHandler->removeFileRedirect(path.c_str());
+
+    // The persister thread writes back pending changes before exiting
+    stateCondition.notify_all();
+    persisterThread.join();
+}
+
+void SramPersister::requestFlush()
+{
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        flushRequested = true;
+    }
+
+    stateCondition.notify_all();
+}
+
+SramPersister::Stats SramPersister::getStats()
+{
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return stats;
+}
+
+const std::string& SramPersister::getPath() const
+{
+    return path;
+}
+
+std::vector<u8> SramPersister::readContents()
+{
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return contents;
+}
+
+void SramPersister::writeContents(std::vector<u8> newContents)
+{
+    bool isRunning;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stats.bytesReceived += newContents.size();
+
+        size_t commonSize = std::min(contents.size(), newContents.size());
+        for (size_t blockStart = 0; blockStart < commonSize; blockStart += BLOCK_SIZE)
+        {
+            size_t blockSize = std::min(BLOCK_SIZE, commonSize - blockStart);
+            if (memcmp(contents.data() + blockStart, newContents.data() + blockStart, blockSize) != 0)
+                markDirty(blockStart, blockStart + blockSize);
+        }
+
+        if (newContents.size() > contents.size())
+            markDirty(contents.size(), newContents.size());
+        else if (newContents.size() < contents.size())
+            truncatePending = true;
+
+        contents = std::move(newContents);
+        lastChangeTime = std::chrono::steady_clock::now();
+        isRunning = running;
+    }
+
+    if (isRunning)
+    {
+        stateCondition.notify_all();
+    }
+    else
+    {
+        // The core closed a file it opened before the persister was stopped. There is no persister thread anymore
+        std::lock_guard<std::mutex> writeBackLock(writeBackMutex);
+        writeBack();
+        closeFile();
+    }
+}
+
+void SramPersister::markDirty(u64 start, u64 end)
+{
+    stats.bytesDirtied += end - start;
+
+    // Insert the range keeping the list sorted, then merge it with the ranges it touches
+    auto it = std::lower_bound(dirtyRanges.begin(), dirtyRanges.end(), std::make_pair(start, end));
+    if (it != dirtyRanges.begin() && std::prev(it)->second >= start)
+        --it;
+
+    if (it == dirtyRanges.end() || it->first > end)
+    {
+        dirtyRanges.insert(it, std::make_pair(start, end));
+        return;
+    }
+
+    it->first = std::min(it->first, start);
+    it->second = std::max(it->second, end);
+
+    auto next = std::next(it);
+    while (next != dirtyRanges.end() && next->first <= it->second)
+    {
+        it->second = std::max(it->second, next->second);
+        next = dirtyRanges.erase(next);
+    }
+}
+
+void SramPersister::run()
+{
+    std::unique_lock<std::mutex> lock(stateMutex);
+    while (running)
+    {
+        if (dirtyRanges.empty() && !truncatePending)
+        {
+            flushRequested = false;
+            stateCondition.wait(lock);
+            continue;
+        }
+
+        auto writeBackTime = lastChangeTime + QUIET_PERIOD;
+        if (!flushRequested && std::chrono::steady_clock::now() < writeBackTime)
+        {
+            stateCondition.wait_until(lock, writeBackTime);
+            continue;
+        }
+
+        flushRequested = false;
+        lock.unlock();
+        bool success;
+        {
+            std::lock_guard<std::mutex> writeBackLock(writeBackMutex);
+            success = writeBack();
+        }
+        lock.lock();
+
+        // Wait for another quiet period before retrying a failed write-back
+        if (!success)
+            lastChangeTime = std::chrono::steady_clock::now();
+    }
+    lock.unlock();
+
+    std::lock_guard<std::mutex> writeBackLock(writeBackMutex);
+    writeBack();
+    closeFile();
+}
+
+bool SramPersister::writeBack()
+{
+    std::vector<std::pair<u64, std::vector<u8>>> pendingWrites;
+    bool truncate;
+    u64 fileSize;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (dirtyRanges.empty() && !truncatePending)
+            return true;
+
+        for (const auto& [start, end] : dirtyRanges)
+            pendingWrites.emplace_back(start, std::vector<u8>(contents.begin() + start, contents.begin() + end));
+
+        dirtyRanges.clear();
+        truncate = truncatePending;
+        truncatePending = false;
+        fileSize = contents.size();
+    }
+
+    // Opening the file only when there is something to write avoids creating save files for games that never save
+    if (file == nullptr)
+        file = fileHandler->openWithoutRedirect(path.c_str(), (Platform::FileMode) (Platform::FileMode::ReadWrite | Platform::FileMode::Preserve));
+
+    int fd = file != nullptr ? fileno(file) : -1;
+    bool success = fd != -1;
+    u64 bytesWritten = 0;
+    for (const auto& [offset, data] : pendingWrites)
+    {
+        if (!success || !writeFully(fd, data.data(), data.size(), (off_t) offset))
+        {
+            success = false;
+            break;
+        }
+        bytesWritten += data.size();
+    }
+
+    success = success && (!truncate || ftruncate(fd, (off_t) fileSize) == 0);
+    // Some document providers hand out descriptors that cannot be synced, like pipes
+    success = success && (fdatasync(fd) == 0 || errno == EINVAL);
+
+    std::lock_guard<std::mutex> lock(stateMutex);
+    stats.bytesWritten += bytesWritten;
+    stats.writeBackCount++;
+
+    if (!success)
+    {
+        Platform::Log(Platform::LogLevel::Error, "Failed to write back save file");
+
+        // Everything that was pending is written again on the next attempt. The contents may have changed since, which is fine
+        u64 bytesDirtied = stats.bytesDirtied;
+        for (const auto& [offset, data] : pendingWrites)
+        {
+            u64 end = std::min<u64>(offset + data.size(), contents.size());
+            if (offset < end)
+                markDirty(offset, end);
+        }
+        truncatePending = truncatePending || truncate;
+        stats.bytesDirtied = bytesDirtied;
+    }
+
+    return success;
+}
+
+void SramPersister::closeFile()
+{
+    if (file != nullptr)
+    {
+        fclose(file);
+        file = nullptr;
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef MELONDS_ANDROID_SRAMPERSISTER_H
+#define MELONDS_ANDROID_SRAMPERSISTER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "../UriFileHandler.h"
+
+/**
+ * Write-behind storage for save RAM files. Writes from the core are redirected to an in-memory copy of the file, and only the blocks that changed
+ * are written back to storage with pwrite() on a background thread, once the file has not been modified for a short quiet period. Several writes
+ * in a row are coalesced into a single write-back. The save file is only opened for writing on the first write-back, so no file is created for
+ * games that never save.
+ *
+ * Files that the core opened through the redirect keep the persister alive until they are closed. Changes written to them after the persister
+ * is stopped are written back immediately.
+ */
+class SramPersister : public UriFileHandler::FileRedirect, public std::enable_shared_from_this<SramPersister>
+{
+public:
+    struct Stats
+    {
+        // Bytes written by the core, as full files
+        melonDS::u64 bytesReceived;
+        // Bytes in blocks that were modified by those writes
+        melonDS::u64 bytesDirtied;
+        // Bytes actually written to storage
+        melonDS::u64 bytesWritten;
+        melonDS::u32 writeBackCount;
+    };
+
+    explicit SramPersister(UriFileHandler* fileHandler);
+    ~SramPersister() override;
+
+    /**
+     * Reads the save file at the given path, if it exists, and starts redirecting its accesses. The persister must be owned by a shared_ptr.
+     */
+    bool start(const std::string& path);
+
+    /**
+     * Stops redirecting accesses to the file and waits until pending changes have been written back.
+     */
+    void stop();
+
+    /**
+     * Makes the persister thread write back all pending changes without waiting for the quiet period. Does not wait for the write-back.
+     */
+    void requestFlush();
+    Stats getStats();
+    const std::string& getPath() const;
+
+    std::vector<melonDS::u8> readContents() override;
+    void writeContents(std::vector<melonDS::u8> contents) override;
+
+private:
+    static constexpr std::chrono::milliseconds QUIET_PERIOD = std::chrono::milliseconds(500);
+    static constexpr size_t BLOCK_SIZE = 512;
+    static constexpr size_t READ_CHUNK_SIZE = 16 * 1024;
+
+    UriFileHandler* fileHandler;
+    std::string path;
+    FILE* file = nullptr;
+    std::thread persisterThread;
+    // Protects the contents, the dirty ranges and the stats
+    std::mutex stateMutex;
+    std::condition_variable stateCondition;
+    // Serializes write-backs between the persister thread and writes received after stopping. Also protects the file
+    std::mutex writeBackMutex;
+    bool running = false;
+    bool flushRequested = false;
+
+    std::vector<melonDS::u8> contents;
+    // Sorted, non-overlapping ranges of the contents that have not been written back yet
+    std::vector<std::pair<melonDS::u64, melonDS::u64>> dirtyRanges;
+    bool truncatePending = false;
+    std::chrono::steady_clock::time_point lastChangeTime;
+    Stats stats = {};
+
+    void run();
+    void markDirty(melonDS::u64 start, melonDS::u64 end);
+    bool writeBack();
+    void closeFile();
+};
+
+#endif //MELONDS_ANDROID_SRAMPERSISTER_H
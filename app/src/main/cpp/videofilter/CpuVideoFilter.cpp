@@ -0,0 +1,409 @@
+#include "CpuVideoFilter.h"
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+using namespace melonDS;
+using namespace CpuVideoFilter;
+
+namespace
+{
+    constexpr u32 SHARP_BILINEAR_SCALE = 3;
+    // Maximum YUV distance under which xBR considers two pixels to be the same colour
+    constexpr u32 XBR_EQUALITY_THRESHOLD = 155;
+
+    inline const u32* paddedRow(const u32* padded, u32 row)
+    {
+        return padded + (row + PADDING) * PADDED_WIDTH + PADDING;
+    }
+
+    /**
+     * Scale2x (also known as EPX or AdvMAME2x). Expands each pixel into 2x2 pixels, taking the colour of a neighbour where two neighbours that
+     * meet at that corner have the same colour.
+     */
+    void scale2xRow(const u32* above, const u32* current, const u32* below, u32* top, u32* bottom)
+    {
+        u32 x = 0;
+#if defined(__ARM_NEON)
+        for (; x + 4 <= SCREEN_WIDTH; x += 4)
+        {
+            uint32x4_t b = vld1q_u32(above + x);
+            uint32x4_t d = vld1q_u32(current + x - 1);
+            uint32x4_t e = vld1q_u32(current + x);
+            uint32x4_t f = vld1q_u32(current + x + 1);
+            uint32x4_t h = vld1q_u32(below + x);
+
+            uint32x4_t isCorner = vandq_u32(vmvnq_u32(vceqq_u32(b, h)), vmvnq_u32(vceqq_u32(d, f)));
+            uint32x4x2_t topPixels;
+            uint32x4x2_t bottomPixels;
+            topPixels.val[0] = vbslq_u32(vandq_u32(isCorner, vceqq_u32(d, b)), d, e);
+            topPixels.val[1] = vbslq_u32(vandq_u32(isCorner, vceqq_u32(b, f)), f, e);
+            bottomPixels.val[0] = vbslq_u32(vandq_u32(isCorner, vceqq_u32(d, h)), d, e);
+            bottomPixels.val[1] = vbslq_u32(vandq_u32(isCorner, vceqq_u32(h, f)), f, e);
+            vst2q_u32(top + x * 2, topPixels);
+            vst2q_u32(bottom + x * 2, bottomPixels);
+        }
+#endif
+        for (; x < SCREEN_WIDTH; x++)
+        {
+            const u32* pixel = current + x;
+            u32 b = above[x];
+            u32 d = pixel[-1];
+            u32 e = pixel[0];
+            u32 f = pixel[1];
+            u32 h = below[x];
+
+            if (b != h && d != f)
+            {
+                top[x * 2] = d == b ? d : e;
+                top[x * 2 + 1] = b == f ? f : e;
+                bottom[x * 2] = d == h ? d : e;
+                bottom[x * 2 + 1] = h == f ? f : e;
+            }
+            else
+            {
+                top[x * 2] = top[x * 2 + 1] = e;
+                bottom[x * 2] = bottom[x * 2 + 1] = e;
+            }
+        }
+    }
+
+    /**
+     * Scale3x (AdvMAME3x). Same idea as Scale2x, with 3x3 pixels per source pixel.
+     */
+    void scale3xRow(const u32* above, const u32* current, const u32* below, u32* top, u32* middle, u32* bottom)
+    {
+        u32 x = 0;
+#if defined(__ARM_NEON)
+        for (; x + 4 <= SCREEN_WIDTH; x += 4)
+        {
+            uint32x4_t a = vld1q_u32(above + x - 1);
+            uint32x4_t b = vld1q_u32(above + x);
+            uint32x4_t c = vld1q_u32(above + x + 1);
+            uint32x4_t d = vld1q_u32(current + x - 1);
+            uint32x4_t e = vld1q_u32(current + x);
+            uint32x4_t f = vld1q_u32(current + x + 1);
+            uint32x4_t g = vld1q_u32(below + x - 1);
+            uint32x4_t h = vld1q_u32(below + x);
+            uint32x4_t i = vld1q_u32(below + x + 1);
+
+            uint32x4_t isCorner = vandq_u32(vmvnq_u32(vceqq_u32(b, h)), vmvnq_u32(vceqq_u32(d, f)));
+            uint32x4_t db = vandq_u32(isCorner, vceqq_u32(d, b));
+            uint32x4_t bf = vandq_u32(isCorner, vceqq_u32(b, f));
+            uint32x4_t dh = vandq_u32(isCorner, vceqq_u32(d, h));
+            uint32x4_t hf = vandq_u32(isCorner, vceqq_u32(h, f));
+            uint32x4_t notEA = vmvnq_u32(vceqq_u32(e, a));
+            uint32x4_t notEC = vmvnq_u32(vceqq_u32(e, c));
+            uint32x4_t notEG = vmvnq_u32(vceqq_u32(e, g));
+            uint32x4_t notEI = vmvnq_u32(vceqq_u32(e, i));
+
+            uint32x4x3_t topPixels;
+            uint32x4x3_t middlePixels;
+            uint32x4x3_t bottomPixels;
+            topPixels.val[0] = vbslq_u32(db, d, e);
+            topPixels.val[1] = vbslq_u32(vorrq_u32(vandq_u32(db, notEC), vandq_u32(bf, notEA)), b, e);
+            topPixels.val[2] = vbslq_u32(bf, f, e);
+            middlePixels.val[0] = vbslq_u32(vorrq_u32(vandq_u32(db, notEG), vandq_u32(dh, notEA)), d, e);
+            middlePixels.val[1] = e;
+            middlePixels.val[2] = vbslq_u32(vorrq_u32(vandq_u32(bf, notEI), vandq_u32(hf, notEC)), f, e);
+            bottomPixels.val[0] = vbslq_u32(dh, d, e);
+            bottomPixels.val[1] = vbslq_u32(vorrq_u32(vandq_u32(dh, notEI), vandq_u32(hf, notEG)), h, e);
+            bottomPixels.val[2] = vbslq_u32(hf, f, e);
+            vst3q_u32(top + x * 3, topPixels);
+            vst3q_u32(middle + x * 3, middlePixels);
+            vst3q_u32(bottom + x * 3, bottomPixels);
+        }
+#endif
+        for (; x < SCREEN_WIDTH; x++)
+        {
+            const u32* pixelAbove = above + x;
+            const u32* pixel = current + x;
+            const u32* pixelBelow = below + x;
+            u32 a = pixelAbove[-1];
+            u32 b = pixelAbove[0];
+            u32 c = pixelAbove[1];
+            u32 d = pixel[-1];
+            u32 e = pixel[0];
+            u32 f = pixel[1];
+            u32 g = pixelBelow[-1];
+            u32 h = pixelBelow[0];
+            u32 i = pixelBelow[1];
+            u32* t = top + x * 3;
+            u32* m = middle + x * 3;
+            u32* o = bottom + x * 3;
+
+            if (b != h && d != f)
+            {
+                t[0] = d == b ? d : e;
+                t[1] = (d == b && e != c) || (b == f && e != a) ? b : e;
+                t[2] = b == f ? f : e;
+                m[0] = (d == b && e != g) || (d == h && e != a) ? d : e;
+                m[1] = e;
+                m[2] = (b == f && e != i) || (h == f && e != c) ? f : e;
+                o[0] = d == h ? d : e;
+                o[1] = (d == h && e != i) || (h == f && e != g) ? h : e;
+                o[2] = h == f ? f : e;
+            }
+            else
+            {
+                t[0] = t[1] = t[2] = e;
+                m[0] = m[1] = m[2] = e;
+                o[0] = o[1] = o[2] = e;
+            }
+        }
+    }
+
+    void nearest3xRow(const u32* current, u32* top, u32* middle, u32* bottom)
+    {
+        u32 x = 0;
+#if defined(__ARM_NEON)
+        for (; x + 4 <= SCREEN_WIDTH; x += 4)
+        {
+            uint32x4_t e = vld1q_u32(current + x);
+            uint32x4x3_t pixels = { e, e, e };
+            vst3q_u32(top + x * 3, pixels);
+        }
+#endif
+        for (; x < SCREEN_WIDTH; x++)
+            top[x * 3] = top[x * 3 + 1] = top[x * 3 + 2] = current[x];
+
+        memcpy(middle, top, SCREEN_WIDTH * SHARP_BILINEAR_SCALE * sizeof(u32));
+        memcpy(bottom, top, SCREEN_WIDTH * SHARP_BILINEAR_SCALE * sizeof(u32));
+    }
+
+    enum DistancePlane
+    {
+        DISTANCE_RIGHT = 0,
+        DISTANCE_DOWN = 1,
+        DISTANCE_DOWN_RIGHT = 2,
+        DISTANCE_DOWN_LEFT = 3,
+    };
+
+    inline u32 toYuv(u32 pixel)
+    {
+        int b = pixel & 0xFF;
+        int g = (pixel >> 8) & 0xFF;
+        int r = (pixel >> 16) & 0xFF;
+
+        u32 y = (77 * r + 150 * g + 29 * b) >> 8;
+        u32 u = ((-43 * r - 85 * g + 128 * b) >> 8) + 128;
+        u32 v = ((128 * r - 107 * g - 21 * b) >> 8) + 128;
+        return y | (u << 8) | (v << 16);
+    }
+
+    inline u16 yuvDistance(u32 a, u32 b)
+    {
+        int dy = std::abs((int) (a & 0xFF) - (int) (b & 0xFF));
+        int du = std::abs((int) ((a >> 8) & 0xFF) - (int) ((b >> 8) & 0xFF));
+        int dv = std::abs((int) ((a >> 16) & 0xFF) - (int) ((b >> 16) & 0xFF));
+        return 48 * dy + 7 * du + 6 * dv;
+    }
+
+    void computeYuvRow(const u32* pixels, u32* yuv)
+    {
+        for (u32 x = 0; x < PADDED_WIDTH; x++)
+            yuv[x] = toYuv(pixels[x]);
+    }
+
+    /**
+     * Looks up the distance between two pixels of the neighbourhood of the pixel at the given offset. Positions are given as if the neighbourhood was
+     * oriented towards the bottom right, and mirrored along the axes where DX or DY is -1.
+     */
+    template <int DX, int DY>
+    inline u32 neighbourDistance(const u16* distances, int offset, int firstX, int firstY, int secondX, int secondY)
+    {
+        int x0 = firstX * DX;
+        int y0 = firstY * DY;
+        int x1 = secondX * DX;
+        int y1 = secondY * DY;
+        // Distances are stored at the top-most (or left-most) pixel of each pair
+        if (y1 < y0 || (y1 == y0 && x1 < x0))
+        {
+            std::swap(x0, x1);
+            std::swap(y0, y1);
+        }
+
+        int plane;
+        if (y0 == y1)
+            plane = DISTANCE_RIGHT;
+        else if (x0 == x1)
+            plane = DISTANCE_DOWN;
+        else if (x1 > x0)
+            plane = DISTANCE_DOWN_RIGHT;
+        else
+            plane = DISTANCE_DOWN_LEFT;
+
+        return distances[plane * DISTANCE_PLANE_SIZE + offset + y0 * (int) PADDED_WIDTH + x0];
+    }
+
+    inline u32 blendHalf(u32 a, u32 b)
+    {
+        return ((a & 0xFEFEFEFE) >> 1) + ((b & 0xFEFEFEFE) >> 1);
+    }
+
+    /**
+     * Computes the corner of the pixel at the given offset that faces the diagonal direction (DX, DY), using the first level of the 2xBR edge
+     * detection rules. Names follow the usual xBR notation for the bottom-right corner: E is the pixel, F and H its right and bottom neighbours,
+     * and I the diagonal one. The other corners mirror the neighbourhood.
+     */
+    template <int DX, int DY>
+    u32 xbrCorner(const u32* pixels, const u16* distances, int offset)
+    {
+        u32 e = pixels[offset];
+        u32 f = pixels[offset + DX];
+        u32 h = pixels[offset + DY * (int) PADDED_WIDTH];
+        if (e == f || e == h)
+            return e;
+
+        auto distance = [&](int firstX, int firstY, int secondX, int secondY) {
+            return neighbourDistance<DX, DY>(distances, offset, firstX, firstY, secondX, secondY);
+        };
+        auto isSimilar = [&](int firstX, int firstY, int secondX, int secondY) {
+            return distance(firstX, firstY, secondX, secondY) < XBR_EQUALITY_THRESHOLD;
+        };
+
+        // E(0, 0) F(1, 0) H(0, 1) I(1, 1) B(0, -1) D(-1, 0) C(1, -1) G(-1, 1) F4(2, 0) I4(2, 1) H5(0, 2) I5(1, 2)
+        u32 edgeWeight = distance(0, 0, 1, -1) + distance(0, 0, -1, 1) + distance(1, 1, 0, 2) + distance(1, 1, 2, 0) + 4 * distance(0, 1, 1, 0);
+        u32 oppositeWeight = distance(0, 1, -1, 0) + distance(0, 1, 1, 2) + distance(1, 0, 2, 1) + distance(1, 0, 0, -1) + 4 * distance(0, 0, 1, 1);
+        if (edgeWeight >= oppositeWeight)
+            return e;
+
+        bool isEdge = (!isSimilar(1, 0, 0, -1) && !isSimilar(0, 1, -1, 0)) ||
+                      (isSimilar(0, 0, 1, 1) && !isSimilar(1, 0, 2, 1) && !isSimilar(0, 1, 1, 2)) ||
+                      isSimilar(0, 0, -1, 1) ||
+                      isSimilar(0, 0, 1, -1);
+        if (!isEdge)
+            return e;
+
+        u32 closest = distance(0, 0, 1, 0) <= distance(0, 0, 0, 1) ? f : h;
+        return blendHalf(e, closest);
+    }
+
+    void xbrLiteRow(const u32* padded, const u16* distances, u32 row, u32* top, u32* bottom)
+    {
+        int rowOffset = (row + PADDING) * PADDED_WIDTH + PADDING;
+        for (u32 x = 0; x < SCREEN_WIDTH; x++)
+        {
+            int offset = rowOffset + x;
+            top[x * 2] = xbrCorner<-1, -1>(padded, distances, offset);
+            top[x * 2 + 1] = xbrCorner<1, -1>(padded, distances, offset);
+            bottom[x * 2] = xbrCorner<-1, 1>(padded, distances, offset);
+            bottom[x * 2 + 1] = xbrCorner<1, 1>(padded, distances, offset);
+        }
+    }
+}
+
+u32 CpuVideoFilter::getScale(u32 filter)
+{
+    switch (filter)
+    {
+        case FILTER_SCALE2X:
+        case FILTER_XBR_LITE:
+            return 2;
+        case FILTER_SCALE3X:
+            return 3;
+        case FILTER_SHARP_BILINEAR:
+            return SHARP_BILINEAR_SCALE;
+        default:
+            return 0;
+    }
+}
+
+bool CpuVideoFilter::needsDistances(u32 filter)
+{
+    return filter == FILTER_XBR_LITE;
+}
+
+void CpuVideoFilter::padScreen(const u32* screen, u32* padded)
+{
+    for (u32 y = 0; y < PADDED_HEIGHT; y++)
+    {
+        u32 sourceY = y < PADDING ? 0 : (y - PADDING >= SCREEN_HEIGHT ? SCREEN_HEIGHT - 1 : y - PADDING);
+        const u32* source = screen + sourceY * SCREEN_WIDTH;
+        u32* destination = padded + y * PADDED_WIDTH;
+
+        for (u32 x = 0; x < PADDING; x++)
+        {
+            destination[x] = source[0];
+            destination[PADDING + SCREEN_WIDTH + x] = source[SCREEN_WIDTH - 1];
+        }
+        memcpy(destination + PADDING, source, SCREEN_WIDTH * sizeof(u32));
+    }
+}
+
+void CpuVideoFilter::computeDistances(const u32* padded, u32 firstRow, u32 lastRow, u16* distances)
+{
+    u32 currentYuv[PADDED_WIDTH];
+    u32 nextYuv[PADDED_WIDTH];
+
+    for (u32 row = firstRow; row < lastRow; row++)
+    {
+        const u32* pixels = padded + row * PADDED_WIDTH;
+        u16* right = distances + DISTANCE_RIGHT * DISTANCE_PLANE_SIZE + row * PADDED_WIDTH;
+        u16* down = distances + DISTANCE_DOWN * DISTANCE_PLANE_SIZE + row * PADDED_WIDTH;
+        u16* downRight = distances + DISTANCE_DOWN_RIGHT * DISTANCE_PLANE_SIZE + row * PADDED_WIDTH;
+        u16* downLeft = distances + DISTANCE_DOWN_LEFT * DISTANCE_PLANE_SIZE + row * PADDED_WIDTH;
+
+        if (row == firstRow)
+            computeYuvRow(pixels, currentYuv);
+        else
+            memcpy(currentYuv, nextYuv, sizeof(currentYuv));
+
+        for (u32 x = 0; x + 1 < PADDED_WIDTH; x++)
+            right[x] = yuvDistance(currentYuv[x], currentYuv[x + 1]);
+        right[PADDED_WIDTH - 1] = 0;
+
+        // The last row has no pixels below it. Its downwards distances are never read
+        if (row + 1 == PADDED_HEIGHT)
+        {
+            memset(down, 0, PADDED_WIDTH * sizeof(u16));
+            memset(downRight, 0, PADDED_WIDTH * sizeof(u16));
+            memset(downLeft, 0, PADDED_WIDTH * sizeof(u16));
+            continue;
+        }
+
+        computeYuvRow(pixels + PADDED_WIDTH, nextYuv);
+        for (u32 x = 0; x < PADDED_WIDTH; x++)
+            down[x] = yuvDistance(currentYuv[x], nextYuv[x]);
+        for (u32 x = 0; x + 1 < PADDED_WIDTH; x++)
+        {
+            downRight[x] = yuvDistance(currentYuv[x], nextYuv[x + 1]);
+            downLeft[x + 1] = yuvDistance(currentYuv[x + 1], nextYuv[x]);
+        }
+        downRight[PADDED_WIDTH - 1] = 0;
+        downLeft[0] = 0;
+    }
+}
+
+void CpuVideoFilter::filterRows(u32 filter, const u32* padded, const u16* distances, u32 firstRow, u32 lastRow, u32* output, u32 outputStride)
+{
+    u32 scale = getScale(filter);
+
+    for (u32 row = firstRow; row < lastRow; row++)
+    {
+        u32* outputRow = output + row * scale * outputStride;
+        const u32* current = paddedRow(padded, row);
+
+        switch (filter)
+        {
+            case FILTER_SCALE2X:
+                scale2xRow(current - PADDED_WIDTH, current, current + PADDED_WIDTH, outputRow, outputRow + outputStride);
+                break;
+            case FILTER_SCALE3X:
+                scale3xRow(current - PADDED_WIDTH, current, current + PADDED_WIDTH, outputRow, outputRow + outputStride, outputRow + outputStride * 2);
+                break;
+            case FILTER_XBR_LITE:
+                xbrLiteRow(padded, distances, row, outputRow, outputRow + outputStride);
+                break;
+            case FILTER_SHARP_BILINEAR:
+                nearest3xRow(current, outputRow, outputRow + outputStride, outputRow + outputStride * 2);
+                break;
+            default:
+                return;
+        }
+    }
+}
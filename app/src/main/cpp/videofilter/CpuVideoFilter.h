@@ -0,0 +1,73 @@
+#ifndef MELONDS_ANDROID_CPUVIDEOFILTER_H
+#define MELONDS_ANDROID_CPUVIDEOFILTER_H
+
+#include "types.h"
+
+/**
+ * Upscaling filters that run on the CPU, for devices whose GPUs are too slow for the shader based filters. Each screen is filtered on its own, from a
+ * padded copy whose borders repeat the edge pixels, so that filters can read the neighbours of every pixel without bounds checks. Pixels are 32-bit
+ * values in the screenshot's byte order (BGRA), which the filters never need to reorder.
+ *
+ * The filter values must match VideoFiltering.kt.
+ */
+namespace CpuVideoFilter
+{
+    constexpr melonDS::u32 FILTER_NONE = 0;
+    constexpr melonDS::u32 FILTER_SCALE2X = 1;
+    constexpr melonDS::u32 FILTER_SCALE3X = 2;
+    constexpr melonDS::u32 FILTER_XBR_LITE = 3;
+    // Integer nearest neighbour prescale. Displayed with linear filtering, which only blends the pixels at the edges of the original pixels
+    constexpr melonDS::u32 FILTER_SHARP_BILINEAR = 4;
+
+    constexpr melonDS::u32 SCREEN_WIDTH = 256;
+    constexpr melonDS::u32 SCREEN_HEIGHT = 192;
+    constexpr melonDS::u32 PADDING = 2;
+    constexpr melonDS::u32 PADDED_WIDTH = SCREEN_WIDTH + PADDING * 2;
+    constexpr melonDS::u32 PADDED_HEIGHT = SCREEN_HEIGHT + PADDING * 2;
+    // Filters that compare colours use precomputed distances between each padded pixel and its right, bottom, bottom-right and bottom-left
+    // neighbours, stored as one plane per direction
+    constexpr melonDS::u32 DISTANCE_PLANE_COUNT = 4;
+    constexpr melonDS::u32 DISTANCE_PLANE_SIZE = PADDED_WIDTH * PADDED_HEIGHT;
+
+    /**
+     * @return The scale factor of the filter, or 0 if the filter is not a valid CPU filter
+     */
+    melonDS::u32 getScale(melonDS::u32 filter);
+
+    /**
+     * Whether the filter compares pixel colours, in which case the colour distances must be computed with computeDistances() before filtering.
+     */
+    bool needsDistances(melonDS::u32 filter);
+
+    /**
+     * Copies a screen into a PADDED_WIDTH x PADDED_HEIGHT buffer, repeating the edge pixels into the padding.
+     */
+    void padScreen(const melonDS::u32* screen, melonDS::u32* padded);
+
+    /**
+     * Computes the YUV distances between the pixels of the padded rows in [firstRow, lastRow) and their neighbours. Rows only read the row below
+     * them, so different row ranges can be computed concurrently.
+     *
+     * @param distances Buffer of DISTANCE_PLANE_COUNT * DISTANCE_PLANE_SIZE values
+     */
+    void computeDistances(const melonDS::u32* padded, melonDS::u32 firstRow, melonDS::u32 lastRow, melonDS::u16* distances);
+
+    /**
+     * Filters the screen rows in [firstRow, lastRow). The output receives getScale(filter) rows for each screen row.
+     *
+     * @param distances The distances computed by computeDistances() for the whole padded screen. Only used if needsDistances() is true for the filter
+     * @param output Start of the output for the first row of the screen
+     * @param outputStride Distance between output rows, in pixels
+     */
+    void filterRows(
+        melonDS::u32 filter,
+        const melonDS::u32* padded,
+        const melonDS::u16* distances,
+        melonDS::u32 firstRow,
+        melonDS::u32 lastRow,
+        melonDS::u32* output,
+        melonDS::u32 outputStride
+    );
+}
+
+#endif //MELONDS_ANDROID_CPUVIDEOFILTER_H
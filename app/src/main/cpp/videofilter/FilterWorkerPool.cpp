@@ -0,0 +1,76 @@
+#include "FilterWorkerPool.h"
+#include <pthread.h>
+
+using namespace melonDS;
+
+FilterWorkerPool::FilterWorkerPool(u32 workerCount)
+{
+    for (u32 i = 0; i < workerCount; i++)
+    {
+        workers.emplace_back(&FilterWorkerPool::workerLoop, this);
+        pthread_setname_np(workers.back().native_handle(), "VideoFilter");
+    }
+}
+
+FilterWorkerPool::~FilterWorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        running = false;
+    }
+
+    workCondition.notify_all();
+    for (std::thread& worker : workers)
+        worker.join();
+}
+
+void FilterWorkerPool::run(u32 count, const std::function<void(u32)>& task)
+{
+    if (count == 0)
+        return;
+
+    std::unique_lock<std::mutex> lock(poolMutex);
+    currentTask = &task;
+    taskCount = count;
+    nextTask = 0;
+    pendingTasks = count;
+    batch++;
+    workCondition.notify_all();
+
+    processTasks(lock);
+    doneCondition.wait(lock, [this] { return pendingTasks == 0; });
+    currentTask = nullptr;
+}
+
+void FilterWorkerPool::workerLoop()
+{
+    u32 processedBatch = 0;
+
+    std::unique_lock<std::mutex> lock(poolMutex);
+    while (true)
+    {
+        workCondition.wait(lock, [&] { return !running || batch != processedBatch; });
+        if (!running)
+            break;
+
+        processedBatch = batch;
+        processTasks(lock);
+    }
+}
+
+void FilterWorkerPool::processTasks(std::unique_lock<std::mutex>& lock)
+{
+    // Tasks are coarse (a band of rows each), so handing them out under the lock costs nothing measurable
+    while (nextTask < taskCount)
+    {
+        u32 taskIndex = nextTask++;
+        const std::function<void(u32)>& task = *currentTask;
+
+        lock.unlock();
+        task(taskIndex);
+        lock.lock();
+
+        if (--pendingTasks == 0)
+            doneCondition.notify_all();
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef MELONDS_ANDROID_FILTERWORKERPOOL_H
+#define MELONDS_ANDROID_FILTERWORKERPOOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "types.h"
+
+/**
+ * Small fixed pool of threads used to split a frame's filtering work into independent tasks. The calling thread takes part in the work, so a pool
+ * with N workers processes tasks on N + 1 threads.
+ */
+class FilterWorkerPool
+{
+public:
+    explicit FilterWorkerPool(melonDS::u32 workerCount);
+    ~FilterWorkerPool();
+
+    /**
+     * Runs task(0) ... task(taskCount - 1) across the pool and the calling thread, and blocks until all of them have finished. Must not be called
+     * concurrently from multiple threads.
+     */
+    void run(melonDS::u32 taskCount, const std::function<void(melonDS::u32)>& task);
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex poolMutex;
+    std::condition_variable workCondition;
+    std::condition_variable doneCondition;
+    bool running = true;
+    // Incremented for every batch, so that workers can tell a new batch from the one they have already processed
+    melonDS::u32 batch = 0;
+    const std::function<void(melonDS::u32)>* currentTask = nullptr;
+    melonDS::u32 taskCount = 0;
+    melonDS::u32 nextTask = 0;
+    melonDS::u32 pendingTasks = 0;
+
+    void workerLoop();
+    void processTasks(std::unique_lock<std::mutex>& lock);
+};
+
+#endif //MELONDS_ANDROID_FILTERWORKERPOOL_H
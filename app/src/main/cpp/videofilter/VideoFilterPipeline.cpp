@@ -0,0 +1,181 @@
+#include "VideoFilterPipeline.h"
+#include <algorithm>
+#include <thread>
+#include "CpuVideoFilter.h"
+
+using namespace melonDS;
+
+namespace
+{
+    constexpr u32 SCREEN_COUNT = 2;
+    constexpr u32 SCREEN_GAP_LINES = 2;
+    constexpr u32 PADDED_SCREEN_SIZE = CpuVideoFilter::PADDED_WIDTH * CpuVideoFilter::PADDED_HEIGHT;
+    // Each task filters a band of rows of one screen. Small enough to balance the work between threads, large enough to keep the overhead low
+    constexpr u32 BAND_HEIGHT = 16;
+    constexpr u32 BANDS_PER_SCREEN = (CpuVideoFilter::SCREEN_HEIGHT + BAND_HEIGHT - 1) / BAND_HEIGHT;
+    constexpr u32 DISTANCE_BANDS_PER_SCREEN = (CpuVideoFilter::PADDED_HEIGHT + BAND_HEIGHT - 1) / BAND_HEIGHT;
+    constexpr u32 MAX_WORKER_COUNT = 2;
+}
+
+VideoFilterPipeline::VideoFilterPipeline() = default;
+
+VideoFilterPipeline::~VideoFilterPipeline() = default;
+
+void VideoFilterPipeline::setFilter(u32 filter)
+{
+    if (CpuVideoFilter::getScale(filter) == 0)
+        filter = CpuVideoFilter::FILTER_NONE;
+
+    currentFilter = filter;
+}
+
+bool VideoFilterPipeline::isEnabled()
+{
+    return currentFilter != CpuVideoFilter::FILTER_NONE;
+}
+
+void VideoFilterPipeline::submitFrame(const u8* screenshot)
+{
+    std::vector<u32>& slot = frameSlots[writeFrame];
+    slot.resize(PADDED_SCREEN_SIZE * SCREEN_COUNT);
+
+    const u32* screens = (const u32*) screenshot;
+    for (u32 screen = 0; screen < SCREEN_COUNT; screen++)
+    {
+        const u32* source = screens + screen * CpuVideoFilter::SCREEN_WIDTH * CpuVideoFilter::SCREEN_HEIGHT;
+        CpuVideoFilter::padScreen(source, slot.data() + screen * PADDED_SCREEN_SIZE);
+    }
+
+    writeFrame = latestFrame.exchange(writeFrame | FRAME_FRESH_FLAG) & FRAME_INDEX_MASK;
+}
+
+GLuint VideoFilterPipeline::renderLatestFrame()
+{
+    u32 filter = currentFilter;
+    u32 scale = CpuVideoFilter::getScale(filter);
+    if (scale == 0)
+    {
+        releaseTexture();
+        return 0;
+    }
+
+    if (resetRequested.exchange(false))
+    {
+        hasFrame = false;
+        latestFrame &= FRAME_INDEX_MASK;
+    }
+
+    if (latestFrame & FRAME_FRESH_FLAG)
+    {
+        readFrame = latestFrame.exchange(readFrame) & FRAME_INDEX_MASK;
+        hasFrame = true;
+        isOutputDirty = true;
+    }
+
+    if (!hasFrame)
+        return 0;
+
+    // Textures belong to the context they were created in. If the render thread's context was recreated, the old texture is gone with it
+    EGLContext context = eglGetCurrentContext();
+    if (context != textureContext)
+    {
+        texture = 0;
+        textureScale = 0;
+        textureContext = context;
+        isOutputDirty = true;
+    }
+
+    if (isOutputDirty || filter != outputFilter)
+    {
+        filterFrame(filter, scale);
+        uploadOutput(scale);
+        isOutputDirty = false;
+        outputFilter = filter;
+    }
+
+    return texture;
+}
+
+void VideoFilterPipeline::reset()
+{
+    resetRequested = true;
+}
+
+void VideoFilterPipeline::filterFrame(u32 filter, u32 scale)
+{
+    if (!workerPool)
+    {
+        // The emulator and render threads are already busy, so only use the remaining cores
+        u32 coreCount = std::thread::hardware_concurrency();
+        u32 workerCount = coreCount > 2 ? std::min(coreCount - 2, MAX_WORKER_COUNT) : 0;
+        workerPool = std::make_unique<FilterWorkerPool>(workerCount);
+    }
+
+    const u32* frame = frameSlots[readFrame].data();
+    u32 outputWidth = CpuVideoFilter::SCREEN_WIDTH * scale;
+    u32 screenOutputSize = outputWidth * CpuVideoFilter::SCREEN_HEIGHT * scale;
+    u32 gapSize = outputWidth * SCREEN_GAP_LINES * scale;
+
+    if (outputBuffer.size() != screenOutputSize * SCREEN_COUNT + gapSize)
+    {
+        // The gap between the screens is never written, so it stays black
+        outputBuffer.assign(screenOutputSize * SCREEN_COUNT + gapSize, 0);
+    }
+
+    u32 distancesSize = CpuVideoFilter::DISTANCE_PLANE_COUNT * CpuVideoFilter::DISTANCE_PLANE_SIZE;
+    bool needsDistances = CpuVideoFilter::needsDistances(filter);
+    if (needsDistances)
+    {
+        distanceBuffer.resize(distancesSize * SCREEN_COUNT);
+        workerPool->run(DISTANCE_BANDS_PER_SCREEN * SCREEN_COUNT, [&](u32 task) {
+            u32 screen = task / DISTANCE_BANDS_PER_SCREEN;
+            u32 firstRow = (task % DISTANCE_BANDS_PER_SCREEN) * BAND_HEIGHT;
+            u32 lastRow = std::min(firstRow + BAND_HEIGHT, CpuVideoFilter::PADDED_HEIGHT);
+            CpuVideoFilter::computeDistances(frame + screen * PADDED_SCREEN_SIZE, firstRow, lastRow, distanceBuffer.data() + screen * distancesSize);
+        });
+    }
+
+    workerPool->run(BANDS_PER_SCREEN * SCREEN_COUNT, [&](u32 task) {
+        u32 screen = task / BANDS_PER_SCREEN;
+        u32 firstRow = (task % BANDS_PER_SCREEN) * BAND_HEIGHT;
+        u32 lastRow = std::min(firstRow + BAND_HEIGHT, CpuVideoFilter::SCREEN_HEIGHT);
+        const u16* distances = needsDistances ? distanceBuffer.data() + screen * distancesSize : nullptr;
+        u32* output = outputBuffer.data() + screen * (screenOutputSize + gapSize);
+        CpuVideoFilter::filterRows(filter, frame + screen * PADDED_SCREEN_SIZE, distances, firstRow, lastRow, output, outputWidth);
+    });
+}
+
+void VideoFilterPipeline::uploadOutput(u32 scale)
+{
+    GLsizei width = CpuVideoFilter::SCREEN_WIDTH * scale;
+    GLsizei height = (CpuVideoFilter::SCREEN_HEIGHT * SCREEN_COUNT + SCREEN_GAP_LINES) * scale;
+
+    if (texture == 0)
+        glGenTextures(1, &texture);
+
+    glBindTexture(GL_TEXTURE_2D, texture);
+    // The pixels are BGRA, but are uploaded as RGBA. The renderers' shaders already swap the channels, as they do for the core's texture
+    if (textureScale != scale)
+    {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, outputBuffer.data());
+        textureScale = scale;
+    }
+    else
+    {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, outputBuffer.data());
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void VideoFilterPipeline::releaseTexture()
+{
+    if (texture != 0 && textureContext == eglGetCurrentContext())
+        glDeleteTextures(1, &texture);
+
+    texture = 0;
+    textureScale = 0;
+    textureContext = EGL_NO_CONTEXT;
+    hasFrame = false;
+    std::vector<u32>().swap(outputBuffer);
+    std::vector<u16>().swap(distanceBuffer);
+}
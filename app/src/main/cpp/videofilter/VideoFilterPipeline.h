@@ -0,0 +1,82 @@
+#ifndef MELONDS_ANDROID_VIDEOFILTERPIPELINE_H
+#define MELONDS_ANDROID_VIDEOFILTERPIPELINE_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <EGL/egl.h>
+#include <GLES3/gl32.h>
+#include "FilterWorkerPool.h"
+#include "types.h"
+
+/**
+ * Optional CPU upscaling stage between the emulator and the renderers. The emulator thread submits each frame's screenshot, and the render thread
+ * filters the newest submitted frame across a small worker pool and uploads it into a texture that replaces the core's frame texture. The texture
+ * keeps the layout of the core's texture (top screen, 2 line gap, bottom screen), scaled by the filter's scale factor, so the renderers do not need
+ * to know whether it was filtered.
+ *
+ * Frames are handed from the emulator thread to the render thread through a lock-free triple buffer, so neither thread ever waits for the other.
+ */
+class VideoFilterPipeline
+{
+public:
+    VideoFilterPipeline();
+    ~VideoFilterPipeline();
+
+    /**
+     * Sets the filter to apply (one of the CpuVideoFilter::FILTER_* values). Can be called from any thread.
+     */
+    void setFilter(melonDS::u32 filter);
+    bool isEnabled();
+
+    /**
+     * Copies the given screenshot (both screens, BGRA) for filtering. Must only be called from the emulator thread.
+     */
+    void submitFrame(const melonDS::u8* screenshot);
+
+    /**
+     * Filters the newest submitted frame, if it has not been filtered yet, and uploads it into the pipeline's texture. Must be called from the render
+     * thread, with its GL context current.
+     *
+     * @return The texture with the filtered frame, or 0 if filtering is disabled or no frame has been submitted yet
+     */
+    GLuint renderLatestFrame();
+
+    /**
+     * Discards the submitted frames, so that frames from the previous session are never presented. Can be called from any thread.
+     */
+    void reset();
+
+private:
+    static constexpr melonDS::u32 FRAME_SLOT_COUNT = 3;
+    static constexpr melonDS::u32 FRAME_FRESH_FLAG = 0x80;
+    static constexpr melonDS::u32 FRAME_INDEX_MASK = 0x7F;
+
+    std::atomic_uint32_t currentFilter = 0;
+    std::atomic_bool resetRequested = false;
+
+    // Padded copies of both screens for each slot of the triple buffer
+    std::vector<melonDS::u32> frameSlots[FRAME_SLOT_COUNT];
+    // Index of the newest submitted slot, with FRAME_FRESH_FLAG set if it has not been picked up by the render thread yet
+    std::atomic_uint32_t latestFrame = 0;
+    // Only accessed by the emulator thread
+    melonDS::u32 writeFrame = 1;
+
+    // Only accessed by the render thread
+    melonDS::u32 readFrame = 2;
+    bool hasFrame = false;
+    bool isOutputDirty = false;
+    melonDS::u32 outputFilter = 0;
+    std::vector<melonDS::u16> distanceBuffer;
+    std::vector<melonDS::u32> outputBuffer;
+    std::unique_ptr<FilterWorkerPool> workerPool;
+    GLuint texture = 0;
+    melonDS::u32 textureScale = 0;
+    EGLContext textureContext = EGL_NO_CONTEXT;
+
+    void filterFrame(melonDS::u32 filter, melonDS::u32 scale);
+    void uploadOutput(melonDS::u32 scale);
+    void releaseTexture();
+};
+
+#endif //MELONDS_ANDROID_VIDEOFILTERPIPELINE_H
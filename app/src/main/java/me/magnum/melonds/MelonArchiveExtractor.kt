@@ -0,0 +1,14 @@
+package me.magnum.melonds
+
+object MelonArchiveExtractor {
+    /**
+     * Returns the uncompressed size of the first file in the ZIP archive whose extension is one of [extensions], or -1 if there is no such file
+     * or the archive could not be read.
+     */
+    external fun getZipEntrySize(archiveFd: Int, extensions: Array<String>): Long
+
+    /**
+     * Extracts the first file in the ZIP archive whose extension is one of [extensions] into [outputFd]. Neither descriptor is closed.
+     */
+    external fun extractZipEntry(archiveFd: Int, outputFd: Int, extensions: Array<String>): Boolean
+}
@@ -0,0 +1,29 @@
+package me.magnum.melonds
+
+import java.nio.ByteBuffer
+
+object MelonCameraFrameConverter {
+    /**
+     * Size of a DSi camera frame: 640x480 pixels in YUV 4:2:2, with the byte structure YUYV YUYV (4 bytes per 2 pixels).
+     */
+    const val FRAME_SIZE = 640 * 480 * 2
+
+    /**
+     * Converts a YUV 4:2:0 camera image into a DSi camera frame. The image is rotated by [rotationDegrees] to make it upright, and is then scaled
+     * to fill the whole frame and cropped. All buffers must be direct, and [output] must have room for at least [FRAME_SIZE] bytes.
+     */
+    external fun convertYuv420ToYuyv(
+        yPlane: ByteBuffer,
+        uPlane: ByteBuffer,
+        vPlane: ByteBuffer,
+        width: Int,
+        height: Int,
+        yRowStride: Int,
+        uvRowStride: Int,
+        uvPixelStride: Int,
+        rotationDegrees: Int,
+        output: ByteBuffer,
+    )
+
+    external fun fillBlack(output: ByteBuffer)
+}
@@ -12,15 +12,19 @@ import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.GlobalScope
 import kotlinx.coroutines.launch
 import me.magnum.melonds.common.UriFileHandler
+import me.magnum.melonds.common.opengl.ShaderFactory
+import me.magnum.melonds.common.opengl.ShaderProgramCache
 import me.magnum.melonds.common.uridelegates.UriHandler
 import me.magnum.melonds.domain.repositories.SettingsRepository
 import me.magnum.melonds.migrations.Migrator
+import java.io.File
 import javax.inject.Inject
 
 @HiltAndroidApp
 class MelonDSApplication : Application(), Configuration.Provider {
     companion object {
         const val NOTIFICATION_CHANNEL_ID_BACKGROUND_TASKS = "channel_cheat_importing"
+        private const val SHADER_PROGRAM_CACHE_DIR = "shader_programs"
 
         init {
             System.loadLibrary("melonDS-android-frontend")
@@ -38,6 +42,7 @@ class MelonDSApplication : Application(), Configuration.Provider {
         applyTheme()
         performMigrations()
         MelonDSAndroidInterface.setup(UriFileHandler(this, uriHandler))
+        setupShaderProgramCache()
     }
 
     private fun createNotificationChannels() {
@@ -58,6 +63,16 @@ class MelonDSApplication : Application(), Configuration.Provider {
         }
     }
 
+    @OptIn(DelicateCoroutinesApi::class)
+    private fun setupShaderProgramCache() {
+        val programCache = ShaderProgramCache(File(filesDir, SHADER_PROGRAM_CACHE_DIR))
+        ShaderFactory.programCache = programCache
+        // Read the cached binaries before the first renderer is created, so that render threads never wait for them
+        GlobalScope.launch(Dispatchers.IO) {
+            programCache.preload()
+        }
+    }
+
     private fun performMigrations() {
         migrator.performMigrations()
     }
@@ -1,12 +1,29 @@
 package me.magnum.melonds
 
-import me.magnum.melonds.domain.model.DSiWareTitle
 import me.magnum.melonds.domain.model.EmulatorConfiguration
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationSerializer
+import java.nio.ByteBuffer
 
 object MelonDSiNand {
-    external fun openNand(emulatorConfiguration: EmulatorConfiguration): Int
-    external fun listTitles(): ArrayList<DSiWareTitle>
-    external fun importTitle(titleUri: String, tmdMetadata: ByteArray): Int
+    /**
+     * Opens the NAND. The metadata of the installed titles is cached in [titleCachePath], so that it does not have to be read from the NAND
+     * every time the titles are listed.
+     */
+    fun openNand(emulatorConfiguration: EmulatorConfiguration, titleCachePath: String): Int {
+        return openNand(EmulatorConfigurationSerializer.serialize(emulatorConfiguration), titleCachePath)
+    }
+
+    private external fun openNand(emulatorConfiguration: ByteBuffer, titleCachePath: String): Int
+
+    /**
+     * Returns the installed titles as a packed buffer. Use DSiWareTitleList to decode it.
+     */
+    external fun listTitles(): ByteArray
+    /**
+     * Imports the title at [titleUri], whose ID must have already been read from its header. If the import fails, the partially imported title is
+     * removed.
+     */
+    external fun importTitle(titleUri: String, titleId: Int, tmdMetadata: ByteArray): Int
     external fun deleteTitle(titleId: Int)
     external fun importTitleFile(titleId: Int, fileType: Int, fileUri: String): Boolean
     external fun exportTitleFile(titleId: Int, fileType: Int, fileUri: String): Boolean
@@ -5,12 +5,15 @@ import me.magnum.melonds.common.camera.DSiCameraSource
 import me.magnum.melonds.domain.model.Cheat
 import me.magnum.melonds.domain.model.EmulatorConfiguration
 import me.magnum.melonds.domain.model.Input
+import me.magnum.melonds.domain.model.emulator.EmulatorConfigurationChange
 import me.magnum.melonds.domain.model.retroachievements.RASimpleAchievement
 import me.magnum.melonds.domain.model.retroachievements.RASimpleLeaderboard
 import me.magnum.melonds.domain.model.retroachievements.RASimpleRuntimeAchievement
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationSerializer
 import me.magnum.melonds.ui.emulator.render.FrameRenderCallback
 import me.magnum.melonds.ui.emulator.rewind.model.RewindSaveState
 import me.magnum.melonds.ui.emulator.rewind.model.RewindWindow
+import java.io.File
 import java.nio.ByteBuffer
 
 object MelonEmulator {
@@ -45,10 +48,21 @@ object MelonEmulator {
         MEMORY_EXPANSION,
     }
 
-	external fun setupEmulator(
+    fun setupEmulator(
         emulatorConfiguration: EmulatorConfiguration,
         dsiCameraSource: DSiCameraSource?,
         screenshotBuffer: ByteBuffer,
+    ) {
+        setupEmulator(EmulatorConfigurationSerializer.serialize(emulatorConfiguration), dsiCameraSource, screenshotBuffer)
+    }
+
+    /**
+     * @param emulatorConfiguration The configuration serialized with [EmulatorConfigurationSerializer]
+     */
+    private external fun setupEmulator(
+        emulatorConfiguration: ByteBuffer,
+        dsiCameraSource: DSiCameraSource?,
+        screenshotBuffer: ByteBuffer,
     )
 
     external fun setupCheats(cheats: Array<Cheat>)
@@ -95,11 +109,19 @@ object MelonEmulator {
 
 	external fun stopEmulation()
 
-    fun saveState(path: Uri): Boolean {
-        return saveStateInternal(path.toString())
+    /**
+     * Serializes the current state into memory and queues it to be written to [path] in the background. The state is first written to
+     * [temporaryPath] and then moved over [path]. If [screenshotFile] is provided, the current screen is encoded as PNG into that file once the
+     * state has been written. Completion is reported with the given [requestId] through
+     * [me.magnum.melonds.impl.emulator.EmulatorEventType.EventSaveStateWritten].
+     *
+     * @return False if the state could not be serialized. In that case, no completion event is reported
+     */
+    fun saveStateAsync(path: Uri, temporaryPath: Uri, screenshotFile: File?, requestId: Int): Boolean {
+        return saveStateAsyncInternal(path.toString(), temporaryPath.toString(), screenshotFile?.absolutePath, requestId)
     }
 
-    private external fun saveStateInternal(path: String): Boolean
+    private external fun saveStateAsyncInternal(path: String, temporaryPath: String, screenshotPath: String?, requestId: Int): Boolean
 
     fun loadState(path: Uri): Boolean {
         return loadStateInternal(path.toString())
@@ -107,9 +129,31 @@ object MelonEmulator {
 
     private external fun loadStateInternal(path: String): Boolean
 
-    external fun loadRewindState(rewindSaveState: RewindSaveState): Boolean
+    fun loadRewindState(rewindSaveState: RewindSaveState): Boolean {
+        return loadRewindStateInternal(rewindSaveState.frame)
+    }
+
+    private external fun loadRewindStateInternal(frame: Int): Boolean
 
-    external fun getRewindWindow(): RewindWindow
+    // Native descriptor table shared by all rewind windows. Native code only replaces it when the table has to grow
+    private var rewindWindowTable: ByteBuffer? = null
+
+    fun getRewindWindow(): RewindWindow {
+        val tableSize = writeRewindWindowTable()
+        val table = rewindWindowTable?.takeIf { it.capacity() == tableSize } ?: getRewindWindowTable().also { rewindWindowTable = it }
+        return RewindWindow(table, ::getRewindStateThumbnail)
+    }
+
+    /**
+     * Writes the descriptor table of the current rewind window into native memory.
+     *
+     * @return The size of the native table
+     */
+    private external fun writeRewindWindowTable(): Int
+
+    private external fun getRewindWindowTable(): ByteBuffer
+
+    private external fun getRewindStateThumbnail(frame: Int, thumbnailBuffer: ByteBuffer): Boolean
 
 	external fun onScreenTouch(x: Int, y: Int)
 
@@ -131,5 +175,20 @@ object MelonEmulator {
 
     external fun setMicrophoneEnabled(enabled: Boolean)
 
-    external fun updateEmulatorConfiguration(emulatorConfiguration: EmulatorConfiguration)
+    /**
+     * Sets the CPU upscaling filter applied to frames before they are presented. 0 disables it.
+     */
+    external fun setCpuVideoFilter(filter: Int)
+
+    /**
+     * Updates the configuration of the running emulator. Only the fields that changed since the last update are applied.
+     *
+     * @return The classes of the changes that were found in the configuration
+     */
+    fun updateEmulatorConfiguration(emulatorConfiguration: EmulatorConfiguration): Set<EmulatorConfigurationChange> {
+        val changeFlags = updateEmulatorConfiguration(EmulatorConfigurationSerializer.serialize(emulatorConfiguration))
+        return EmulatorConfigurationChange.fromFlags(changeFlags)
+    }
+
+    private external fun updateEmulatorConfiguration(emulatorConfiguration: ByteBuffer): Int
 }
\ No newline at end of file
@@ -0,0 +1,10 @@
+package me.magnum.melonds
+
+object MelonHasher {
+    /**
+     * Computes the standard CRC-32 (as used by ZIP and zlib) of [length] bytes of [data] starting at [offset].
+     */
+    external fun crc32(data: ByteArray, offset: Int = 0, length: Int = data.size): Int
+
+    external fun md5(data: ByteArray): ByteArray
+}
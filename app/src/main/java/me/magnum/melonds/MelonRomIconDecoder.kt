@@ -0,0 +1,17 @@
+package me.magnum.melonds
+
+import java.nio.ByteBuffer
+
+object MelonRomIconDecoder {
+    const val ICON_SIZE = 32
+    const val ICON_BYTE_SIZE = ICON_SIZE * ICON_SIZE * 4
+
+    /**
+     * Decodes the banner icons of the NDS ROMs behind [fds] into [atlas], a direct buffer with room for [ICON_BYTE_SIZE] bytes per ROM. Icons are
+     * stored as RGBA (the layout of ARGB_8888 bitmaps) and stacked vertically, so the icon of ROM i starts at byte i * [ICON_BYTE_SIZE].
+     * Descriptors are not closed.
+     *
+     * @return Whether the icon of each ROM could be decoded, or null if the atlas is too small
+     */
+    external fun decodeRomIcons(fds: IntArray, atlas: ByteBuffer): BooleanArray?
+}
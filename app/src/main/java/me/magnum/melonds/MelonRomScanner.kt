@@ -0,0 +1,13 @@
+package me.magnum.melonds
+
+import java.nio.ByteBuffer
+
+object MelonRomScanner {
+    /**
+     * Scans the NDS ROMs behind [fds] in parallel and writes one result per ROM into [resultBuffer], which must be a direct buffer with room for
+     * all of them (see RomScanResults). Descriptors are not closed. Invalid descriptors produce a failed result.
+     *
+     * @return False if the result buffer is too small, in which case nothing is scanned
+     */
+    external fun scanRoms(fds: IntArray, resultBuffer: ByteBuffer): Boolean
+}
@@ -43,4 +43,8 @@ class UriFileHandler(private val context: Context, private val uriHandler: UriHa
             }
         } ?: FILE_NOT_FOUND
     }
+
+    fun replace(sourceUriString: String, targetUriString: String): Boolean {
+        return uriHandler.replaceFile(sourceUriString.toUri(), targetUriString.toUri())
+    }
 }
\ No newline at end of file
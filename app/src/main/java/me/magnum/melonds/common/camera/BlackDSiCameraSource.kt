@@ -1,7 +1,16 @@
 package me.magnum.melonds.common.camera
 
+import me.magnum.melonds.MelonCameraFrameConverter
+import java.nio.ByteBuffer
+
 class BlackDSiCameraSource : DSiCameraSource {
 
+    private val blackFrame by lazy {
+        ByteBuffer.allocateDirect(MelonCameraFrameConverter.FRAME_SIZE).also {
+            MelonCameraFrameConverter.fillBlack(it)
+        }
+    }
+
     override fun isAvailable() = true
 
     override fun startCamera(camera: CameraType) {
@@ -10,12 +19,8 @@ class BlackDSiCameraSource : DSiCameraSource {
     override fun stopCamera(camera: CameraType) {
     }
 
-    override fun captureFrame(camera: CameraType, buffer: ByteArray, width: Int, height: Int, isYuv: Boolean) {
-        for (i in buffer.indices step 2) {
-            // Use 0 for luminance (Y) and 127 for color (U and V)
-            buffer[i] = 0
-            buffer[i + 1] = 127
-        }
+    override fun captureFrame(camera: CameraType, width: Int, height: Int, isYuv: Boolean): ByteBuffer {
+        return blackFrame
     }
 
     override fun dispose() {
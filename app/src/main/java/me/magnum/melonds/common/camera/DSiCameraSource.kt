@@ -1,5 +1,7 @@
 package me.magnum.melonds.common.camera
 
+import java.nio.ByteBuffer
+
 typealias CameraType = Int
 
 interface DSiCameraSource {
@@ -12,6 +14,11 @@ interface DSiCameraSource {
     fun isAvailable(): Boolean
     fun startCamera(camera: CameraType)
     fun stopCamera(camera: CameraType)
-    fun captureFrame(camera: CameraType, buffer: ByteArray, width: Int, height: Int, isYuv: Boolean)
+    /**
+     * Returns a direct buffer with the latest frame of the given camera, in the format described by MelonCameraFrameConverter.FRAME_SIZE, or
+     * null if there is no frame. The buffer is read right away, so it can be reused once the next frame is available, but it must not be modified
+     * while being read.
+     */
+    fun captureFrame(camera: CameraType, width: Int, height: Int, isYuv: Boolean): ByteBuffer?
     fun dispose()
 }
\ No newline at end of file
@@ -0,0 +1,37 @@
+package me.magnum.melonds.common.contracts
+
+import android.app.Activity
+import android.content.Context
+import android.content.Intent
+import android.net.Uri
+import androidx.activity.result.contract.ActivityResultContract
+import me.magnum.melonds.common.Permission
+
+/**
+ * {@link ActivityResultContract} that launches the document picker allowing the user to select multiple documents, and returns the Uris of the selected documents. The
+ * input is the list of mime-types of the selectable documents. If no mime-type is specified, it is assumed that all document types can be selected.
+ */
+class MultipleFilePickerContract(private val permission: Permission) : ActivityResultContract<Array<String>?, List<Uri>>() {
+
+    override fun createIntent(context: Context, input: Array<String>?): Intent {
+        return Intent(Intent.ACTION_OPEN_DOCUMENT)
+            .putExtra(Intent.EXTRA_MIME_TYPES, input ?: arrayOf("*/*"))
+            .putExtra(Intent.EXTRA_ALLOW_MULTIPLE, true)
+            .setType("*/*")
+            .addCategory(Intent.CATEGORY_OPENABLE)
+            .addFlags(permission.toFlags())
+    }
+
+    override fun parseResult(resultCode: Int, intent: Intent?): List<Uri> {
+        if (intent == null || resultCode != Activity.RESULT_OK) {
+            return emptyList()
+        }
+
+        val clipData = intent.clipData
+        return if (clipData != null) {
+            List(clipData.itemCount) { clipData.getItemAt(it).uri }
+        } else {
+            listOfNotNull(intent.data)
+        }
+    }
+}
@@ -4,33 +4,60 @@ import android.opengl.GLES30
 import android.util.Log
 
 object ShaderFactory {
+    /**
+     * Cache used to skip shader compilation for programs that have been linked before. Programs are always compiled from source if it is not set.
+     */
+    @Volatile
+    var programCache: ShaderProgramCache? = null
+
     fun createShaderProgram(source: ShaderProgramSource): Shader {
-        val vertexShader = createShader(GLES30.GL_VERTEX_SHADER, source.vertexShaderSource)
-        val fragmentShader = createShader(GLES30.GL_FRAGMENT_SHADER, source.fragmentShaderSource)
-        val shaderProgram = createShaderProgram(vertexShader, fragmentShader)
         val textureFilter = when (source.textureFiltering) {
             ShaderProgramSource.TextureFiltering.NEAREST -> GLES30.GL_NEAREST
             ShaderProgramSource.TextureFiltering.LINEAR -> GLES30.GL_LINEAR
         }
 
+        val cache = programCache
+        val cacheKey = cache?.getKey(source)
+        if (cache != null && cacheKey != null) {
+            val cachedProgram = cache.loadProgram(cacheKey)
+            if (cachedProgram != 0) {
+                // Programs loaded from a binary have no shader objects
+                return Shader(0, 0, cachedProgram, textureFilter)
+            }
+        }
+
+        val vertexShader = createShader(GLES30.GL_VERTEX_SHADER, source.vertexShaderSource)
+        val fragmentShader = createShader(GLES30.GL_FRAGMENT_SHADER, source.fragmentShaderSource)
+        val shaderProgram = createShaderProgram(vertexShader, fragmentShader, cacheKey != null)
+        if (cache != null && cacheKey != null && isProgramLinked(shaderProgram)) {
+            cache.storeProgram(cacheKey, shaderProgram)
+        }
+
         return Shader(vertexShader, fragmentShader, shaderProgram, textureFilter)
     }
 
-    private fun createShaderProgram(vertexShader: Int, fragmentShader: Int): Int {
+    private fun createShaderProgram(vertexShader: Int, fragmentShader: Int, isBinaryRetrievable: Boolean): Int {
         val program = GLES30.glCreateProgram()
         GLES30.glAttachShader(program, vertexShader)
         GLES30.glAttachShader(program, fragmentShader)
+        if (isBinaryRetrievable) {
+            GLES30.glProgramParameteri(program, GLES30.GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GLES30.GL_TRUE)
+        }
         GLES30.glLinkProgram(program)
-        val result = IntArray(1)
-        GLES30.glGetProgramiv(program, GLES30.GL_LINK_STATUS, result, 0)
 
-        if (result[0] == GLES30.GL_FALSE) {
+        if (!isProgramLinked(program)) {
             Log.e("ShaderFactory", GLES30.glGetProgramInfoLog(program))
         }
 
         return program
     }
 
+    private fun isProgramLinked(program: Int): Boolean {
+        val result = IntArray(1)
+        GLES30.glGetProgramiv(program, GLES30.GL_LINK_STATUS, result, 0)
+        return result[0] != GLES30.GL_FALSE
+    }
+
     private fun createShader(shaderType: Int, code: String): Int {
         val shader = GLES30.glCreateShader(shaderType)
         GLES30.glShaderSource(shader, code)
@@ -0,0 +1,187 @@
+package me.magnum.melonds.common.opengl
+
+import android.opengl.GLES30
+import android.util.Log
+import java.io.File
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import java.security.MessageDigest
+import java.util.concurrent.ConcurrentHashMap
+import java.util.concurrent.Executors
+import java.util.concurrent.TimeUnit
+
+/**
+ * Persistent cache of linked shader program binaries. Entries are keyed by a hash of the shader sources and the identity of the GL driver, so
+ * binaries are never handed to a different driver or driver version. Drivers may still reject a binary (after a driver update that does not change
+ * the version string, for example), in which case the entry is discarded and the program is compiled from source.
+ *
+ * Binaries are read from disk by [preload], which is meant to be called in the background before any renderer is created. Loading a program on
+ * a render thread never waits for I/O: if preloading has not finished yet, the program is compiled from source instead. Writes happen on a
+ * background thread.
+ *
+ * Every time a binary is used, its file is touched, and [preload] deletes binaries that have not been used for [MAX_ENTRY_AGE_MS]. This removes
+ * the binaries of previous drivers, which are never used again once the driver is updated.
+ */
+class ShaderProgramCache(private val cacheDirectory: File) {
+
+    companion object {
+        private const val TAG = "ShaderProgramCache"
+        private const val MAGIC = 0x50475348 // "HSGP"
+        private const val FORMAT_VERSION = 1
+        private const val HEADER_SIZE = 12
+        private const val ENTRY_EXTENSION = "bin"
+        private val MAX_ENTRY_AGE_MS = TimeUnit.DAYS.toMillis(30)
+    }
+
+    private class Entry(val binaryFormat: Int, val binary: ByteArray)
+
+    private val entries = ConcurrentHashMap<String, Entry>()
+    private val writeExecutor = Executors.newSingleThreadExecutor()
+    @Volatile
+    private var isPreloaded = false
+
+    fun preload() {
+        if (isPreloaded) {
+            return
+        }
+
+        val now = System.currentTimeMillis()
+        cacheDirectory.listFiles { file -> file.extension == ENTRY_EXTENSION }?.forEach { file ->
+            if (now - file.lastModified() > MAX_ENTRY_AGE_MS) {
+                file.delete()
+                return@forEach
+            }
+
+            val entry = readEntry(file)
+            if (entry != null) {
+                entries.putIfAbsent(file.nameWithoutExtension, entry)
+            } else {
+                file.delete()
+            }
+        }
+        isPreloaded = true
+    }
+
+    /**
+     * Returns the cache key of the given program for the driver of the current GL context, or null if the driver does not support program binaries.
+     */
+    fun getKey(source: ShaderProgramSource): String? {
+        val formatCount = IntArray(1)
+        GLES30.glGetIntegerv(GLES30.GL_NUM_PROGRAM_BINARY_FORMATS, formatCount, 0)
+        if (formatCount[0] <= 0) {
+            return null
+        }
+
+        val digest = MessageDigest.getInstance("SHA-256")
+        listOf(
+            GLES30.glGetString(GLES30.GL_VENDOR),
+            GLES30.glGetString(GLES30.GL_RENDERER),
+            GLES30.glGetString(GLES30.GL_VERSION),
+            source.vertexShaderSource,
+            source.fragmentShaderSource,
+        ).forEach {
+            digest.update(it.orEmpty().toByteArray(Charsets.UTF_8))
+            digest.update(0)
+        }
+        return digest.digest().joinToString("") { "%02x".format(it) }
+    }
+
+    /**
+     * Creates a program from the cached binary with the given key. Must be called with a GL context current.
+     *
+     * @return The linked program, or 0 if there is no binary for the key, if it has not been preloaded yet or if the driver rejected it
+     */
+    fun loadProgram(key: String): Int {
+        val entry = entries[key] ?: return 0
+
+        val program = GLES30.glCreateProgram()
+        val binary = ByteBuffer.allocateDirect(entry.binary.size).order(ByteOrder.nativeOrder())
+        binary.put(entry.binary).flip()
+        GLES30.glProgramBinary(program, entry.binaryFormat, binary, entry.binary.size)
+
+        val result = IntArray(1)
+        GLES30.glGetProgramiv(program, GLES30.GL_LINK_STATUS, result, 0)
+        if (result[0] == GLES30.GL_FALSE) {
+            Log.i(TAG, "Cached program binary was rejected by the driver")
+            GLES30.glDeleteProgram(program)
+            entries.remove(key)
+            writeExecutor.execute { getEntryFile(key).delete() }
+            return 0
+        }
+
+        writeExecutor.execute { getEntryFile(key).setLastModified(System.currentTimeMillis()) }
+        return program
+    }
+
+    /**
+     * Stores the binary of a linked program. The program must have been linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set, and the GL context it
+     * belongs to must be current.
+     */
+    fun storeProgram(key: String, program: Int) {
+        val length = IntArray(1)
+        GLES30.glGetProgramiv(program, GLES30.GL_PROGRAM_BINARY_LENGTH, length, 0)
+        if (length[0] <= 0) {
+            return
+        }
+
+        val binary = ByteBuffer.allocateDirect(length[0]).order(ByteOrder.nativeOrder())
+        val binaryLength = IntArray(1)
+        val binaryFormat = IntArray(1)
+        GLES30.glGetProgramBinary(program, length[0], binaryLength, 0, binaryFormat, 0, binary)
+        if (binaryLength[0] <= 0) {
+            return
+        }
+
+        val data = ByteArray(binaryLength[0])
+        binary.get(data)
+        val entry = Entry(binaryFormat[0], data)
+        entries[key] = entry
+        writeExecutor.execute { writeEntry(getEntryFile(key), entry) }
+    }
+
+    private fun getEntryFile(key: String): File {
+        return File(cacheDirectory, "$key.$ENTRY_EXTENSION")
+    }
+
+    private fun readEntry(file: File): Entry? {
+        if (!file.isFile) {
+            return null
+        }
+
+        return try {
+            val buffer = ByteBuffer.wrap(file.readBytes()).order(ByteOrder.LITTLE_ENDIAN)
+            if (buffer.remaining() < HEADER_SIZE || buffer.getInt() != MAGIC || buffer.getInt() != FORMAT_VERSION) {
+                return null
+            }
+
+            val binaryFormat = buffer.getInt()
+            val binary = ByteArray(buffer.remaining())
+            buffer.get(binary)
+            Entry(binaryFormat, binary)
+        } catch (e: Exception) {
+            Log.w(TAG, "Failed to read cached program binary", e)
+            null
+        }
+    }
+
+    private fun writeEntry(file: File, entry: Entry) {
+        val buffer = ByteBuffer.allocate(HEADER_SIZE + entry.binary.size).order(ByteOrder.LITTLE_ENDIAN)
+        buffer.putInt(MAGIC)
+        buffer.putInt(FORMAT_VERSION)
+        buffer.putInt(entry.binaryFormat)
+        buffer.put(entry.binary)
+
+        // Write to a temporary file first, so that an interrupted write never leaves a truncated binary behind
+        val temporaryFile = File(cacheDirectory, "${file.name}.tmp")
+        try {
+            cacheDirectory.mkdirs()
+            temporaryFile.writeBytes(buffer.array())
+            if (!temporaryFile.renameTo(file)) {
+                temporaryFile.delete()
+            }
+        } catch (e: Exception) {
+            Log.w(TAG, "Failed to write program binary to cache", e)
+            temporaryFile.delete()
+        }
+    }
+}
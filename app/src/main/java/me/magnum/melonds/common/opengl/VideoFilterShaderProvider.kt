@@ -12,6 +12,11 @@ object VideoFilterShaderProvider {
         VideoFiltering.QUILEZ to ShaderProgramSource.QuilezShader,
         VideoFiltering.LCD to ShaderProgramSource.LcdShader,
         VideoFiltering.SCANLINES to ShaderProgramSource.ScanlinesShader,
+        // CPU filters upscale the frame before it is uploaded. Linear filtering then only blends the edges of the upscaled pixels
+        VideoFiltering.SCALE2X_CPU to ShaderProgramSource.LinearShader,
+        VideoFiltering.SCALE3X_CPU to ShaderProgramSource.LinearShader,
+        VideoFiltering.XBR_LITE_CPU to ShaderProgramSource.LinearShader,
+        VideoFiltering.SHARP_BILINEAR_CPU to ShaderProgramSource.LinearShader,
     )
 
     fun getShaderSource(filtering: VideoFiltering): ShaderProgramSource =
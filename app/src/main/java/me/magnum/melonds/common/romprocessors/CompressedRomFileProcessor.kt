@@ -3,6 +3,7 @@ package me.magnum.melonds.common.romprocessors
 import android.content.Context
 import android.graphics.Bitmap
 import android.net.Uri
+import android.os.ParcelFileDescriptor
 import io.reactivex.Single
 import me.magnum.melonds.common.uridelegates.UriHandler
 import me.magnum.melonds.domain.model.*
@@ -23,8 +24,9 @@ abstract class CompressedRomFileProcessor(private val context: Context, private
     private class CouldNotFindNdsRomException : Exception("Failed to find an NDS ROM to extract")
     private class CouldNotFindExtractedFileException : Exception("Failed to find extracted NDS ROM file")
 
-    private companion object {
+    protected companion object {
         val SUPPORTED_ROM_EXTENSIONS = listOf("nds", "dsi", "ids")
+        private const val EXTRACTION_BUFFER_SIZE = 1024 * 1024
     }
 
     override fun getRomFromUri(romUri: Uri, parentUri: Uri?): Rom? {
@@ -106,6 +108,14 @@ abstract class CompressedRomFileProcessor(private val context: Context, private
 
     private fun extractRomFile(rom: Rom): Single<Uri> {
         return Single.create { emitter ->
+            if (extractRomFileNatively(rom)) {
+                val cachedRomUri = ndsRomCache.getCachedRomFile(rom)
+                if (cachedRomUri != null) {
+                    emitter.onSuccess(cachedRomUri)
+                    return@create
+                }
+            }
+
             context.contentResolver.openInputStream(rom.uri)?.use {
                 getNdsEntryStreamInFileStream(it)?.use { romFileStream ->
                     ndsRomCache.cacheRom(rom, object : NdsRomCache.RomExtractor {
@@ -114,7 +124,7 @@ abstract class CompressedRomFileProcessor(private val context: Context, private
                         }
 
                         override fun saveRomFile(fileStream: FileOutputStream): Boolean {
-                            val buffer = ByteArray(8192)
+                            val buffer = ByteArray(EXTRACTION_BUFFER_SIZE)
 
                             try {
                                 do {
@@ -146,6 +156,28 @@ abstract class CompressedRomFileProcessor(private val context: Context, private
         }
     }
 
+    private fun extractRomFileNatively(rom: Rom): Boolean {
+        return try {
+            context.contentResolver.openFileDescriptor(rom.uri, "r")?.use { archiveDescriptor ->
+                val romExtractor = getNativeRomExtractor(archiveDescriptor) ?: return false
+                ndsRomCache.cacheRom(rom, romExtractor)
+                true
+            } ?: false
+        } catch (e: Exception) {
+            e.printStackTrace()
+            false
+        }
+    }
+
+    /**
+     * Returns a [NdsRomCache.RomExtractor] that extracts the ROM natively, reading straight from the archive's file descriptor. May return null if the
+     * archive format is not supported natively or if a ROM entry was not found, in which case the ROM is extracted through the stream returned by
+     * [getNdsEntryStreamInFileStream].
+     */
+    protected open fun getNativeRomExtractor(archiveDescriptor: ParcelFileDescriptor): NdsRomCache.RomExtractor? {
+        return null
+    }
+
     /**
      * Retrieves the [RomFileStream] that points to the ROM in the compressed file. May return null if a ROM entry was not found in the compressed archive.
      */
@@ -3,7 +3,12 @@ package me.magnum.melonds.common.romprocessors
 import android.content.Context
 import android.graphics.Bitmap
 import android.net.Uri
+import android.os.SystemClock
+import android.util.Log
+import androidx.core.graphics.createBitmap
 import io.reactivex.Single
+import me.magnum.melonds.MelonRomIconDecoder
+import me.magnum.melonds.MelonRomScanner
 import me.magnum.melonds.common.uridelegates.UriHandler
 import me.magnum.melonds.domain.model.rom.Rom
 import me.magnum.melonds.domain.model.rom.config.RomConfig
@@ -12,25 +17,20 @@ import me.magnum.melonds.domain.model.RomMetadata
 import me.magnum.melonds.extensions.isBlank
 import me.magnum.melonds.extensions.nameWithoutExtension
 import me.magnum.melonds.utils.RomProcessor
+import java.nio.ByteBuffer
 
 class NdsRomFileProcessor(private val context: Context, private val uriHandler: UriHandler) : RomFileProcessor {
 
+    companion object {
+        private const val TAG = "NdsRomFileProcessor"
+    }
+
+    override val supportsIconPrefetch = true
+
     override fun getRomFromUri(romUri: Uri, parentUri: Uri?): Rom? {
         return try {
             getRomMetadata(romUri)?.let { metadata ->
-                val romDocument = uriHandler.getUriDocument(romUri)
-                val romName = metadata.romTitle.takeUnless { it.isBlank() } ?: romDocument?.nameWithoutExtension ?: ""
-                Rom(
-                    name = romName,
-                    developerName = metadata.developerName,
-                    fileName = romDocument?.name ?: "",
-                    uri = romUri,
-                    parentTreeUri = parentUri,
-                    config = if (metadata.isDSiWareTitle) RomConfig.forDsiWareTitle() else RomConfig.default(),
-                    lastPlayed = null,
-                    isDsiWareTitle = metadata.isDSiWareTitle,
-                    retroAchievementsHash = metadata.retroAchievementsHash
-                )
+                buildRom(romUri, parentUri, metadata)
             }
         } catch (e: Exception) {
             e.printStackTrace()
@@ -38,14 +38,78 @@ class NdsRomFileProcessor(private val context: Context, private val uriHandler:
         }
     }
 
+    /**
+     * Scans all ROMs at once with the native scanner, which reads them in parallel. ROMs that the native scanner fails to process go through
+     * [getRomFromUri] instead.
+     */
+    override fun getRomsFromUris(romUris: List<Uri>, parentUri: Uri?): List<Rom?> {
+        val descriptors = romUris.map { uri ->
+            try {
+                context.contentResolver.openFileDescriptor(uri, "r")
+            } catch (e: Exception) {
+                null
+            }
+        }
+
+        return try {
+            val results = RomScanResults.allocate(romUris.size)
+            val fds = IntArray(romUris.size) { descriptors[it]?.fd ?: -1 }
+            val startTime = SystemClock.elapsedRealtime()
+            if (!MelonRomScanner.scanRoms(fds, results.buffer)) {
+                return romUris.map { getRomFromUri(it, parentUri) }
+            }
+            Log.d(TAG, "Natively scanned ${romUris.size} ROMs in ${SystemClock.elapsedRealtime() - startTime} ms")
+
+            romUris.mapIndexed { index, romUri ->
+                val metadata = results.getMetadata(index)
+                if (metadata != null) {
+                    buildRom(romUri, parentUri, metadata)
+                } else {
+                    getRomFromUri(romUri, parentUri)
+                }
+            }
+        } finally {
+            descriptors.forEach { it?.close() }
+        }
+    }
+
     override fun getRomIcon(rom: Rom): Bitmap? {
+        return getRomIcons(listOf(rom)).first()
+    }
+
+    /**
+     * Decodes the icons of all ROMs at once with the native decoder, which reads only the icon part of each banner.
+     */
+    override fun getRomIcons(roms: List<Rom>): List<Bitmap?> {
+        val descriptors = roms.map { rom ->
+            try {
+                context.contentResolver.openFileDescriptor(rom.uri, "r")
+            } catch (e: Exception) {
+                null
+            }
+        }
+
         return try {
-            context.contentResolver.openInputStream(rom.uri)?.use { inputStream ->
-                RomProcessor.getRomIcon(inputStream)
+            val atlas = ByteBuffer.allocateDirect(roms.size * MelonRomIconDecoder.ICON_BYTE_SIZE)
+            val fds = IntArray(roms.size) { descriptors[it]?.fd ?: -1 }
+            val decodedIcons = MelonRomIconDecoder.decodeRomIcons(fds, atlas) ?: return roms.map { null }
+
+            roms.indices.map { index ->
+                if (decodedIcons[index]) {
+                    val iconOffset = index * MelonRomIconDecoder.ICON_BYTE_SIZE
+                    val iconBuffer = atlas.duplicate().apply {
+                        position(iconOffset)
+                        limit(iconOffset + MelonRomIconDecoder.ICON_BYTE_SIZE)
+                    }
+                    createBitmap(MelonRomIconDecoder.ICON_SIZE, MelonRomIconDecoder.ICON_SIZE).apply {
+                        copyPixelsFromBuffer(iconBuffer)
+                    }
+                } else {
+                    null
+                }
             }
-        } catch (e: Exception) {
-            e.printStackTrace()
-            null
+        } finally {
+            descriptors.forEach { it?.close() }
         }
     }
 
@@ -64,6 +128,22 @@ class NdsRomFileProcessor(private val context: Context, private val uriHandler:
         return Single.just(rom.uri)
     }
 
+    private fun buildRom(romUri: Uri, parentUri: Uri?, metadata: RomMetadata): Rom {
+        val romDocument = uriHandler.getUriDocument(romUri)
+        val romName = metadata.romTitle.takeUnless { it.isBlank() } ?: romDocument?.nameWithoutExtension ?: ""
+        return Rom(
+            name = romName,
+            developerName = metadata.developerName,
+            fileName = romDocument?.name ?: "",
+            uri = romUri,
+            parentTreeUri = parentUri,
+            config = if (metadata.isDSiWareTitle) RomConfig.forDsiWareTitle() else RomConfig.default(),
+            lastPlayed = null,
+            isDsiWareTitle = metadata.isDSiWareTitle,
+            retroAchievementsHash = metadata.retroAchievementsHash
+        )
+    }
+
     private fun getRomMetadata(uri: Uri): RomMetadata? {
         return context.contentResolver.openInputStream(uri)?.use { inputStream ->
             RomProcessor.getRomMetadata(inputStream)
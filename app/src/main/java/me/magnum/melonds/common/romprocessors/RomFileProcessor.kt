@@ -8,7 +8,29 @@ import me.magnum.melonds.domain.model.RomInfo
 
 interface RomFileProcessor {
     fun getRomFromUri(romUri: Uri, parentUri: Uri?): Rom?
+
+    /**
+     * Batch version of [getRomFromUri]. The returned list has one entry per URI, in the same order.
+     */
+    fun getRomsFromUris(romUris: List<Uri>, parentUri: Uri?): List<Rom?> {
+        return romUris.map { getRomFromUri(it, parentUri) }
+    }
+
+    /**
+     * Whether [getRomIcons] decodes icons cheaply enough to prefetch them for the whole ROM list. Processors that have to extract ROMs from
+     * archives should leave this disabled, so that their icons are only decoded when they are displayed.
+     */
+    val supportsIconPrefetch: Boolean get() = false
+
     fun getRomIcon(rom: Rom): Bitmap?
+
+    /**
+     * Batch version of [getRomIcon]. The returned list has one entry per ROM, in the same order.
+     */
+    fun getRomIcons(roms: List<Rom>): List<Bitmap?> {
+        return roms.map { getRomIcon(it) }
+    }
+
     fun getRomInfo(rom: Rom): RomInfo?
     fun getRealRomUri(rom: Rom): Single<Uri>
 }
\ No newline at end of file
@@ -6,4 +6,5 @@ import androidx.documentfile.provider.DocumentFile
 interface RomFileProcessorFactory {
     fun getFileRomProcessorForDocument(romDocument: DocumentFile): RomFileProcessor?
     fun getFileRomProcessorForDocument(romUri: Uri): RomFileProcessor?
+    fun getFileRomProcessorForFileName(fileName: String): RomFileProcessor?
 }
\ No newline at end of file
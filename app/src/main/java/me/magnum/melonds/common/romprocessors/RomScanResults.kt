@@ -0,0 +1,72 @@
+package me.magnum.melonds.common.romprocessors
+
+import me.magnum.melonds.domain.model.RomMetadata
+import me.magnum.melonds.utils.RomProcessor
+import java.math.BigInteger
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+/**
+ * View over the packed results written by [me.magnum.melonds.MelonRomScanner]. Values are only decoded when requested.
+ *
+ * The layout must match RomMetadataScanner::ScanResult.
+ */
+class RomScanResults private constructor(val buffer: ByteBuffer, val count: Int) {
+
+    companion object {
+        private const val RESULT_SIZE = 280
+        private const val STATUS_OFFSET = 0
+        private const val FLAGS_OFFSET = 4
+        private const val RETROACHIEVEMENTS_HASH_OFFSET = 8
+        private const val RETROACHIEVEMENTS_HASH_SIZE = 16
+        private const val BANNER_TITLE_OFFSET = 24
+        private const val BANNER_TITLE_SIZE = 256
+
+        private const val STATUS_OK = 0
+        private const val FLAG_DSIWARE = 1 shl 0
+        private const val FLAG_HAS_BANNER = 1 shl 1
+
+        fun allocate(count: Int): RomScanResults {
+            val buffer = ByteBuffer.allocateDirect(count * RESULT_SIZE).order(ByteOrder.nativeOrder())
+            return RomScanResults(buffer, count)
+        }
+    }
+
+    fun isSuccessful(index: Int): Boolean {
+        return buffer.getInt(index * RESULT_SIZE + STATUS_OFFSET) == STATUS_OK
+    }
+
+    /**
+     * Returns the metadata of the ROM at the given index, or null if it could not be scanned.
+     */
+    fun getMetadata(index: Int): RomMetadata? {
+        if (!isSuccessful(index)) {
+            return null
+        }
+
+        val resultOffset = index * RESULT_SIZE
+        val flags = buffer.getInt(resultOffset + FLAGS_OFFSET)
+        val (title, developer) = if (flags and FLAG_HAS_BANNER != 0) {
+            RomProcessor.parseBannerTitle(readBytes(resultOffset + BANNER_TITLE_OFFSET, BANNER_TITLE_SIZE))
+        } else {
+            "" to ""
+        }
+
+        val hashData = readBytes(resultOffset + RETROACHIEVEMENTS_HASH_OFFSET, RETROACHIEVEMENTS_HASH_SIZE)
+        return RomMetadata(
+            romTitle = title,
+            developerName = developer,
+            isDSiWareTitle = flags and FLAG_DSIWARE != 0,
+            retroAchievementsHash = BigInteger(1, hashData).toString(16).padStart(32, '0'),
+        )
+    }
+
+    private fun readBytes(offset: Int, size: Int): ByteArray {
+        val data = ByteArray(size)
+        buffer.duplicate().apply {
+            position(offset)
+            get(data)
+        }
+        return data
+    }
+}
@@ -1,9 +1,12 @@
 package me.magnum.melonds.common.romprocessors
 
 import android.content.Context
+import android.os.ParcelFileDescriptor
+import me.magnum.melonds.MelonArchiveExtractor
 import me.magnum.melonds.common.uridelegates.UriHandler
 import me.magnum.melonds.domain.model.SizeUnit
 import me.magnum.melonds.impl.NdsRomCache
+import java.io.FileOutputStream
 import java.io.InputStream
 import java.util.zip.ZipEntry
 import java.util.zip.ZipInputStream
@@ -18,6 +21,26 @@ class ZipRomFileProcessor(context: Context, uriHandler: UriHandler, ndsRomCache:
         }
     }
 
+    override fun getNativeRomExtractor(archiveDescriptor: ParcelFileDescriptor): NdsRomCache.RomExtractor? {
+        val extensions = SUPPORTED_ROM_EXTENSIONS.toTypedArray()
+        val romFileSize = MelonArchiveExtractor.getZipEntrySize(archiveDescriptor.fd, extensions)
+        if (romFileSize < 0) {
+            return null
+        }
+
+        return object : NdsRomCache.RomExtractor {
+            override fun getExtractedRomFileSize(): SizeUnit {
+                return SizeUnit.Bytes(romFileSize)
+            }
+
+            override fun saveRomFile(fileStream: FileOutputStream): Boolean {
+                return ParcelFileDescriptor.dup(fileStream.fd).use {
+                    MelonArchiveExtractor.extractZipEntry(archiveDescriptor.fd, it.fd, extensions)
+                }
+            }
+        }
+    }
+
     private fun getNdsEntryInZipStream(inputStream: ZipInputStream): ZipEntry? {
         do {
             val nextEntry = inputStream.nextEntry ?: break
@@ -25,4 +25,12 @@ class CompositeUriHandler(context: Context) : UriHandler {
     override fun getUriTreeDocument(uri: Uri): DocumentFile? {
         return delegates[uri.scheme]?.getUriTreeDocument(uri)
     }
+
+    override fun replaceFile(sourceUri: Uri, targetUri: Uri): Boolean {
+        if (sourceUri.scheme != targetUri.scheme) {
+            return false
+        }
+
+        return delegates[sourceUri.scheme]?.replaceFile(sourceUri, targetUri) == true
+    }
 }
\ No newline at end of file
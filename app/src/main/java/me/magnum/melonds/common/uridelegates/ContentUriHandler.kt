@@ -2,9 +2,14 @@ package me.magnum.melonds.common.uridelegates
 
 import android.content.Context
 import android.net.Uri
+import android.provider.DocumentsContract
 import androidx.documentfile.provider.DocumentFile
 
 class ContentUriHandler(private val context: Context) : UriHandler {
+    private companion object {
+        const val BACKUP_SUFFIX = ".bak"
+    }
+
     override fun fileExists(uri: Uri): Boolean {
         return getUriDocument(uri)?.exists() == true
     }
@@ -21,4 +26,32 @@ class ContentUriHandler(private val context: Context) : UriHandler {
     override fun getUriTreeDocument(uri: Uri): DocumentFile? {
         return DocumentFile.fromTreeUri(context, uri)
     }
+
+    override fun replaceFile(sourceUri: Uri, targetUri: Uri): Boolean {
+        // Document providers cannot rename over an existing document. The old document is kept under a backup name until the new one has taken
+        // its name, so that a failure at any point leaves at least one complete copy behind
+        val targetDocument = getUriDocument(targetUri) ?: return false
+        val targetName = targetDocument.name ?: return false
+        if (!targetDocument.exists()) {
+            return renameDocument(sourceUri, targetName) != null
+        }
+
+        val backupUri = renameDocument(targetUri, "$targetName$BACKUP_SUFFIX") ?: return false
+        if (renameDocument(sourceUri, targetName) == null) {
+            // Put the old document back in place
+            renameDocument(backupUri, targetName)
+            return false
+        }
+
+        DocumentFile.fromSingleUri(context, backupUri)?.delete()
+        return true
+    }
+
+    private fun renameDocument(uri: Uri, name: String): Uri? {
+        return try {
+            DocumentsContract.renameDocument(context.contentResolver, uri, name)
+        } catch (_: Exception) {
+            null
+        }
+    }
 }
\ No newline at end of file
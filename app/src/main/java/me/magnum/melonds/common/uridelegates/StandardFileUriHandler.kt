@@ -27,4 +27,11 @@ class StandardFileUriHandler : UriHandler {
     override fun getUriTreeDocument(uri: Uri): DocumentFile? {
         return getUriDocument(uri)
     }
+
+    override fun replaceFile(sourceUri: Uri, targetUri: Uri): Boolean {
+        val sourceFile = sourceUri.path?.let { File(it) } ?: return false
+        val targetFile = targetUri.path?.let { File(it) } ?: return false
+        // rename() atomically replaces the target file
+        return sourceFile.renameTo(targetFile)
+    }
 }
\ No newline at end of file
@@ -8,4 +8,9 @@ interface UriHandler {
     fun createFileDocument(uri: Uri): DocumentFile?
     fun getUriDocument(uri: Uri): DocumentFile?
     fun getUriTreeDocument(uri: Uri): DocumentFile?
+
+    /**
+     * Replaces the file at [targetUri] with the file at [sourceUri]. The source file no longer exists after a successful replacement.
+     */
+    fun replaceFile(sourceUri: Uri, targetUri: Uri): Boolean
 }
\ No newline at end of file
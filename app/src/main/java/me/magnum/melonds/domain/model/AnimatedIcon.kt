@@ -0,0 +1,13 @@
+package me.magnum.melonds.domain.model
+
+/**
+ * Animated DSi icon. [frames] holds all frames as 32x32 RGBA images stacked vertically, and [frameDurations] holds the duration of each frame in
+ * 60 Hz frames.
+ */
+class AnimatedIcon(
+    val frames: ByteArray,
+    val frameDurations: IntArray,
+) {
+
+    val frameCount get() = frameDurations.size
+}
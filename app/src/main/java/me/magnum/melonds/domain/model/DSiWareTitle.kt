@@ -8,6 +8,7 @@ class DSiWareTitle(
     val publicSavSize: Long,
     val privateSavSize: Long,
     val appFlags: Int,
+    val animatedIcon: AnimatedIcon? = null,
 ) {
 
     fun hasPublicSavFile() = publicSavSize != 0L
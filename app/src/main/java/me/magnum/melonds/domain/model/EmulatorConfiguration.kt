@@ -17,6 +17,7 @@ data class EmulatorConfiguration(
         val rewindEnabled: Boolean,
         val rewindPeriodSeconds: Int,
         val rewindWindowSeconds: Int,
+        val rewindThumbnailSize: RewindThumbnailSize,
         val useJit: Boolean,
         val consoleType: ConsoleType,
         val soundEnabled: Boolean,
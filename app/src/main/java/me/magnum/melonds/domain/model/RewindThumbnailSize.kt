@@ -0,0 +1,10 @@
+package me.magnum.melonds.domain.model
+
+/**
+ * Size of the thumbnails shown in the rewind window. [scale] is the factor by which the screens are downscaled.
+ */
+enum class RewindThumbnailSize(val scale: Int) {
+    SMALL(4),
+    MEDIUM(2),
+    LARGE(1)
+}
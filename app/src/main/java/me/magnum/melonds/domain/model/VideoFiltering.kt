@@ -1,6 +1,9 @@
 package me.magnum.melonds.domain.model
 
-enum class VideoFiltering {
+/**
+ * @property cpuFilter The native CPU filter to apply before rendering (see CpuVideoFilter.h), or 0 if the filtering is done entirely by shaders
+ */
+enum class VideoFiltering(val cpuFilter: Int = 0) {
     NONE,
     LINEAR,
     XBR2,
@@ -8,5 +11,9 @@ enum class VideoFiltering {
     HQ4X,
     QUILEZ,
     LCD,
-    SCANLINES
+    SCANLINES,
+    SCALE2X_CPU(1),
+    SCALE3X_CPU(2),
+    XBR_LITE_CPU(3),
+    SHARP_BILINEAR_CPU(4),
 }
\ No newline at end of file
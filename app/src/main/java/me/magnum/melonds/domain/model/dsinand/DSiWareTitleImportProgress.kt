@@ -0,0 +1,15 @@
+package me.magnum.melonds.domain.model.dsinand
+
+/**
+ * Progress of a batch title import. [results] holds the result of every title that has already been processed, in the order in which they were
+ * requested.
+ */
+data class DSiWareTitleImportProgress(
+    val totalTitles: Int,
+    val results: List<ImportDSiWareTitleResult>,
+) {
+
+    val processedTitles get() = results.size
+
+    val isFinished get() = processedTitles == totalTitles
+}
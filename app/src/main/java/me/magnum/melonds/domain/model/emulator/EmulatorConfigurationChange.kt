@@ -0,0 +1,26 @@
+package me.magnum.melonds.domain.model.emulator
+
+/**
+ * Classes of changes that can be made to the configuration of a running emulator, based on what is needed to apply them. The flag values must
+ * match EmulatorConfigurationDiff.h.
+ */
+enum class EmulatorConfigurationChange(private val flag: Int) {
+    /**
+     * Applied at the next frame (volume, audio interpolation, fast-forward speed, etc.).
+     */
+    HOT(1 shl 0),
+    /**
+     * Applied at the next frame, but requires render targets or audio streams to be recreated (renderer, resolution scaling, etc.).
+     */
+    WARM(1 shl 1),
+    /**
+     * Only applied after the emulator is reset (console type, BIOS and firmware files, JIT, etc.).
+     */
+    COLD(1 shl 2);
+
+    companion object {
+        fun fromFlags(flags: Int): Set<EmulatorConfigurationChange> {
+            return entries.filterTo(mutableSetOf()) { flags and it.flag != 0 }
+        }
+    }
+}
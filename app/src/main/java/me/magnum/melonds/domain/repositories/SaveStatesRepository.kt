@@ -1,14 +1,21 @@
 package me.magnum.melonds.domain.repositories
 
-import android.graphics.Bitmap
 import android.net.Uri
 import me.magnum.melonds.domain.model.rom.Rom
 import me.magnum.melonds.domain.model.SaveStateSlot
+import java.io.File
 
 interface SaveStatesRepository {
     fun getRomSaveStates(rom: Rom): List<SaveStateSlot>
     fun getRomQuickSaveStateSlot(rom: Rom): SaveStateSlot
     fun getRomSaveStateUri(rom: Rom, saveState: SaveStateSlot): Uri
-    fun setRomSaveStateScreenshot(rom: Rom, saveState: SaveStateSlot, screenshot: Bitmap)
+    fun getRomSaveStateTemporaryUri(rom: Rom, saveState: SaveStateSlot): Uri
+
+    /**
+     * Returns the file where the screenshot of the given save state should be written, creating its parent directories if needed.
+     * [onRomSaveStateScreenshotUpdated] must be called once the screenshot has been written.
+     */
+    fun getRomSaveStateScreenshotFile(rom: Rom, saveState: SaveStateSlot): File?
+    fun onRomSaveStateScreenshotUpdated(rom: Rom, saveState: SaveStateSlot)
     fun deleteRomSaveState(rom: Rom, saveState: SaveStateSlot)
 }
\ No newline at end of file
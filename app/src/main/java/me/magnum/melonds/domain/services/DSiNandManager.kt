@@ -1,15 +1,20 @@
 package me.magnum.melonds.domain.services
 
 import android.net.Uri
+import kotlinx.coroutines.flow.Flow
 import me.magnum.melonds.domain.model.DSiWareTitle
-import me.magnum.melonds.domain.model.dsinand.ImportDSiWareTitleResult
+import me.magnum.melonds.domain.model.dsinand.DSiWareTitleImportProgress
 import me.magnum.melonds.domain.model.dsinand.OpenDSiNandResult
 import me.magnum.melonds.domain.model.dsinand.DSiWareTitleFileType
 
 interface DSiNandManager {
     suspend fun openNand(): OpenDSiNandResult
     suspend fun listTitles(): List<DSiWareTitle>
-    suspend fun importTitle(titleUri: Uri): ImportDSiWareTitleResult
+    /**
+     * Imports several titles in a row, reporting the progress after each one. Each title is either fully imported or not imported at all. If the
+     * collection is cancelled, the title being imported is finished and the remaining ones are skipped.
+     */
+    fun importTitles(titleUris: List<Uri>): Flow<DSiWareTitleImportProgress>
     suspend fun deleteTitle(title: DSiWareTitle)
     suspend fun importTitleFile(title: DSiWareTitle, fileType: DSiWareTitleFileType, fileUri: Uri): Boolean
     suspend fun exportTitleFile(title: DSiWareTitle, fileType: DSiWareTitleFileType, fileUri: Uri): Boolean
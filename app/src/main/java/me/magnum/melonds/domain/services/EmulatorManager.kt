@@ -1,9 +1,12 @@
 package me.magnum.melonds.domain.services
 
 import android.net.Uri
+import kotlinx.coroutines.Deferred
 import kotlinx.coroutines.flow.Flow
 import me.magnum.melonds.domain.model.Cheat
 import me.magnum.melonds.domain.model.ConsoleType
+import me.magnum.melonds.domain.model.VideoFiltering
+import me.magnum.melonds.domain.model.emulator.EmulatorConfigurationChange
 import me.magnum.melonds.domain.model.emulator.EmulatorEvent
 import me.magnum.melonds.domain.model.emulator.FirmwareLaunchResult
 import me.magnum.melonds.domain.model.emulator.RomLaunchResult
@@ -12,6 +15,7 @@ import me.magnum.melonds.domain.model.retroachievements.RAEvent
 import me.magnum.melonds.domain.model.rom.Rom
 import me.magnum.melonds.ui.emulator.rewind.model.RewindSaveState
 import me.magnum.melonds.ui.emulator.rewind.model.RewindWindow
+import java.io.File
 
 interface EmulatorManager {
 
@@ -21,14 +25,19 @@ interface EmulatorManager {
 
     suspend fun loadFirmware(consoleType: ConsoleType): FirmwareLaunchResult
 
-    suspend fun updateRomEmulatorConfiguration(rom: Rom)
+    suspend fun updateRomEmulatorConfiguration(rom: Rom): Set<EmulatorConfigurationChange>
 
-    suspend fun updateFirmwareEmulatorConfiguration(consoleType: ConsoleType)
+    suspend fun updateFirmwareEmulatorConfiguration(consoleType: ConsoleType): Set<EmulatorConfigurationChange>
 
     suspend fun getRewindWindow(): RewindWindow
 
     fun getFps(): Float
 
+    /**
+     * Enables the CPU upscaling stage if [videoFiltering] is a CPU filter, or disables it otherwise.
+     */
+    fun updateVideoFiltering(videoFiltering: VideoFiltering)
+
     suspend fun pauseEmulator()
 
     suspend fun resumeEmulator()
@@ -41,7 +50,14 @@ interface EmulatorManager {
 
     suspend fun loadRewindState(rewindSaveState: RewindSaveState): Boolean
 
-    suspend fun saveState(saveStateFileUri: Uri): Boolean
+    /**
+     * Captures the current emulator state and writes it to [saveStateFileUri] in the background, going through [temporaryFileUri] so that an
+     * interrupted write does not corrupt the existing save state. If [screenshotFile] is provided, a PNG screenshot of the captured frame is
+     * written to it before the write is reported as complete. Returns as soon as the state has been captured.
+     *
+     * @return A deferred that completes with the result of the write, or null if the state could not be captured
+     */
+    suspend fun saveState(saveStateFileUri: Uri, temporaryFileUri: Uri, screenshotFile: File?): Deferred<Boolean>?
 
     suspend fun loadState(saveStateFileUri: Uri): Boolean
 
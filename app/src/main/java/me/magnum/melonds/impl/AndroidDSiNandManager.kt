@@ -3,6 +3,11 @@ package me.magnum.melonds.impl
 import android.content.Context
 import android.net.Uri
 import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.NonCancellable
+import kotlinx.coroutines.channels.produce
+import kotlinx.coroutines.flow.Flow
+import kotlinx.coroutines.flow.channelFlow
+import kotlinx.coroutines.flow.flowOn
 import kotlinx.coroutines.sync.Mutex
 import kotlinx.coroutines.sync.withLock
 import kotlinx.coroutines.withContext
@@ -11,12 +16,14 @@ import me.magnum.melonds.common.suspendRunCatching
 import me.magnum.melonds.domain.model.ConfigurationDirResult
 import me.magnum.melonds.domain.model.DSiWareTitle
 import me.magnum.melonds.domain.model.dsinand.DSiWareTitleFileType
+import me.magnum.melonds.domain.model.dsinand.DSiWareTitleImportProgress
 import me.magnum.melonds.domain.model.dsinand.ImportDSiWareTitleResult
 import me.magnum.melonds.domain.model.dsinand.OpenDSiNandResult
 import me.magnum.melonds.domain.repositories.DSiWareMetadataRepository
 import me.magnum.melonds.domain.repositories.SettingsRepository
 import me.magnum.melonds.domain.services.ConfigurationDirectoryVerifier
 import me.magnum.melonds.domain.services.DSiNandManager
+import java.io.File
 import java.io.InputStream
 import java.util.concurrent.atomic.AtomicBoolean
 import java.util.concurrent.atomic.AtomicInteger
@@ -30,6 +37,7 @@ class AndroidDSiNandManager(
 
     private companion object {
         val DSIWARE_CATEGORY = 0x00030004.toUInt()
+        const val TITLE_CACHE_FILE = "dsiware_titles.cache"
     }
 
     private val nandControlLock = Mutex()
@@ -47,7 +55,7 @@ class AndroidDSiNandManager(
                 return OpenDSiNandResult.INVALID_DSI_SETUP
             }
 
-            val result = MelonDSiNand.openNand(settingsRepository.getEmulatorConfiguration())
+            val result = MelonDSiNand.openNand(settingsRepository.getEmulatorConfiguration(), File(context.cacheDir, TITLE_CACHE_FILE).absolutePath)
             mapOpenNandReturnCodeToResult(result).also {
                 if (!it.isFailure()) {
                     if (nandUsageCount.getAndIncrement() == 0) {
@@ -63,39 +71,69 @@ class AndroidDSiNandManager(
             return emptyList()
         }
 
-        return MelonDSiNand.listTitles()
+        return DSiWareTitleList.decode(MelonDSiNand.listTitles())
     }
 
-    override suspend fun importTitle(titleUri: Uri): ImportDSiWareTitleResult = nandControlLock.withLock {
-        withContext(Dispatchers.IO) {
+    override fun importTitles(titleUris: List<Uri>): Flow<DSiWareTitleImportProgress> = channelFlow {
+        nandControlLock.withLock {
+            val results = mutableListOf<ImportDSiWareTitleResult>()
+            send(DSiWareTitleImportProgress(titleUris.size, results.toList()))
+
             if (!isNandOpen.get()) {
-                return@withContext ImportDSiWareTitleResult.NAND_NOT_OPEN
+                repeat(titleUris.size) { results.add(ImportDSiWareTitleResult.NAND_NOT_OPEN) }
+                send(DSiWareTitleImportProgress(titleUris.size, results.toList()))
+                return@withLock
             }
 
-            var categoryId: UInt = 0.toUInt()
-            var titleId: UInt = 0.toUInt()
+            // The next title is prepared (which includes downloading its metadata) while the current one is being written to the NAND
+            val preparedTitles = produce(Dispatchers.IO, capacity = 1) {
+                titleUris.forEach { send(prepareTitleImport(it)) }
+            }
 
+            for (preparedTitle in preparedTitles) {
+                val result = when (preparedTitle) {
+                    // Installation cannot be interrupted. Cancellation is only checked between titles, so that the NAND never holds a partially
+                    // imported title
+                    is PreparedTitleImport.Ready -> withContext(NonCancellable) { installTitle(preparedTitle) }
+                    is PreparedTitleImport.Failed -> preparedTitle.result
+                }
+                results.add(result)
+                send(DSiWareTitleImportProgress(titleUris.size, results.toList()))
+            }
+        }
+    }.flowOn(Dispatchers.IO)
+
+    private suspend fun prepareTitleImport(titleUri: Uri): PreparedTitleImport {
+        var categoryId: UInt = 0.toUInt()
+        var titleId: UInt = 0.toUInt()
+
+        try {
             context.contentResolver.openInputStream(titleUri)?.use {
                 it.skip(0x230)
                 titleId = it.readUInt()
                 categoryId = it.readUInt()
-            } ?: return@withContext ImportDSiWareTitleResult.ERROR_OPENING_FILE
+            } ?: return PreparedTitleImport.Failed(ImportDSiWareTitleResult.ERROR_OPENING_FILE)
+        } catch (e: Exception) {
+            return PreparedTitleImport.Failed(ImportDSiWareTitleResult.ERROR_OPENING_FILE)
+        }
 
-            if (categoryId != DSIWARE_CATEGORY) {
-                return@withContext ImportDSiWareTitleResult.NOT_DSIWARE_TITLE
-            }
+        if (categoryId != DSIWARE_CATEGORY) {
+            return PreparedTitleImport.Failed(ImportDSiWareTitleResult.NOT_DSIWARE_TITLE)
+        }
 
-            val tmdMetadataResult = suspendRunCatching {
-                dsiWareMetadataRepository.getDSiWareTitleMetadata(categoryId, titleId)
-            }
+        val tmdMetadataResult = suspendRunCatching {
+            dsiWareMetadataRepository.getDSiWareTitleMetadata(categoryId, titleId)
+        }
 
-            if (tmdMetadataResult.isFailure) {
-                return@withContext ImportDSiWareTitleResult.METADATA_FETCH_FAILED
-            }
+        return tmdMetadataResult.fold(
+            onSuccess = { PreparedTitleImport.Ready(titleUri, titleId, it) },
+            onFailure = { PreparedTitleImport.Failed(ImportDSiWareTitleResult.METADATA_FETCH_FAILED) },
+        )
+    }
 
-            val result = MelonDSiNand.importTitle(titleUri.toString(), tmdMetadataResult.getOrThrow())
-            mapImportTitleReturnCodeToResult(result)
-        }
+    private fun installTitle(preparedTitle: PreparedTitleImport.Ready): ImportDSiWareTitleResult {
+        val result = MelonDSiNand.importTitle(preparedTitle.titleUri.toString(), preparedTitle.titleId.toInt(), preparedTitle.tmdMetadata)
+        return mapImportTitleReturnCodeToResult(result)
     }
 
     override suspend fun deleteTitle(title: DSiWareTitle): Unit = nandControlLock.withLock {
@@ -151,6 +189,11 @@ class AndroidDSiNandManager(
         }
     }
 
+    private sealed class PreparedTitleImport {
+        class Ready(val titleUri: Uri, val titleId: UInt, val tmdMetadata: ByteArray) : PreparedTitleImport()
+        class Failed(val result: ImportDSiWareTitleResult) : PreparedTitleImport()
+    }
+
     private fun InputStream.readUInt(): UInt {
         return read().toUInt() or read().shl(8).toUInt() or read().shl(16).toUInt() or read().shl(24).toUInt()
     }
@@ -0,0 +1,69 @@
+package me.magnum.melonds.impl
+
+import me.magnum.melonds.domain.model.AnimatedIcon
+import me.magnum.melonds.domain.model.DSiWareTitle
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+/**
+ * Decodes the packed title list returned by [me.magnum.melonds.MelonDSiNand.listTitles].
+ *
+ * The layout must match DSiWareTitleList::Header and DSiWareTitleList::TitleRecord.
+ */
+object DSiWareTitleList {
+    private const val HEADER_SIZE = 8
+    private const val TITLE_ID_OFFSET = 0
+    private const val PUBLIC_SAV_SIZE_OFFSET = 8
+    private const val PRIVATE_SAV_SIZE_OFFSET = 12
+    private const val APP_FLAGS_OFFSET = 16
+    private const val ANIMATION_FRAME_COUNT_OFFSET = 20
+    private const val ANIMATION_OFFSET_OFFSET = 24
+    private const val TITLE_OFFSET = 32
+    private const val TITLE_SIZE = 256
+    private const val ICON_OFFSET = 288
+    private const val ICON_SIZE = 32 * 32 * 4
+
+    fun decode(data: ByteArray): List<DSiWareTitle> {
+        val buffer = ByteBuffer.wrap(data).order(ByteOrder.nativeOrder())
+        val titleCount = buffer.getInt(0)
+        val recordSize = buffer.getInt(4)
+
+        return List(titleCount) {
+            val recordOffset = HEADER_SIZE + it * recordSize
+            val (name, producer) = parseTitle(String(data, recordOffset + TITLE_OFFSET, TITLE_SIZE, Charsets.UTF_16LE))
+
+            DSiWareTitle(
+                name = name,
+                producer = producer,
+                titleId = buffer.getInt(recordOffset + TITLE_ID_OFFSET).toLong() and 0xFFFFFFFF,
+                icon = data.copyOfRange(recordOffset + ICON_OFFSET, recordOffset + ICON_OFFSET + ICON_SIZE),
+                publicSavSize = buffer.getInt(recordOffset + PUBLIC_SAV_SIZE_OFFSET).toLong() and 0xFFFFFFFF,
+                privateSavSize = buffer.getInt(recordOffset + PRIVATE_SAV_SIZE_OFFSET).toLong() and 0xFFFFFFFF,
+                appFlags = buffer.getInt(recordOffset + APP_FLAGS_OFFSET),
+                animatedIcon = decodeAnimatedIcon(buffer, data, recordOffset),
+            )
+        }
+    }
+
+    /**
+     * Splits the banner title into the title name, which is on the first line, and the producer, which is on the rest.
+     */
+    private fun parseTitle(bannerTitle: String): Pair<String, String> {
+        val title = bannerTitle.substringBefore('\u0000')
+        return title.substringBefore('\n') to title.substringAfter('\n', "")
+    }
+
+    private fun decodeAnimatedIcon(buffer: ByteBuffer, data: ByteArray, recordOffset: Int): AnimatedIcon? {
+        val frameCount = buffer.getInt(recordOffset + ANIMATION_FRAME_COUNT_OFFSET)
+        if (frameCount == 0) {
+            return null
+        }
+
+        val framesOffset = buffer.getInt(recordOffset + ANIMATION_OFFSET_OFFSET)
+        val durationsOffset = framesOffset + frameCount * ICON_SIZE
+        return AnimatedIcon(
+            frames = data.copyOfRange(framesOffset, durationsOffset),
+            frameDurations = IntArray(frameCount) { buffer.getInt(durationsOffset + it * 4) },
+        )
+    }
+}
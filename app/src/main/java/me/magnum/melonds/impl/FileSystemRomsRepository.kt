@@ -2,6 +2,8 @@ package me.magnum.melonds.impl
 
 import android.content.Context
 import android.net.Uri
+import android.os.SystemClock
+import android.provider.DocumentsContract
 import android.util.Log
 import androidx.documentfile.provider.DocumentFile
 import com.google.gson.Gson
@@ -9,7 +11,6 @@ import com.google.gson.reflect.TypeToken
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.flow.Flow
-import kotlinx.coroutines.flow.FlowCollector
 import kotlinx.coroutines.flow.MutableStateFlow
 import kotlinx.coroutines.flow.StateFlow
 import kotlinx.coroutines.flow.asStateFlow
@@ -18,6 +19,7 @@ import kotlinx.coroutines.flow.emitAll
 import kotlinx.coroutines.flow.first
 import kotlinx.coroutines.flow.flow
 import kotlinx.coroutines.launch
+import me.magnum.melonds.common.romprocessors.RomFileProcessor
 import me.magnum.melonds.common.romprocessors.RomFileProcessorFactory
 import me.magnum.melonds.domain.model.RomScanningStatus
 import me.magnum.melonds.domain.model.rom.Rom
@@ -46,6 +48,8 @@ class FileSystemRomsRepository(
         private const val TAG = "FSRomsRepository"
         private const val EXTERNAL_STORAGE_PROVIDER_AUTHORITY = "com.android.externalstorage.documents"
         private const val ROM_DATA_FILE = "rom_data.json"
+        private const val ROM_METADATA_INDEX_FILE = "rom_metadata.idx"
+        private const val ROM_SCAN_BATCH_SIZE = 32
     }
 
     private val coroutineScope = CoroutineScope(Dispatchers.IO)
@@ -53,6 +57,7 @@ class FileSystemRomsRepository(
     private val romsChannel = SubjectSharedFlow<List<Rom>>()
     private val scanningStatusSubject = MutableStateFlow(RomScanningStatus.NOT_SCANNING)
     private val roms: ArrayList<Rom> = ArrayList()
+    private val romMetadataIndex = RomMetadataIndex(File(context.filesDir, ROM_METADATA_INDEX_FILE))
     private var areRomsLoaded = AtomicBoolean(false)
 
     init {
@@ -175,11 +180,7 @@ class FileSystemRomsRepository(
     override fun rescanRoms() {
         coroutineScope.launch {
             scanningStatusSubject.emit(RomScanningStatus.SCANNING)
-
-            scanForNewRoms().collect {
-                addRom(it)
-            }
-
+            scanRoms()
             scanningStatusSubject.emit(RomScanningStatus.NOT_SCANNING)
         }
     }
@@ -193,11 +194,12 @@ class FileSystemRomsRepository(
         if (cacheFile.isFile) {
             cacheFile.delete()
         }
+        romMetadataIndex.clear()
     }
 
     private fun addRom(rom: Rom) {
         val existingRom = roms.find { it.hasSameFileAsRom(rom) }
-        if (existingRom == rom) {
+        if (existingRom == rom || (existingRom != null && existingRom.hasSameMetadataAsRom(rom))) {
             return
         }
 
@@ -224,6 +226,19 @@ class FileSystemRomsRepository(
         }
     }
 
+    private fun Rom.hasSameMetadataAsRom(other: Rom): Boolean {
+        return name == other.name &&
+                developerName == other.developerName &&
+                isDsiWareTitle == other.isDsiWareTitle &&
+                retroAchievementsHash == other.retroAchievementsHash
+    }
+
+    private fun removeMissingRoms(foundRomUris: Set<Uri>) {
+        if (roms.removeAll { it.uri !in foundRomUris }) {
+            onRomsChanged()
+        }
+    }
+
     private fun removeAllRoms() {
         roms.clear()
         onRomsChanged()
@@ -236,42 +251,162 @@ class FileSystemRomsRepository(
     private suspend fun loadCachedRoms() {
         scanningStatusSubject.emit(RomScanningStatus.SCANNING)
 
-        val cachedRoms = getCachedRoms().filter {
-            DocumentFile.fromSingleUri(context, it.uri)?.exists() == true
-        }
-
-        roms.addAll(cachedRoms)
+        // Cached ROMs are shown right away. ROMs that no longer exist are removed by the scan that follows
+        roms.addAll(getCachedRoms())
         onRomsChanged()
-        scanForNewRoms().collect {
-            addRom(it)
-        }
+        scanRoms()
 
         scanningStatusSubject.emit(RomScanningStatus.NOT_SCANNING)
     }
 
-    private fun scanForNewRoms(): Flow<Rom> = flow {
+    /**
+     * Scans all ROM search directories. ROMs whose size and last-modified date match the ones in the metadata index are not opened. If all
+     * directories could be listed, ROMs that were not found are removed from the list and from the index.
+     */
+    private fun scanRoms() {
+        val startTime = SystemClock.elapsedRealtime()
+        val foundRomUris = mutableSetOf<Uri>()
+        var isScanComplete = true
+
         for (directory in settingsRepository.getRomSearchDirectories()) {
-            val documentFile = DocumentFile.fromTreeUri(context, directory)
-            if (documentFile != null) {
-                findCachedRomFiles(documentFile, this)
+            val documentId = try {
+                if (DocumentsContract.isDocumentUri(context, directory)) {
+                    DocumentsContract.getDocumentId(directory)
+                } else {
+                    DocumentsContract.getTreeDocumentId(directory)
+                }
+            } catch (e: Exception) {
+                Log.w(TAG, "Invalid ROM search directory $directory", e)
+                isScanComplete = false
+                continue
+            }
+
+            if (!scanDirectory(directory, documentId, foundRomUris)) {
+                isScanComplete = false
             }
         }
+
+        if (isScanComplete) {
+            removeMissingRoms(foundRomUris)
+            romMetadataIndex.retainEntries(foundRomUris.mapTo(mutableSetOf()) { it.toString() })
+        }
+        romMetadataIndex.save()
+        Log.d(TAG, "Scanned ${foundRomUris.size} ROMs in ${SystemClock.elapsedRealtime() - startTime} ms")
     }
 
-    private suspend fun findCachedRomFiles(directory: DocumentFile, collector: FlowCollector<Rom>) {
-        val files = directory.listFiles()
-        for (file in files) {
-            if (file.isDirectory) {
-                findCachedRomFiles(file, collector)
+    /**
+     * Scans the given directory and its subdirectories, adding the ROMs found to the ROM list and their URIs to [foundRomUris].
+     *
+     * @return Whether the directory and all its subdirectories could be listed
+     */
+    private fun scanDirectory(treeUri: Uri, directoryDocumentId: String, foundRomUris: MutableSet<Uri>): Boolean {
+        val directoryUri = DocumentsContract.buildDocumentUriUsingTree(treeUri, directoryDocumentId)
+        val documents = listDirectoryDocuments(treeUri, directoryDocumentId) ?: return false
+        var isScanComplete = true
+
+        val changedRomsByProcessor = mutableMapOf<RomFileProcessor, MutableList<DirectoryDocument>>()
+        for (document in documents) {
+            if (document.isDirectory) {
+                if (!scanDirectory(treeUri, document.documentId, foundRomUris)) {
+                    isScanComplete = false
+                }
                 continue
             }
 
-            romFileProcessorFactory.getFileRomProcessorForDocument(file)?.let { fileRomProcessor ->
-                fileRomProcessor.getRomFromUri(file.uri, directory.uri)?.let { collector.emit(it) }
+            val fileRomProcessor = romFileProcessorFactory.getFileRomProcessorForFileName(document.name) ?: continue
+            foundRomUris.add(document.uri)
+
+            // Without a last-modified date there is no way to tell whether the ROM changed, so it is always scanned
+            val indexEntry = document.lastModified?.let { romMetadataIndex.getEntry(document.uri.toString(), document.size, it) }
+            if (indexEntry != null) {
+                addRom(buildRomFromIndexEntry(indexEntry, document, directoryUri))
+            } else {
+                changedRomsByProcessor.getOrPut(fileRomProcessor) { mutableListOf() }.add(document)
+            }
+        }
+
+        // Process ROMs in batches so that processors can scan several ROMs at once, while still adding ROMs as the scan progresses
+        changedRomsByProcessor.forEach { (fileRomProcessor, romDocuments) ->
+            romDocuments.chunked(ROM_SCAN_BATCH_SIZE).forEach { batch ->
+                fileRomProcessor.getRomsFromUris(batch.map { it.uri }, directoryUri).forEachIndexed { index, rom ->
+                    if (rom != null) {
+                        buildIndexEntry(rom, batch[index])?.let { romMetadataIndex.putEntry(it) }
+                        addRom(rom)
+                    }
+                }
+            }
+        }
+
+        return isScanComplete
+    }
+
+    /**
+     * Lists the documents in a directory with a single query, so that the size and last-modified date of each document do not have to be
+     * queried separately.
+     *
+     * @return The documents in the directory, or null if it could not be listed
+     */
+    private fun listDirectoryDocuments(treeUri: Uri, directoryDocumentId: String): List<DirectoryDocument>? {
+        val childrenUri = DocumentsContract.buildChildDocumentsUriUsingTree(treeUri, directoryDocumentId)
+        val projection = arrayOf(
+            DocumentsContract.Document.COLUMN_DOCUMENT_ID,
+            DocumentsContract.Document.COLUMN_DISPLAY_NAME,
+            DocumentsContract.Document.COLUMN_MIME_TYPE,
+            DocumentsContract.Document.COLUMN_SIZE,
+            DocumentsContract.Document.COLUMN_LAST_MODIFIED,
+        )
+
+        return try {
+            context.contentResolver.query(childrenUri, projection, null, null, null)?.use { cursor ->
+                val documents = mutableListOf<DirectoryDocument>()
+                while (cursor.moveToNext()) {
+                    val documentId = cursor.getString(0) ?: continue
+                    documents.add(
+                        DirectoryDocument(
+                            documentId = documentId,
+                            uri = DocumentsContract.buildDocumentUriUsingTree(treeUri, documentId),
+                            name = cursor.getString(1) ?: "",
+                            isDirectory = cursor.getString(2) == DocumentsContract.Document.MIME_TYPE_DIR,
+                            size = if (cursor.isNull(3)) 0 else cursor.getLong(3),
+                            lastModified = if (cursor.isNull(4)) null else cursor.getLong(4),
+                        )
+                    )
+                }
+                documents
             }
+        } catch (e: Exception) {
+            Log.w(TAG, "Failed to list documents in $childrenUri", e)
+            null
         }
     }
 
+    private fun buildRomFromIndexEntry(entry: RomMetadataIndex.Entry, document: DirectoryDocument, parentUri: Uri): Rom {
+        return Rom(
+            name = entry.name,
+            developerName = entry.developerName,
+            fileName = document.name,
+            uri = document.uri,
+            parentTreeUri = parentUri,
+            config = if (entry.isDsiWareTitle) RomConfig.forDsiWareTitle() else RomConfig.default(),
+            lastPlayed = null,
+            isDsiWareTitle = entry.isDsiWareTitle,
+            retroAchievementsHash = entry.retroAchievementsHash,
+        )
+    }
+
+    private fun buildIndexEntry(rom: Rom, document: DirectoryDocument): RomMetadataIndex.Entry? {
+        val lastModified = document.lastModified ?: return null
+        return RomMetadataIndex.Entry(
+            uri = document.uri.toString(),
+            size = document.size,
+            lastModified = lastModified,
+            name = rom.name,
+            developerName = rom.developerName,
+            isDsiWareTitle = rom.isDsiWareTitle,
+            retroAchievementsHash = rom.retroAchievementsHash,
+        )
+    }
+
     private fun getCachedRoms(): List<Rom> {
         val cacheFile = File(context.filesDir, ROM_DATA_FILE)
         if (!cacheFile.isFile) {
@@ -301,4 +436,14 @@ class FileSystemRomsRepository(
             Log.e(TAG, "Failed to save ROM data", e)
         }
     }
-}
\ No newline at end of file
+
+    private data class DirectoryDocument(
+        val documentId: String,
+        val uri: Uri,
+        val name: String,
+        val isDirectory: Boolean,
+        val size: Long,
+        // Null if the provider does not report it
+        val lastModified: Long?,
+    )
+}
@@ -1,6 +1,5 @@
 package me.magnum.melonds.impl
 
-import android.graphics.Bitmap
 import android.net.Uri
 import androidx.documentfile.provider.DocumentFile
 import me.magnum.melonds.common.uridelegates.UriHandler
@@ -10,6 +9,7 @@ import me.magnum.melonds.domain.repositories.SaveStatesRepository
 import me.magnum.melonds.domain.repositories.SettingsRepository
 import me.magnum.melonds.extensions.nameWithoutExtension
 import me.magnum.melonds.ui.emulator.exceptions.SaveSlotLoadException
+import java.io.File
 import java.util.*
 
 class FileSystemSaveStatesRepository(
@@ -64,8 +64,29 @@ class FileSystemSaveStatesRepository(
         return uri
     }
 
-    override fun setRomSaveStateScreenshot(rom: Rom, saveState: SaveStateSlot, screenshot: Bitmap) {
-        saveStateScreenshotProvider.saveRomSaveStateScreenshot(rom, saveState, screenshot)
+    override fun getRomSaveStateTemporaryUri(rom: Rom, saveState: SaveStateSlot): Uri {
+        val saveStateDirectoryDocument = getSaveStateDirectoryDocument(rom) ?: throw SaveSlotLoadException("Could not create parent directory document")
+
+        val romFileName = getRomFileNameWithoutExtension(rom) ?: throw SaveSlotLoadException("Could not determine ROM file name")
+        val temporaryFileName = "$romFileName.ml${saveState.slot}.tmp"
+
+        // Remove leftovers from interrupted writes first. Providers without path-based document IDs rename duplicates (e.g. "name (1)"), so the
+        // document created below may not have the requested name, and its returned URI is the only reliable handle to it
+        saveStateDirectoryDocument.listFiles().forEach {
+            if (it.name?.startsWith(temporaryFileName) == true) {
+                it.delete()
+            }
+        }
+
+        return saveStateDirectoryDocument.createFile("*/*", temporaryFileName)?.uri ?: throw SaveSlotLoadException("Could not create temporary save state file")
+    }
+
+    override fun getRomSaveStateScreenshotFile(rom: Rom, saveState: SaveStateSlot): File? {
+        return saveStateScreenshotProvider.getRomSaveStateScreenshotOutputFile(rom, saveState)
+    }
+
+    override fun onRomSaveStateScreenshotUpdated(rom: Rom, saveState: SaveStateSlot) {
+        saveStateScreenshotProvider.invalidateRomSaveStateScreenshot(rom, saveState)
     }
 
     override fun deleteRomSaveState(rom: Rom, saveState: SaveStateSlot) {
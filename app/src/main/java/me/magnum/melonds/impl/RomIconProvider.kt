@@ -5,11 +5,13 @@ import android.graphics.Bitmap
 import android.graphics.BitmapFactory
 import androidx.documentfile.provider.DocumentFile
 import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.ensureActive
 import kotlinx.coroutines.withContext
 import me.magnum.melonds.common.romprocessors.RomFileProcessorFactory
 import me.magnum.melonds.domain.model.rom.Rom
 import java.io.File
 import java.util.*
+import java.util.concurrent.ConcurrentHashMap
 import java.util.concurrent.locks.ReentrantLock
 import kotlin.concurrent.withLock
 
@@ -22,9 +24,10 @@ import kotlin.concurrent.withLock
 class RomIconProvider(private val context: Context, private val romFileProcessorFactory: RomFileProcessorFactory) {
     companion object {
         private const val ICON_CACHE_DIR = "rom_icons"
+        private const val ICON_PREFETCH_BATCH_SIZE = 32
     }
 
-    private val memoryIconCache = mutableMapOf<String, Bitmap>()
+    private val memoryIconCache = ConcurrentHashMap<String, Bitmap>()
     private val romIconLocks = Collections.synchronizedMap(mutableMapOf<String, ReentrantLock>())
 
     suspend fun getRomIcon(rom: Rom): Bitmap? = withContext(Dispatchers.IO) {
@@ -34,6 +37,40 @@ class RomIconProvider(private val context: Context, private val romFileProcessor
         }
     }
 
+    /**
+     * Decodes the icons of the given ROMs that are not cached yet and stores them in both caches. Icons are decoded in batches, in the order of
+     * [roms], so ROMs that are about to be displayed should come first. ROMs whose processor does not support prefetching (archives) are
+     * skipped and have their icons decoded on demand.
+     */
+    suspend fun prefetchRomIcons(roms: List<Rom>) = withContext(Dispatchers.IO) {
+        val iconCacheDir = getIconCacheDir()
+        roms.groupBy { romFileProcessorFactory.getFileRomProcessorForFileName(it.fileName) }.forEach { (romProcessor, processorRoms) ->
+            if (romProcessor?.supportsIconPrefetch != true) {
+                return@forEach
+            }
+
+            val uncachedRoms = processorRoms.filter { rom ->
+                val romHash = rom.uri.hashCode().toString()
+                !memoryIconCache.containsKey(romHash) && iconCacheDir?.let { File(it, romHash).isFile } != true
+            }
+
+            uncachedRoms.chunked(ICON_PREFETCH_BATCH_SIZE).forEach { batch ->
+                ensureActive()
+                romProcessor.getRomIcons(batch).forEachIndexed { index, bitmap ->
+                    if (bitmap != null) {
+                        val romHash = batch[index].uri.hashCode().toString()
+                        getRomIconLock(romHash).withLock {
+                            memoryIconCache[romHash] = bitmap
+                            if (iconCacheDir != null) {
+                                saveRomIcon(romHash, bitmap)
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
     fun clearIconCache() {
         memoryIconCache.clear()
         val iconCacheDir = getIconCacheDir() ?: return
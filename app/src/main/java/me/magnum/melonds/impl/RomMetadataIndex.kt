@@ -0,0 +1,187 @@
+package me.magnum.melonds.impl
+
+import android.util.Log
+import java.io.File
+import java.io.RandomAccessFile
+import java.nio.BufferUnderflowException
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import java.nio.channels.FileChannel
+
+/**
+ * Compact on-disk index of the metadata extracted from ROM files. Entries are keyed by the document URI of the ROM, and are only valid while
+ * the size and last-modified date of the document match the ones stored in the entry. This allows rescans to skip ROMs that have not changed
+ * without opening them.
+ *
+ * The index file is memory-mapped when loaded. If its format version does not match [FORMAT_VERSION], it is discarded and rebuilt from
+ * scratch by the next scan.
+ */
+class RomMetadataIndex(private val indexFile: File) {
+
+    companion object {
+        private const val TAG = "RomMetadataIndex"
+        private const val MAGIC = 0x4D44524D // "MRDM"
+        private const val FORMAT_VERSION = 1
+        private const val HEADER_SIZE = 16
+    }
+
+    data class Entry(
+        val uri: String,
+        val size: Long,
+        val lastModified: Long,
+        val name: String,
+        val developerName: String,
+        val isDsiWareTitle: Boolean,
+        val retroAchievementsHash: String,
+    )
+
+    private val entries = HashMap<String, Entry>()
+    private var isLoaded = false
+    private var isDirty = false
+
+    /**
+     * Returns the entry for the ROM at the given URI, or null if there is none or if the ROM has changed since it was indexed.
+     */
+    @Synchronized
+    fun getEntry(uri: String, size: Long, lastModified: Long): Entry? {
+        ensureLoaded()
+        return entries[uri]?.takeIf { it.size == size && it.lastModified == lastModified }
+    }
+
+    @Synchronized
+    fun putEntry(entry: Entry) {
+        ensureLoaded()
+        if (entries.put(entry.uri, entry) != entry) {
+            isDirty = true
+        }
+    }
+
+    /**
+     * Removes all entries whose URI is not in [uris].
+     */
+    @Synchronized
+    fun retainEntries(uris: Set<String>) {
+        ensureLoaded()
+        if (entries.keys.retainAll(uris)) {
+            isDirty = true
+        }
+    }
+
+    /**
+     * Writes the index to disk if it has been modified since it was loaded. The index is written to a temporary file first, so that an
+     * interrupted write never leaves a corrupted index behind.
+     */
+    @Synchronized
+    fun save() {
+        if (!isDirty) {
+            return
+        }
+
+        val encodedEntries = entries.values.map { encodeEntry(it) }
+        val buffer = ByteBuffer.allocate(HEADER_SIZE + encodedEntries.sumOf { it.size }).order(ByteOrder.LITTLE_ENDIAN)
+        buffer.putInt(MAGIC)
+        buffer.putInt(FORMAT_VERSION)
+        buffer.putInt(encodedEntries.size)
+        buffer.putInt(0)
+        encodedEntries.forEach { buffer.put(it) }
+
+        val temporaryFile = File(indexFile.parentFile, "${indexFile.name}.tmp")
+        try {
+            temporaryFile.writeBytes(buffer.array())
+            if (temporaryFile.renameTo(indexFile)) {
+                isDirty = false
+            } else {
+                Log.e(TAG, "Failed to replace ROM metadata index")
+            }
+        } catch (e: Exception) {
+            Log.e(TAG, "Failed to save ROM metadata index", e)
+        }
+    }
+
+    @Synchronized
+    fun clear() {
+        entries.clear()
+        isLoaded = true
+        isDirty = false
+        indexFile.delete()
+    }
+
+    private fun ensureLoaded() {
+        if (isLoaded) {
+            return
+        }
+
+        isLoaded = true
+        if (!indexFile.isFile) {
+            return
+        }
+
+        try {
+            RandomAccessFile(indexFile, "r").use { file ->
+                val buffer = file.channel.map(FileChannel.MapMode.READ_ONLY, 0, file.length()).order(ByteOrder.LITTLE_ENDIAN)
+                readEntries(buffer)
+            }
+        } catch (e: Exception) {
+            Log.w(TAG, "Failed to load ROM metadata index. It will be rebuilt", e)
+            entries.clear()
+            indexFile.delete()
+        }
+    }
+
+    private fun readEntries(buffer: ByteBuffer) {
+        if (buffer.remaining() < HEADER_SIZE || buffer.getInt() != MAGIC) {
+            throw IllegalStateException("Not a ROM metadata index")
+        }
+
+        val version = buffer.getInt()
+        if (version != FORMAT_VERSION) {
+            Log.i(TAG, "Discarding ROM metadata index with format version $version")
+            indexFile.delete()
+            return
+        }
+
+        val entryCount = buffer.getInt()
+        buffer.getInt()
+
+        try {
+            repeat(entryCount) {
+                val entry = Entry(
+                    size = buffer.getLong(),
+                    lastModified = buffer.getLong(),
+                    isDsiWareTitle = buffer.get() != 0.toByte(),
+                    uri = buffer.getString(),
+                    name = buffer.getString(),
+                    developerName = buffer.getString(),
+                    retroAchievementsHash = buffer.getString(),
+                )
+                entries[entry.uri] = entry
+            }
+        } catch (e: BufferUnderflowException) {
+            throw IllegalStateException("Truncated ROM metadata index", e)
+        }
+    }
+
+    private fun encodeEntry(entry: Entry): ByteArray {
+        val strings = listOf(entry.uri, entry.name, entry.developerName, entry.retroAchievementsHash).map { it.toByteArray(Charsets.UTF_8) }
+        val buffer = ByteBuffer.allocate(8 + 8 + 1 + strings.sumOf { 4 + it.size }).order(ByteOrder.LITTLE_ENDIAN)
+        buffer.putLong(entry.size)
+        buffer.putLong(entry.lastModified)
+        buffer.put(if (entry.isDsiWareTitle) 1 else 0)
+        strings.forEach {
+            buffer.putInt(it.size)
+            buffer.put(it)
+        }
+        return buffer.array()
+    }
+
+    private fun ByteBuffer.getString(): String {
+        val length = getInt()
+        if (length < 0 || length > remaining()) {
+            throw BufferUnderflowException()
+        }
+
+        val data = ByteArray(length)
+        get(data)
+        return String(data, Charsets.UTF_8)
+    }
+}
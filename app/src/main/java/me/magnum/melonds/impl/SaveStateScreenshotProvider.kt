@@ -1,7 +1,6 @@
 package me.magnum.melonds.impl
 
 import android.content.Context
-import android.graphics.Bitmap
 import android.net.Uri
 import androidx.documentfile.provider.DocumentFile
 import com.squareup.picasso.Picasso
@@ -18,13 +17,18 @@ class SaveStateScreenshotProvider(
         private const val SAVE_STATE_SCREENSHOTS_DIR = "ss_screenshots"
     }
 
-    fun saveRomSaveStateScreenshot(rom: Rom, saveState: SaveStateSlot, screenshot: Bitmap) {
-        val screenshotFile = getRomSaveStateScreenshotFile(rom, saveState, true) ?: return
-        screenshotFile.outputStream().use {
-            screenshot.compress(Bitmap.CompressFormat.PNG, 100, it)
-        }
+    /**
+     * Returns the file where the screenshot of the given save state should be written. The screenshot is encoded natively when the save state is
+     * written, so [invalidateRomSaveStateScreenshot] must be called afterwards to discard cached copies of the previous screenshot.
+     */
+    fun getRomSaveStateScreenshotOutputFile(rom: Rom, saveState: SaveStateSlot): File? {
+        return getRomSaveStateScreenshotFile(rom, saveState, true)
+    }
 
-        invalidateScreenshotFile(screenshotFile)
+    fun invalidateRomSaveStateScreenshot(rom: Rom, saveState: SaveStateSlot) {
+        getRomSaveStateScreenshotFile(rom, saveState)?.let {
+            invalidateScreenshotFile(it)
+        }
     }
 
     fun getRomSaveStateScreenshotUri(rom: Rom, saveState: SaveStateSlot): Uri? {
@@ -38,6 +38,7 @@ import me.magnum.melonds.domain.model.FpsCounterPosition
 import me.magnum.melonds.domain.model.MacAddress
 import me.magnum.melonds.domain.model.MicSource
 import me.magnum.melonds.domain.model.RendererConfiguration
+import me.magnum.melonds.domain.model.RewindThumbnailSize
 import me.magnum.melonds.domain.model.RomIconFiltering
 import me.magnum.melonds.domain.model.SaveStateLocation
 import me.magnum.melonds.domain.model.SizeUnit
@@ -157,6 +158,7 @@ class SharedPreferencesSettingsRepository(
             rewindEnabled = isRewindEnabled(),
             rewindPeriodSeconds = getRewindPeriod(),
             rewindWindowSeconds = getRewindWindow(),
+            rewindThumbnailSize = getRewindThumbnailSize(),
             useJit = isJitEnabled(),
             consoleType = consoleType,
             soundEnabled = isSoundEnabled(),
@@ -332,6 +334,11 @@ class SharedPreferencesSettingsRepository(
         return preferences.getInt("rewind_window", 6) * 10
     }
 
+    private fun getRewindThumbnailSize(): RewindThumbnailSize {
+        val thumbnailSizePreference = preferences.getString("rewind_thumbnail_size", "medium")!!
+        return enumValueOfIgnoreCase(thumbnailSizePreference)
+    }
+
     private fun getVolume(): Int {
         return preferences.getInt("volume", 256).coerceIn(0, 256)
     }
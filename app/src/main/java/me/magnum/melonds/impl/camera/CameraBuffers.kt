@@ -1,21 +1,35 @@
 package me.magnum.melonds.impl.camera
 
+import me.magnum.melonds.MelonCameraFrameConverter
+import java.nio.ByteBuffer
+
+/**
+ * Set of preallocated direct buffers in which camera frames are written. Frames are written to the back buffer, which becomes the front buffer
+ * once the frame is complete. Since there are 3 buffers, the buffer that was last handed out as the front buffer is only reused after 2 more
+ * frames, which leaves plenty of time for it to be read.
+ */
 class CameraBuffers {
-    private val cameraBuffers = Array(2) {
-        // YUV 422 format. Byte structure: YUYV YUYV (4 bytes per 2 pixels)
-        ByteArray(640 * 480 * 2)
+    private val cameraBuffers = Array(3) {
+        ByteBuffer.allocateDirect(MelonCameraFrameConverter.FRAME_SIZE)
     }
+    @Volatile
     private var activeBufferIndex = 0
 
-    fun getFrontBuffer(): ByteArray {
+    fun getFrontBuffer(): ByteBuffer {
         return cameraBuffers[activeBufferIndex]
     }
 
-    fun getBackBuffer(): ByteArray {
+    fun getBackBuffer(): ByteBuffer {
         return cameraBuffers[(activeBufferIndex + 1) % cameraBuffers.size]
     }
 
     fun swapBuffers() {
         activeBufferIndex = (activeBufferIndex + 1) % cameraBuffers.size
     }
-}
\ No newline at end of file
+
+    fun clear() {
+        cameraBuffers.forEach {
+            MelonCameraFrameConverter.fillBlack(it)
+        }
+    }
+}
@@ -8,6 +8,7 @@ import me.magnum.melonds.common.camera.CameraType
 import me.magnum.melonds.common.camera.DSiCameraSource
 import me.magnum.melonds.domain.model.camera.DSiCameraSourceType
 import me.magnum.melonds.domain.repositories.SettingsRepository
+import java.nio.ByteBuffer
 
 class DSiCameraSourceMultiplexer(
     private val dsiCameraSources: Map<DSiCameraSourceType, DSiCameraSource>,
@@ -53,8 +54,8 @@ class DSiCameraSourceMultiplexer(
         activeDSiCameraSource?.stopCamera(camera)
     }
 
-    override fun captureFrame(camera: CameraType, buffer: ByteArray, width: Int, height: Int, isYuv: Boolean) {
-        activeDSiCameraSource?.captureFrame(camera, buffer, width, height, isYuv)
+    override fun captureFrame(camera: CameraType, width: Int, height: Int, isYuv: Boolean): ByteBuffer? {
+        return activeDSiCameraSource?.captureFrame(camera, width, height, isYuv)
     }
 
     override fun dispose() {
@@ -2,7 +2,6 @@ package me.magnum.melonds.impl.camera
 
 import android.content.Context
 import android.content.pm.PackageManager
-import android.graphics.Matrix
 import android.hardware.camera2.CameraManager
 import android.os.Handler
 import android.os.Looper
@@ -20,12 +19,12 @@ import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.cancel
 import kotlinx.coroutines.launch
+import me.magnum.melonds.MelonCameraFrameConverter
 import me.magnum.melonds.common.PermissionHandler
 import me.magnum.melonds.common.camera.CameraType
 import me.magnum.melonds.common.camera.DSiCameraSource
 import me.magnum.melonds.impl.emulator.LifecycleOwnerProvider
 import java.nio.ByteBuffer
-import java.util.Arrays
 import java.util.concurrent.Executors
 
 class PhysicalDSiCameraSource(
@@ -41,8 +40,6 @@ class PhysicalDSiCameraSource(
     private val cameraBuffers = CameraBuffers()
     private val executor = Executors.newSingleThreadExecutor()
     private val handler = Handler(Looper.getMainLooper())
-    private val originalPoints = FloatArray(640 * 480 * 2)
-    private val mappedPoints = FloatArray(640 * 480 * 2)
 
     override fun isAvailable(): Boolean {
         val cameraManager = context.getSystemService(Context.CAMERA_SERVICE) as CameraManager
@@ -51,8 +48,7 @@ class PhysicalDSiCameraSource(
     }
 
     override fun startCamera(camera: CameraType) {
-        initializeOriginalPoints()
-        Arrays.fill(cameraBuffers.getFrontBuffer(), 0)
+        cameraBuffers.clear()
         if (ContextCompat.checkSelfPermission(context, android.Manifest.permission.CAMERA) != PackageManager.PERMISSION_GRANTED) {
             coroutineScope.launch {
                 permissionHandler.checkPermission(android.Manifest.permission.CAMERA)
@@ -72,9 +68,8 @@ class PhysicalDSiCameraSource(
         }
     }
 
-    override fun captureFrame(camera: CameraType, buffer: ByteArray, width: Int, height: Int, isYuv: Boolean) {
-        val currentFrontBuffer = cameraBuffers.getFrontBuffer()
-        System.arraycopy(currentFrontBuffer, 0, buffer, 0, currentFrontBuffer.size)
+    override fun captureFrame(camera: CameraType, width: Int, height: Int, isYuv: Boolean): ByteBuffer {
+        return cameraBuffers.getFrontBuffer()
     }
 
     override fun dispose() {
@@ -102,15 +97,15 @@ class PhysicalDSiCameraSource(
                     .build()
 
                 analyzer.setAnalyzer(executor) { imageProxy ->
-                    val yBuffer = imageProxy.planes[0].buffer
+                    val yPlane = imageProxy.planes[0]
                     val uPlane = imageProxy.planes[1]
                     val vPlane = imageProxy.planes[2]
 
-                    yBuffer.rewind()
+                    yPlane.buffer.rewind()
                     uPlane.buffer.rewind()
                     vPlane.buffer.rewind()
 
-                    captureFrameSample(yBuffer, uPlane, vPlane, imageProxy.width, imageProxy.height, imageProxy.imageInfo)
+                    captureFrameSample(yPlane, uPlane, vPlane, imageProxy.width, imageProxy.height, imageProxy.imageInfo)
 
                     imageProxy.close()
                 }
@@ -135,81 +130,31 @@ class PhysicalDSiCameraSource(
         )
     }
 
-    private fun captureFrameSample(yBuffer: ByteBuffer, uPlane: PlaneProxy, vPlane: PlaneProxy, sourceWidth: Int, sourceHeight: Int, imageInfo: ImageInfo) {
+    private fun captureFrameSample(yPlane: PlaneProxy, uPlane: PlaneProxy, vPlane: PlaneProxy, sourceWidth: Int, sourceHeight: Int, imageInfo: ImageInfo) {
         if (sourceWidth == 0) throw DSiCameraException("Image width is 0")
         if (sourceHeight == 0) throw DSiCameraException("Image height is 0")
-        if (yBuffer.remaining() == 0) throw DSiCameraException("Y buffer is empty")
+        if (yPlane.buffer.remaining() == 0) throw DSiCameraException("Y buffer is empty")
         if (uPlane.buffer.remaining() == 0) throw DSiCameraException("U buffer is empty")
         if (uPlane.rowStride == 0) throw DSiCameraException("U plane row stride is 0")
         if (uPlane.pixelStride == 0) throw DSiCameraException("U plane pixel stride is 0")
         if (vPlane.buffer.remaining() == 0) throw DSiCameraException("V buffer is empty")
-        if (vPlane.rowStride == 0) throw DSiCameraException("V plane row stride is 0")
-        if (vPlane.pixelStride == 0) throw DSiCameraException("V plane pixel stride is 0")
-
-        val (realWidth, realHeight) = if (imageInfo.rotationDegrees == 90 || imageInfo.rotationDegrees == 270) {
-            sourceHeight to sourceWidth
-        } else {
-            sourceWidth to sourceHeight
-        }
-        val targetAspectRatio =  640 / 480f
-        val sourceAspectRatio = realWidth / realHeight.toFloat()
-        val scaleToFill = if (sourceAspectRatio > targetAspectRatio) {
-            realHeight / 480f
-        } else {
-            realWidth / 640f
-        }
-
-        val transformationMatrix = Matrix().apply {
-            setTranslate(-319.5f, -239.5f)
-            postRotate(-imageInfo.rotationDegrees.toFloat())
-            postScale(scaleToFill, scaleToFill)
-        }
-        val translateMatrix = Matrix().apply {
-            if (imageInfo.rotationDegrees == 90 || imageInfo.rotationDegrees == 270) {
-                setTranslate(239.5f * (realHeight / 480f), 319.5f * (realWidth / 640f))
-            } else {
-                setTranslate(319.5f * (realWidth / 640f), 239.5f * (realHeight / 480f))
-            }
-        }
-
-        transformationMatrix.mapPoints(mappedPoints, originalPoints)
-        translateMatrix.mapPoints(mappedPoints)
-
-        val uPlaneXScale = sourceWidth / uPlane.rowStride
-        val uPlaneYScale = sourceHeight / (uPlane.buffer.remaining() / uPlane.rowStride)
-        val vPlaneXScale = sourceWidth / vPlane.rowStride
-        val vPlaneYScale = sourceHeight / (vPlane.buffer.remaining() / vPlane.rowStride)
-
-        val backBuffer = cameraBuffers.getBackBuffer()
-        for (yPos in 0 until 480) {
-            for (xPos in 0 until 640) {
-
-                val targetInlinePos = (yPos * 640 + xPos) * 2
-
-                val pX = mappedPoints[targetInlinePos].toInt()
-                val pY = mappedPoints[targetInlinePos + 1].toInt()
-                val y = yBuffer.get(pY * sourceWidth + pX)
-
-                backBuffer[targetInlinePos] = y
-                backBuffer[targetInlinePos + 1] = if (xPos % 2 == 0) {
-                    // Divide and multiply by pixel stride to ensure that we are reading from aligned data
-                    uPlane.buffer.get((pY / uPlaneYScale * sourceWidth / uPlaneXScale) + (pX / uPlaneXScale / uPlane.pixelStride * uPlane.pixelStride))
-                } else {
-                    vPlane.buffer.get((pY / vPlaneYScale * sourceWidth / vPlaneXScale) + (pX / vPlaneXScale / vPlane.pixelStride * vPlane.pixelStride))
-                }
-            }
-        }
+        if (vPlane.rowStride != uPlane.rowStride) throw DSiCameraException("U and V planes have different row strides")
+        if (vPlane.pixelStride != uPlane.pixelStride) throw DSiCameraException("U and V planes have different pixel strides")
+
+        // Rotation, scaling and cropping are done natively, directly from the image planes into the back buffer
+        MelonCameraFrameConverter.convertYuv420ToYuyv(
+            yPlane = yPlane.buffer,
+            uPlane = uPlane.buffer,
+            vPlane = vPlane.buffer,
+            width = sourceWidth,
+            height = sourceHeight,
+            yRowStride = yPlane.rowStride,
+            uvRowStride = uPlane.rowStride,
+            uvPixelStride = uPlane.pixelStride,
+            rotationDegrees = imageInfo.rotationDegrees,
+            output = cameraBuffers.getBackBuffer(),
+        )
 
         cameraBuffers.swapBuffers()
     }
-
-    private fun initializeOriginalPoints() {
-        for (y in 0 until 480) {
-            for (x in 0 until 640) {
-                val inlinePos = (y * 640 + x) * 2
-                originalPoints[inlinePos] = x.toFloat()
-                originalPoints[inlinePos + 1] = y.toFloat()
-            }
-        }
-    }
 }
\ No newline at end of file
@@ -16,11 +16,13 @@ import kotlinx.coroutines.cancel
 import kotlinx.coroutines.flow.collectLatest
 import kotlinx.coroutines.launch
 import kotlinx.coroutines.withContext
+import me.magnum.melonds.MelonCameraFrameConverter
 import me.magnum.melonds.R
 import me.magnum.melonds.common.camera.CameraType
 import me.magnum.melonds.common.camera.DSiCameraSource
 import me.magnum.melonds.domain.repositories.SettingsRepository
 import me.magnum.melonds.impl.image.BitmapLoader
+import java.nio.ByteBuffer
 
 class StaticImageDSiCameraSource(
     private val context: Context,
@@ -30,7 +32,7 @@ class StaticImageDSiCameraSource(
 
     private val coroutineScope = CoroutineScope(Dispatchers.IO + SupervisorJob())
     private var imageObserveJob: Job? = null
-    private val currentImageBuffer = ByteArray(640 * 480 * 2)
+    private val currentImageBuffer = ByteBuffer.allocateDirect(MelonCameraFrameConverter.FRAME_SIZE)
 
     override fun isAvailable() = true
 
@@ -68,10 +70,10 @@ class StaticImageDSiCameraSource(
                 val u = ((-38 * pixel1.red - 74 * pixel1.green + 112 * pixel1.blue + 128) shr 8) + 128
                 val v = ((112 * pixel1.red - 94 * pixel1.green - 18 * pixel1.blue + 128) shr 8) + 128
 
-                currentImageBuffer[y * bitmap.width * 2 + x * 2 + 0] = y1.toByte()
-                currentImageBuffer[y * bitmap.width * 2 + x * 2 + 1] = u.toByte()
-                currentImageBuffer[y * bitmap.width * 2 + x * 2 + 2] = y2.toByte()
-                currentImageBuffer[y * bitmap.width * 2 + x * 2 + 3] = v.toByte()
+                currentImageBuffer.put(y * bitmap.width * 2 + x * 2 + 0, y1.toByte())
+                currentImageBuffer.put(y * bitmap.width * 2 + x * 2 + 1, u.toByte())
+                currentImageBuffer.put(y * bitmap.width * 2 + x * 2 + 2, y2.toByte())
+                currentImageBuffer.put(y * bitmap.width * 2 + x * 2 + 3, v.toByte())
             }
         }
     }
@@ -81,8 +83,8 @@ class StaticImageDSiCameraSource(
         imageObserveJob = null
     }
 
-    override fun captureFrame(camera: CameraType, buffer: ByteArray, width: Int, height: Int, isYuv: Boolean) {
-        System.arraycopy(currentImageBuffer, 0, buffer, 0, currentImageBuffer.size)
+    override fun captureFrame(camera: CameraType, width: Int, height: Int, isYuv: Boolean): ByteBuffer {
+        return currentImageBuffer
     }
 
     override fun dispose() {
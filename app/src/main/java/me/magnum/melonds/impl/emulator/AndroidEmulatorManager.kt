@@ -3,6 +3,8 @@ package me.magnum.melonds.impl.emulator
 import android.content.Context
 import android.net.Uri
 import androidx.documentfile.provider.DocumentFile
+import kotlinx.coroutines.CompletableDeferred
+import kotlinx.coroutines.Deferred
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.flow.Flow
 import kotlinx.coroutines.flow.MutableSharedFlow
@@ -18,6 +20,8 @@ import me.magnum.melonds.domain.model.Cheat
 import me.magnum.melonds.domain.model.ConsoleType
 import me.magnum.melonds.domain.model.EmulatorConfiguration
 import me.magnum.melonds.domain.model.MicSource
+import me.magnum.melonds.domain.model.VideoFiltering
+import me.magnum.melonds.domain.model.emulator.EmulatorConfigurationChange
 import me.magnum.melonds.domain.model.emulator.EmulatorEvent
 import me.magnum.melonds.domain.model.emulator.FirmwareLaunchResult
 import me.magnum.melonds.domain.model.emulator.RomLaunchResult
@@ -33,6 +37,9 @@ import me.magnum.melonds.extensions.extension
 import me.magnum.melonds.impl.camera.DSiCameraSourceMultiplexer
 import me.magnum.melonds.ui.emulator.rewind.model.RewindSaveState
 import me.magnum.melonds.ui.emulator.rewind.model.RewindWindow
+import java.io.File
+import java.util.concurrent.ConcurrentHashMap
+import java.util.concurrent.atomic.AtomicInteger
 
 class AndroidEmulatorManager(
     private val context: Context,
@@ -49,6 +56,9 @@ class AndroidEmulatorManager(
 
     private val achievementsSharedFlow = MutableSharedFlow<RAEvent>(replay = 0, extraBufferCapacity = Int.MAX_VALUE)
 
+    private val nextSaveStateRequestId = AtomicInteger(0)
+    private val pendingSaveStateWrites = ConcurrentHashMap<Int, CompletableDeferred<Boolean>>()
+
     private val messageQueue = EmulatorMessageQueue { type, data ->
         when (type) {
             EmulatorEventType.EventRumbleStart -> _emulatorEvents.tryEmit(EmulatorEvent.RumbleStart(data.getInt()))
@@ -83,6 +93,11 @@ class AndroidEmulatorManager(
                 )
                 achievementsSharedFlow.tryEmit(event)
             }
+            EmulatorEventType.EventSaveStateWritten -> {
+                val requestId = data.getInt()
+                val success = data.getInt() != 0
+                pendingSaveStateWrites.remove(requestId)?.complete(success)
+            }
         }
     }
 
@@ -145,14 +160,14 @@ class AndroidEmulatorManager(
         }
     }
 
-    override suspend fun updateRomEmulatorConfiguration(rom: Rom) {
+    override suspend fun updateRomEmulatorConfiguration(rom: Rom): Set<EmulatorConfigurationChange> {
         val configuration = getRomEmulatorConfiguration(rom)
-        MelonEmulator.updateEmulatorConfiguration(configuration)
+        return MelonEmulator.updateEmulatorConfiguration(configuration)
     }
 
-    override suspend fun updateFirmwareEmulatorConfiguration(consoleType: ConsoleType) {
+    override suspend fun updateFirmwareEmulatorConfiguration(consoleType: ConsoleType): Set<EmulatorConfigurationChange> {
         val configuration = getFirmwareEmulatorConfiguration(consoleType)
-        MelonEmulator.updateEmulatorConfiguration(configuration)
+        return MelonEmulator.updateEmulatorConfiguration(configuration)
     }
 
     override suspend fun getRewindWindow(): RewindWindow {
@@ -163,6 +178,10 @@ class AndroidEmulatorManager(
         return MelonEmulator.getFPS()
     }
 
+    override fun updateVideoFiltering(videoFiltering: VideoFiltering) {
+        MelonEmulator.setCpuVideoFilter(videoFiltering.cpuFilter)
+    }
+
     override suspend fun pauseEmulator() {
         MelonEmulator.pauseEmulation()
     }
@@ -201,8 +220,17 @@ class AndroidEmulatorManager(
         return MelonEmulator.loadRewindState(rewindSaveState)
     }
 
-    override suspend fun saveState(saveStateFileUri: Uri): Boolean = withContext(Dispatchers.IO) {
-        MelonEmulator.saveState(saveStateFileUri)
+    override suspend fun saveState(saveStateFileUri: Uri, temporaryFileUri: Uri, screenshotFile: File?): Deferred<Boolean>? = withContext(Dispatchers.IO) {
+        val requestId = nextSaveStateRequestId.getAndIncrement()
+        val writeResult = CompletableDeferred<Boolean>()
+        pendingSaveStateWrites[requestId] = writeResult
+
+        if (MelonEmulator.saveStateAsync(saveStateFileUri, temporaryFileUri, screenshotFile, requestId)) {
+            writeResult
+        } else {
+            pendingSaveStateWrites.remove(requestId)
+            null
+        }
     }
 
     override suspend fun loadState(saveStateFileUri: Uri): Boolean = withContext(Dispatchers.IO) {
@@ -213,6 +241,10 @@ class AndroidEmulatorManager(
         MelonEmulator.stopEmulation()
         cameraManager.stopCurrentCameraSource()
         messageQueue.stop()
+
+        // Pending writes have been flushed when the emulator stopped, but their completion events may not be delivered anymore
+        pendingSaveStateWrites.values.forEach { it.cancel() }
+        pendingSaveStateWrites.clear()
     }
 
     override fun cleanEmulator() {
@@ -0,0 +1,52 @@
+package me.magnum.melonds.impl.emulator
+
+/**
+ * Layout of the serialized emulator configuration. The constants must match EmulatorConfigurationLayout.h, which is checked by
+ * EmulatorConfigurationLayoutTest. [LAYOUT_VERSION] must be increased whenever the layout changes.
+ */
+object EmulatorConfigurationLayout {
+    const val LAYOUT_VERSION = 1
+
+    const val VERSION_OFFSET = 0
+    const val SIZE_OFFSET = 4
+    const val USE_CUSTOM_BIOS_OFFSET = 8
+    const val SHOW_BOOT_SCREEN_OFFSET = 9
+    const val REWIND_ENABLED_OFFSET = 10
+    const val USE_JIT_OFFSET = 11
+    const val SOUND_ENABLED_OFFSET = 12
+    const val THREADED_RENDERING_OFFSET = 13
+    const val RANDOMIZE_MAC_ADDRESS_OFFSET = 14
+    const val FAST_FORWARD_SPEED_MULTIPLIER_OFFSET = 16
+    const val REWIND_PERIOD_SECONDS_OFFSET = 20
+    const val REWIND_WINDOW_SECONDS_OFFSET = 24
+    const val REWIND_THUMBNAIL_SCALE_OFFSET = 28
+    const val CONSOLE_TYPE_OFFSET = 32
+    const val VOLUME_OFFSET = 36
+    const val AUDIO_INTERPOLATION_OFFSET = 40
+    const val AUDIO_BITRATE_OFFSET = 44
+    const val AUDIO_LATENCY_OFFSET = 48
+    const val MIC_SOURCE_OFFSET = 52
+    const val RENDERER_OFFSET = 56
+    const val RESOLUTION_SCALING_OFFSET = 60
+    const val FIRMWARE_LANGUAGE_OFFSET = 64
+    const val FIRMWARE_FAVOURITE_COLOUR_OFFSET = 68
+    const val FIRMWARE_BIRTHDAY_MONTH_OFFSET = 72
+    const val FIRMWARE_BIRTHDAY_DAY_OFFSET = 76
+    const val STRING_TABLE_OFFSET = 80
+
+    const val STRING_SLOT_SIZE = 8
+    const val STRING_DS_BIOS7 = 0
+    const val STRING_DS_BIOS9 = 1
+    const val STRING_DS_FIRMWARE = 2
+    const val STRING_DSI_BIOS7 = 3
+    const val STRING_DSI_BIOS9 = 4
+    const val STRING_DSI_FIRMWARE = 5
+    const val STRING_DSI_NAND = 6
+    const val STRING_INTERNAL_DIRECTORY = 7
+    const val STRING_FIRMWARE_NICKNAME = 8
+    const val STRING_FIRMWARE_MESSAGE = 9
+    const val STRING_FIRMWARE_MAC_ADDRESS = 10
+    const val STRING_COUNT = 11
+
+    const val STRING_DATA_OFFSET = STRING_TABLE_OFFSET + STRING_COUNT * STRING_SLOT_SIZE
+}
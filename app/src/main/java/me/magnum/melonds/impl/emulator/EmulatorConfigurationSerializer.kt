@@ -0,0 +1,123 @@
+package me.magnum.melonds.impl.emulator
+
+import me.magnum.melonds.domain.model.EmulatorConfiguration
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.AUDIO_BITRATE_OFFSET
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.AUDIO_INTERPOLATION_OFFSET
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.AUDIO_LATENCY_OFFSET
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.CONSOLE_TYPE_OFFSET
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.FAST_FORWARD_SPEED_MULTIPLIER_OFFSET
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.FIRMWARE_BIRTHDAY_DAY_OFFSET
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.FIRMWARE_BIRTHDAY_MONTH_OFFSET
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.FIRMWARE_FAVOURITE_COLOUR_OFFSET
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.FIRMWARE_LANGUAGE_OFFSET
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.LAYOUT_VERSION
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.MIC_SOURCE_OFFSET
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.RANDOMIZE_MAC_ADDRESS_OFFSET
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.RENDERER_OFFSET
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.RESOLUTION_SCALING_OFFSET
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.REWIND_ENABLED_OFFSET
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.REWIND_PERIOD_SECONDS_OFFSET
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.REWIND_THUMBNAIL_SCALE_OFFSET
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.REWIND_WINDOW_SECONDS_OFFSET
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.SHOW_BOOT_SCREEN_OFFSET
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.SIZE_OFFSET
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.SOUND_ENABLED_OFFSET
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.STRING_COUNT
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.STRING_DATA_OFFSET
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.STRING_DSI_BIOS7
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.STRING_DSI_BIOS9
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.STRING_DSI_FIRMWARE
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.STRING_DSI_NAND
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.STRING_DS_BIOS7
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.STRING_DS_BIOS9
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.STRING_DS_FIRMWARE
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.STRING_FIRMWARE_MAC_ADDRESS
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.STRING_FIRMWARE_MESSAGE
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.STRING_FIRMWARE_NICKNAME
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.STRING_INTERNAL_DIRECTORY
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.STRING_SLOT_SIZE
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.STRING_TABLE_OFFSET
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.THREADED_RENDERING_OFFSET
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.USE_CUSTOM_BIOS_OFFSET
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.USE_JIT_OFFSET
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.VERSION_OFFSET
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout.VOLUME_OFFSET
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+/**
+ * Serializes [EmulatorConfiguration] into the flat layout described by [EmulatorConfigurationLayout], so that the native side can read it
+ * without going through reflection.
+ */
+object EmulatorConfigurationSerializer {
+
+    /**
+     * Serializes the configuration into a new direct buffer, which can be handed to native code.
+     */
+    fun serialize(configuration: EmulatorConfiguration): ByteBuffer {
+        val strings = arrayOfNulls<ByteArray>(STRING_COUNT)
+        strings[STRING_DS_BIOS7] = configuration.dsBios7Uri?.toString()?.toByteArray()
+        strings[STRING_DS_BIOS9] = configuration.dsBios9Uri?.toString()?.toByteArray()
+        strings[STRING_DS_FIRMWARE] = configuration.dsFirmwareUri?.toString()?.toByteArray()
+        strings[STRING_DSI_BIOS7] = configuration.dsiBios7Uri?.toString()?.toByteArray()
+        strings[STRING_DSI_BIOS9] = configuration.dsiBios9Uri?.toString()?.toByteArray()
+        strings[STRING_DSI_FIRMWARE] = configuration.dsiFirmwareUri?.toString()?.toByteArray()
+        strings[STRING_DSI_NAND] = configuration.dsiNandUri?.toString()?.toByteArray()
+        strings[STRING_INTERNAL_DIRECTORY] = configuration.internalDirectory.toByteArray()
+        strings[STRING_FIRMWARE_NICKNAME] = configuration.firmwareConfiguration.nickname.toByteArray()
+        strings[STRING_FIRMWARE_MESSAGE] = configuration.firmwareConfiguration.message.toByteArray()
+        strings[STRING_FIRMWARE_MAC_ADDRESS] = configuration.firmwareConfiguration.internalMacAddress?.toByteArray()
+
+        // Every string is followed by a NUL terminator
+        val size = STRING_DATA_OFFSET + strings.sumOf { it?.size?.plus(1) ?: 0 }
+        val buffer = ByteBuffer.allocateDirect(size).order(ByteOrder.nativeOrder())
+
+        buffer.putInt(VERSION_OFFSET, LAYOUT_VERSION)
+        buffer.putInt(SIZE_OFFSET, size)
+        buffer.putBoolean(USE_CUSTOM_BIOS_OFFSET, configuration.useCustomBios)
+        buffer.putBoolean(SHOW_BOOT_SCREEN_OFFSET, configuration.showBootScreen)
+        buffer.putBoolean(REWIND_ENABLED_OFFSET, configuration.rewindEnabled)
+        buffer.putBoolean(USE_JIT_OFFSET, configuration.useJit)
+        buffer.putBoolean(SOUND_ENABLED_OFFSET, configuration.soundEnabled)
+        buffer.putBoolean(THREADED_RENDERING_OFFSET, configuration.rendererConfiguration.threadedRendering)
+        buffer.putBoolean(RANDOMIZE_MAC_ADDRESS_OFFSET, configuration.firmwareConfiguration.randomizeMacAddress)
+        buffer.putFloat(FAST_FORWARD_SPEED_MULTIPLIER_OFFSET, configuration.fastForwardSpeedMultiplier)
+        buffer.putInt(REWIND_PERIOD_SECONDS_OFFSET, configuration.rewindPeriodSeconds)
+        buffer.putInt(REWIND_WINDOW_SECONDS_OFFSET, configuration.rewindWindowSeconds)
+        buffer.putInt(REWIND_THUMBNAIL_SCALE_OFFSET, configuration.rewindThumbnailSize.scale)
+        buffer.putInt(CONSOLE_TYPE_OFFSET, configuration.consoleType.consoleType)
+        buffer.putInt(VOLUME_OFFSET, configuration.volume)
+        buffer.putInt(AUDIO_INTERPOLATION_OFFSET, configuration.audioInterpolation.interpolationValue)
+        buffer.putInt(AUDIO_BITRATE_OFFSET, configuration.audioBitrate.bitrateValue)
+        buffer.putInt(AUDIO_LATENCY_OFFSET, configuration.audioLatency.latencyValue)
+        buffer.putInt(MIC_SOURCE_OFFSET, configuration.micSource.sourceValue)
+        buffer.putInt(RENDERER_OFFSET, configuration.rendererConfiguration.renderer.renderer)
+        buffer.putInt(RESOLUTION_SCALING_OFFSET, configuration.rendererConfiguration.resolutionScaling)
+        buffer.putInt(FIRMWARE_LANGUAGE_OFFSET, configuration.firmwareConfiguration.language)
+        buffer.putInt(FIRMWARE_FAVOURITE_COLOUR_OFFSET, configuration.firmwareConfiguration.favouriteColour)
+        buffer.putInt(FIRMWARE_BIRTHDAY_MONTH_OFFSET, configuration.firmwareConfiguration.birthdayMonth)
+        buffer.putInt(FIRMWARE_BIRTHDAY_DAY_OFFSET, configuration.firmwareConfiguration.birthdayDay)
+
+        var stringOffset = STRING_DATA_OFFSET
+        strings.forEachIndexed { slot, string ->
+            val slotOffset = STRING_TABLE_OFFSET + slot * STRING_SLOT_SIZE
+            if (string == null) {
+                buffer.putInt(slotOffset, 0)
+                buffer.putInt(slotOffset + 4, -1)
+            } else {
+                buffer.putInt(slotOffset, stringOffset)
+                buffer.putInt(slotOffset + 4, string.size)
+                buffer.position(stringOffset)
+                buffer.put(string)
+                buffer.put(0)
+                stringOffset += string.size + 1
+            }
+        }
+
+        return buffer.rewind()
+    }
+
+    private fun ByteBuffer.putBoolean(offset: Int, value: Boolean) {
+        put(offset, if (value) 1 else 0)
+    }
+}
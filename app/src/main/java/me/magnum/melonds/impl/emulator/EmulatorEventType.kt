@@ -1,7 +1,8 @@
 package me.magnum.melonds.impl.emulator
 
 /**
- * Event types that can be emitted by the emulator. These constants must match the values defined in AndroidMelonEventMessenger.h
+ * Event types that can be emitted by the emulator. These constants must match the values defined in AndroidMelonEventMessenger.h and
+ * SaveStateWriter.h
  */
 enum class EmulatorEventType(val event: Int) {
     /**
@@ -74,4 +75,11 @@ enum class EmulatorEventType(val event: Int) {
      * * formated value string (`u8[32]`)
      */
     EventRALeaderboardAttemptCompleted(213),
+
+    /**
+     * Save state written to storage. Data:
+     * * request ID (`i32`)
+     * * success (`i32`, 1 if the save state was written)
+     */
+    EventSaveStateWritten(300),
 }
@@ -17,15 +17,19 @@ abstract class BaseRomFileProcessorFactory(private val context: Context) : RomFi
 
     override fun getFileRomProcessorForDocument(romDocument: DocumentFile): RomFileProcessor? {
         val fileName = romDocument.name ?: return null
-        val lastDotIndex = fileName.lastIndexOf('.')
-        if (lastDotIndex < 0) return null
-
-        val extension = fileName.substring(lastDotIndex + 1).lowercase()
-        return getRomFileProcessorForFileExtension(extension)
+        return getFileRomProcessorForFileName(fileName)
     }
 
     override fun getFileRomProcessorForDocument(romUri: Uri): RomFileProcessor? {
         val romDocument = DocumentFile.fromSingleUri(context, romUri) ?: return null
         return getFileRomProcessorForDocument(romDocument)
     }
-}
\ No newline at end of file
+
+    override fun getFileRomProcessorForFileName(fileName: String): RomFileProcessor? {
+        val lastDotIndex = fileName.lastIndexOf('.')
+        if (lastDotIndex < 0) return null
+
+        val extension = fileName.substring(lastDotIndex + 1).lowercase()
+        return getRomFileProcessorForFileExtension(extension)
+    }
+}
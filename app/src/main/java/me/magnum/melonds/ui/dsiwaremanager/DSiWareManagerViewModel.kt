@@ -6,12 +6,15 @@ import androidx.lifecycle.ViewModel
 import androidx.lifecycle.viewModelScope
 import dagger.hilt.android.lifecycle.HiltViewModel
 import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.cancelAndJoin
 import kotlinx.coroutines.channels.BufferOverflow
 import kotlinx.coroutines.flow.*
 import kotlinx.coroutines.launch
 import kotlinx.coroutines.withContext
 import me.magnum.melonds.domain.model.ConfigurationDirResult
 import me.magnum.melonds.domain.model.DSiWareTitle
+import me.magnum.melonds.domain.model.dsinand.DSiWareTitleImportProgress
 import me.magnum.melonds.domain.model.dsinand.ImportDSiWareTitleResult
 import me.magnum.melonds.domain.model.dsinand.OpenDSiNandResult
 import me.magnum.melonds.domain.repositories.SettingsRepository
@@ -23,6 +26,7 @@ import me.magnum.melonds.ui.dsiwaremanager.model.ImportExportDSiWareTitleFileEve
 import me.magnum.melonds.ui.romlist.RomIcon
 import java.nio.ByteBuffer
 import javax.inject.Inject
+import kotlin.time.Duration.Companion.milliseconds
 
 @HiltViewModel
 class DSiWareManagerViewModel @Inject constructor(
@@ -37,6 +41,10 @@ class DSiWareManagerViewModel @Inject constructor(
     private val _importingTitle = MutableStateFlow(false)
     val importingTitle: StateFlow<Boolean> = _importingTitle.asStateFlow()
 
+    private val _titleImportProgress = MutableStateFlow<DSiWareTitleImportProgress?>(null)
+    val titleImportProgress: StateFlow<DSiWareTitleImportProgress?> = _titleImportProgress.asStateFlow()
+    private var titleImportJob: Job? = null
+
     private val _importTitleError = MutableSharedFlow<ImportDSiWareTitleResult>(extraBufferCapacity = 1, onBufferOverflow = BufferOverflow.DROP_OLDEST)
     val importTitleError: SharedFlow<ImportDSiWareTitleResult> = _importTitleError.asSharedFlow()
 
@@ -47,23 +55,48 @@ class DSiWareManagerViewModel @Inject constructor(
         loadDSiWareData()
     }
 
-    fun importTitleToNand(titleUri: Uri) {
-        _importingTitle.value = true
+    fun importTitlesToNand(titleUris: List<Uri>) {
+        if (titleUris.isEmpty() || titleImportJob?.isActive == true) {
+            return
+        }
 
-        viewModelScope.launch {
+        titleImportJob = viewModelScope.launch {
             withContext(Dispatchers.Default) {
-                val result = dsiNandManager.importTitle(titleUri)
-                if (result == ImportDSiWareTitleResult.SUCCESS) {
+                var lastProgress: DSiWareTitleImportProgress? = null
+                try {
+                    dsiNandManager.importTitles(titleUris).collect {
+                        _titleImportProgress.value = it
+                        lastProgress = it
+                    }
+                } finally {
+                    _titleImportProgress.value = null
+                }
+
+                val results = lastProgress?.results.orEmpty()
+                if (results.any { it == ImportDSiWareTitleResult.SUCCESS }) {
                     val titles = dsiNandManager.listTitles()
                     _state.value = DSiWareManagerUiState.Ready(titles)
-                } else {
-                    _importTitleError.tryEmit(result)
                 }
-                _importingTitle.value = false
+                results.firstOrNull { it != ImportDSiWareTitleResult.SUCCESS }?.let {
+                    _importTitleError.tryEmit(it)
+                }
             }
         }
     }
 
+    /**
+     * Cancels the current title import. The title that is being imported is finished, but the remaining ones are skipped.
+     */
+    fun cancelTitleImport() {
+        val job = titleImportJob ?: return
+        viewModelScope.launch {
+            job.cancelAndJoin()
+            // Titles imported before the cancellation must still be shown
+            val titles = dsiNandManager.listTitles()
+            _state.value = DSiWareManagerUiState.Ready(titles)
+        }
+    }
+
     fun deleteTitle(title: DSiWareTitle) {
         viewModelScope.launch {
             withContext(Dispatchers.Default) {
@@ -111,7 +144,18 @@ class DSiWareManagerViewModel @Inject constructor(
             copyPixelsFromBuffer(ByteBuffer.wrap(title.icon))
         }
         val iconFiltering = settingsRepository.getRomIconFiltering()
-        return RomIcon(bitmap, iconFiltering)
+        val animation = title.animatedIcon?.let { animatedIcon ->
+            val frameSize = 32 * 32 * 4
+            RomIcon.Animation(
+                frames = List(animatedIcon.frameCount) { frame ->
+                    createBitmap(32, 32).apply {
+                        copyPixelsFromBuffer(ByteBuffer.wrap(animatedIcon.frames, frame * frameSize, frameSize))
+                    }
+                },
+                frameDurations = animatedIcon.frameDurations.map { (it * 1000L / 60).milliseconds },
+            )
+        }
+        return RomIcon(bitmap, iconFiltering, animation)
     }
 
     fun revalidateBiosConfiguration() {
@@ -11,7 +11,9 @@ import androidx.compose.material.IconButton
 import androidx.compose.material.MaterialTheme
 import androidx.compose.material.Text
 import androidx.compose.runtime.Composable
+import androidx.compose.runtime.LaunchedEffect
 import androidx.compose.runtime.getValue
+import androidx.compose.runtime.mutableIntStateOf
 import androidx.compose.runtime.mutableStateOf
 import androidx.compose.runtime.remember
 import androidx.compose.runtime.setValue
@@ -29,6 +31,7 @@ import androidx.compose.ui.unit.dp
 import androidx.compose.ui.unit.sp
 import androidx.core.graphics.createBitmap
 import androidx.core.graphics.set
+import kotlinx.coroutines.delay
 import me.magnum.melonds.R
 import me.magnum.melonds.domain.model.DSiWareTitle
 import me.magnum.melonds.domain.model.RomIconFiltering
@@ -59,12 +62,22 @@ fun DSiWareItem(
             val icon = remember(item.titleId) {
                 retrieveTitleIcon()
             }
+            val iconBitmap = icon.animation?.let { animation ->
+                var frame by remember(item.titleId) { mutableIntStateOf(0) }
+                LaunchedEffect(item.titleId) {
+                    while (true) {
+                        delay(animation.frameDurations[frame])
+                        frame = (frame + 1) % animation.frames.size
+                    }
+                }
+                animation.frames[frame]
+            } ?: icon.bitmap
 
             Image(
                 modifier = Modifier
                     .size(48.dp)
                     .align(CenterVertically),
-                bitmap = icon.bitmap?.asImageBitmap() ?: ImageBitmap(1, 1),
+                bitmap = iconBitmap?.asImageBitmap() ?: ImageBitmap(1, 1),
                 contentDescription = null,
                 filterQuality = when (icon.filtering) {
                     RomIconFiltering.NONE -> FilterQuality.None
@@ -31,6 +31,7 @@ import androidx.compose.material.Button
 import androidx.compose.material.CircularProgressIndicator
 import androidx.compose.material.Icon
 import androidx.compose.material.IconButton
+import androidx.compose.material.LinearProgressIndicator
 import androidx.compose.material.MaterialTheme
 import androidx.compose.material.Scaffold
 import androidx.compose.material.Text
@@ -63,14 +64,17 @@ import com.google.accompanist.systemuicontroller.rememberSystemUiController
 import kotlinx.coroutines.flow.collectLatest
 import me.magnum.melonds.R
 import me.magnum.melonds.common.Permission
-import me.magnum.melonds.common.contracts.FilePickerContract
+import me.magnum.melonds.common.contracts.MultipleFilePickerContract
 import me.magnum.melonds.domain.model.ConfigurationDirResult
 import me.magnum.melonds.domain.model.DSiWareTitle
 import me.magnum.melonds.domain.model.RomIconFiltering
 import me.magnum.melonds.domain.model.dsinand.DSiWareTitleFileType
+import me.magnum.melonds.domain.model.dsinand.DSiWareTitleImportProgress
 import me.magnum.melonds.domain.model.dsinand.ImportDSiWareTitleResult
 import me.magnum.melonds.ui.common.FabActionItem
 import me.magnum.melonds.ui.common.MultiActionFloatingActionButton
+import me.magnum.melonds.ui.common.component.dialog.BaseDialog
+import me.magnum.melonds.ui.common.component.dialog.DialogButton
 import me.magnum.melonds.ui.common.melonButtonColors
 import me.magnum.melonds.ui.dsiwaremanager.DSiWareManagerViewModel
 import me.magnum.melonds.ui.dsiwaremanager.model.DSiWareManagerUiState
@@ -89,6 +93,7 @@ fun DSiWareManagerScreen(
 ) {
     val state by viewModel.state.collectAsState()
     val importingTitle = viewModel.importingTitle.collectAsState(false)
+    val titleImportProgress by viewModel.titleImportProgress.collectAsState()
     val context = LocalContext.current
     val showingRomList = rememberSaveable(null) { mutableStateOf(false) }
     val systemUiController = rememberSystemUiController()
@@ -100,10 +105,8 @@ fun DSiWareManagerScreen(
         onFilePicked = viewModel::exportDSiWareTitleFile,
     )
 
-    val importTitleLauncher = rememberLauncherForActivityResult(FilePickerContract(Permission.READ)) {
-        if (it != null) {
-            viewModel.importTitleToNand(it)
-        }
+    val importTitleLauncher = rememberLauncherForActivityResult(MultipleFilePickerContract(Permission.READ)) {
+        viewModel.importTitlesToNand(it)
     }
 
     systemUiController.setStatusBarColor(MaterialTheme.colors.primaryVariant)
@@ -146,7 +149,7 @@ fun DSiWareManagerScreen(
                     ),
                     onActionClicked = {
                         when (it.id) {
-                            FAB_ITEM_FROM_FILE -> { importTitleLauncher.launch(null to arrayOf("*/*")) }
+                            FAB_ITEM_FROM_FILE -> { importTitleLauncher.launch(arrayOf("*/*")) }
                             FAB_ITEM_FROM_ROM_LIST -> showingRomList.value = true
                             else -> {}
                         }
@@ -190,7 +193,7 @@ fun DSiWareManagerScreen(
         DSiWareRomListDialog(
             onDismiss = { showingRomList.value = false },
             onRomSelected = {
-                viewModel.importTitleToNand(it.uri)
+                viewModel.importTitlesToNand(listOf(it.uri))
                 showingRomList.value = false
             },
         )
@@ -205,6 +208,13 @@ fun DSiWareManagerScreen(
         }
     }
 
+    titleImportProgress?.let {
+        TitleImportProgressDialog(
+            progress = it,
+            onCancel = viewModel::cancelTitleImport,
+        )
+    }
+
     LaunchedEffect(null) {
         viewModel.importTitleError.collectLatest {
             Toast.makeText(context, getImportTitleResultMessage(context, it), Toast.LENGTH_LONG).show()
@@ -218,6 +228,40 @@ fun DSiWareManagerScreen(
     }
 }
 
+@Composable
+private fun TitleImportProgressDialog(progress: DSiWareTitleImportProgress, onCancel: () -> Unit) {
+    val isCancelling = rememberSaveable { mutableStateOf(false) }
+
+    BaseDialog(
+        title = stringResource(R.string.import_dsiware_title),
+        onDismiss = { },
+        content = {
+            Column(Modifier.padding(it)) {
+                Text(
+                    text = stringResource(R.string.dsiware_manager_importing_titles, (progress.processedTitles + 1).coerceAtMost(progress.totalTitles), progress.totalTitles),
+                    style = MaterialTheme.typography.body1,
+                )
+                Spacer(Modifier.height(16.dp))
+                LinearProgressIndicator(
+                    modifier = Modifier.fillMaxWidth(),
+                    progress = progress.processedTitles / progress.totalTitles.toFloat(),
+                    color = MaterialTheme.colors.secondary,
+                )
+            }
+        },
+        buttons = {
+            DialogButton(
+                text = stringResource(R.string.cancel),
+                enabled = !isCancelling.value,
+                onClick = {
+                    isCancelling.value = true
+                    onCancel()
+                },
+            )
+        },
+    )
+}
+
 @Composable
 private fun InvalidSetup(modifier: Modifier, configurationStatus: ConfigurationDirResult.Status, onBiosConfigurationFinished: () -> Unit) {
     val context = LocalContext.current
@@ -42,6 +42,7 @@ import me.magnum.melonds.domain.model.FpsCounterPosition
 import me.magnum.melonds.domain.model.RomInfo
 import me.magnum.melonds.domain.model.RuntimeBackground
 import me.magnum.melonds.domain.model.SaveStateSlot
+import me.magnum.melonds.domain.model.emulator.EmulatorConfigurationChange
 import me.magnum.melonds.domain.model.emulator.EmulatorEvent
 import me.magnum.melonds.domain.model.emulator.EmulatorSessionUpdateAction
 import me.magnum.melonds.domain.model.emulator.FirmwareLaunchResult
@@ -314,12 +315,14 @@ class EmulatorViewModel @Inject constructor(
                 settingsRepository.isRetroAchievementsHardcoreEnabled(),
             )
 
-            when (currentState) {
+            val configurationChanges = when (currentState) {
                 is EmulatorState.RunningRom -> emulatorManager.updateRomEmulatorConfiguration(currentState.rom)
                 is EmulatorState.RunningFirmware -> emulatorManager.updateFirmwareEmulatorConfiguration(currentState.console)
-                else -> {
-                    // Do nothing
-                }
+                else -> emptySet()
+            }
+
+            if (EmulatorConfigurationChange.COLD in configurationChanges) {
+                _toastEvent.tryEmit(ToastEvent.ResetRequiredToApplySettings)
             }
 
             dispatchSessionUpdateActions(sessionUpdateActions)
@@ -564,13 +567,18 @@ class EmulatorViewModel @Inject constructor(
 
     private suspend fun saveRomState(rom: Rom, slot: SaveStateSlot): Boolean {
         val slotUri = saveStatesRepository.getRomSaveStateUri(rom, slot)
-        return if (emulatorManager.saveState(slotUri)) {
-            val screenshot = screenshotFrameBufferProvider.getScreenshot()
-            saveStatesRepository.setRomSaveStateScreenshot(rom, slot, screenshot)
-            true
-        } else {
-            false
+        val temporaryUri = saveStatesRepository.getRomSaveStateTemporaryUri(rom, slot)
+        val screenshotFile = saveStatesRepository.getRomSaveStateScreenshotFile(rom, slot)
+        val writeResult = emulatorManager.saveState(slotUri, temporaryUri, screenshotFile) ?: return false
+
+        sessionCoroutineScope.launch {
+            if (writeResult.await()) {
+                saveStatesRepository.onRomSaveStateScreenshotUpdated(rom, slot)
+            } else {
+                _toastEvent.emit(ToastEvent.StateSaveFailed)
+            }
         }
+        return true
     }
 
     private suspend fun loadRomState(rom: Rom, slot: SaveStateSlot): Boolean {
@@ -713,6 +721,7 @@ class EmulatorViewModel @Inject constructor(
     private fun startObservingRendererConfiguration() {
         sessionCoroutineScope.launch {
             settingsRepository.observeRenderConfiguration().collectLatest {
+                emulatorManager.updateVideoFiltering(it.videoFiltering)
                 _runtimeRendererConfiguration.value = RuntimeRendererConfiguration(it.videoFiltering, it.resolutionScaling)
             }
         }
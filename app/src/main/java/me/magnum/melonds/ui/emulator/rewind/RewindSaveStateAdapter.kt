@@ -1,7 +1,6 @@
 package me.magnum.melonds.ui.emulator.rewind
 
 import android.content.Context
-import android.graphics.drawable.BitmapDrawable
 import android.view.LayoutInflater
 import android.view.ViewGroup
 import androidx.core.view.marginLeft
@@ -28,7 +27,7 @@ class RewindSaveStateAdapter(private val onRewindSaveStateSelected: (RewindSaveS
         private lateinit var state: RewindSaveState
 
         fun setRewindSaveState(state: RewindSaveState, window: RewindWindow) {
-            val screenshotDrawable = state.screenshot.toDrawable(context.resources)
+            val screenshotDrawable = window.loadThumbnail(state)?.toDrawable(context.resources)
             val durationToState = window.getDeltaFromEmulationTimeToRewindState(state)
 
             binding.imageScreenshot.setImageDrawable(screenshotDrawable)
@@ -88,12 +87,12 @@ class RewindSaveStateAdapter(private val onRewindSaveStateSelected: (RewindSaveS
 
     override fun onBindViewHolder(holder: RewindSaveStateViewHolder, position: Int) {
         currentRewindWindow?.let {
-            val state = it.rewindStates[position]
+            val state = it.getRewindState(position) ?: return
             holder.setRewindSaveState(state, it)
         }
     }
 
     override fun getItemCount(): Int {
-        return currentRewindWindow?.rewindStates?.size ?: 0
+        return currentRewindWindow?.stateCount ?: 0
     }
 }
\ No newline at end of file
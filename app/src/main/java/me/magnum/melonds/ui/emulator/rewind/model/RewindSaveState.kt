@@ -1,14 +1,6 @@
 package me.magnum.melonds.ui.emulator.rewind.model
 
-import android.graphics.Bitmap
-import me.magnum.melonds.utils.DsScreenshotConverter
-import java.nio.ByteBuffer
-
-class RewindSaveState(
-    val buffer: ByteBuffer,
-    val bufferContentSize: Long,
-    val screenshotBuffer: ByteBuffer,
-    val frame: Int,
-) {
-    val screenshot: Bitmap get() = DsScreenshotConverter.fromByteBufferToBitmap(screenshotBuffer)
-}
\ No newline at end of file
+/**
+ * A state in the rewind history. The state data itself is kept compressed in native memory and is identified by its [frame].
+ */
+data class RewindSaveState(val frame: Int)
@@ -1,16 +1,75 @@
 package me.magnum.melonds.ui.emulator.rewind.model
 
-import java.util.*
+import android.graphics.Bitmap
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
 import kotlin.time.Duration
 import kotlin.time.Duration.Companion.milliseconds
 
+/**
+ * View over the rewind descriptor table owned by native code. The table is read in place, so no objects are created for states that are never
+ * displayed. Thumbnails are only copied out of native memory when requested through [loadThumbnail]. States captured or evicted after the window
+ * was created are not reflected in it. Loading the thumbnail of an evicted state fails.
+ *
+ * Native code reuses the same table for every window, so opening a new window makes the previous ones stale (see [isStale]).
+ *
+ * The layout must match RewindHistory::DescriptorTableHeader and RewindHistory::StateDescriptor.
+ */
 class RewindWindow(
-    val currentEmulationFrame: Int,
-    val rewindStates: ArrayList<RewindSaveState>
+    descriptorTable: ByteBuffer,
+    private val thumbnailLoader: (frame: Int, thumbnailBuffer: ByteBuffer) -> Boolean,
 ) {
 
     companion object {
         private const val FRAMES_PER_SECOND = 60
+
+        private const val HEADER_SIZE = 24
+        private const val HEADER_GENERATION_OFFSET = 0
+        private const val HEADER_CURRENT_FRAME_OFFSET = 4
+        private const val HEADER_STATE_COUNT_OFFSET = 8
+        private const val HEADER_DESCRIPTOR_SIZE_OFFSET = 12
+        private const val HEADER_THUMBNAIL_WIDTH_OFFSET = 16
+        private const val HEADER_THUMBNAIL_HEIGHT_OFFSET = 20
+        private const val DESCRIPTOR_FRAME_OFFSET = 0
+    }
+
+    private val descriptorTable = descriptorTable.order(ByteOrder.nativeOrder())
+
+    val generation = this.descriptorTable.getInt(HEADER_GENERATION_OFFSET)
+    val currentEmulationFrame = this.descriptorTable.getInt(HEADER_CURRENT_FRAME_OFFSET)
+    val stateCount = this.descriptorTable.getInt(HEADER_STATE_COUNT_OFFSET)
+    private val descriptorSize = this.descriptorTable.getInt(HEADER_DESCRIPTOR_SIZE_OFFSET)
+    private val thumbnailWidth = this.descriptorTable.getInt(HEADER_THUMBNAIL_WIDTH_OFFSET)
+    private val thumbnailHeight = this.descriptorTable.getInt(HEADER_THUMBNAIL_HEIGHT_OFFSET)
+    // Thumbnails are stored as RGB565, which matches the layout of RGB_565 bitmaps
+    private val thumbnailBuffer by lazy { ByteBuffer.allocateDirect(thumbnailWidth * thumbnailHeight * 2).order(ByteOrder.nativeOrder()) }
+
+    /**
+     * Whether the table has been rewritten for a newer window since this window was created. Stale windows no longer describe their states.
+     */
+    val isStale get() = descriptorTable.getInt(HEADER_GENERATION_OFFSET) != generation
+
+    /**
+     * Returns the state at the given index, or null if the window is stale. States are sorted from newest to oldest.
+     */
+    fun getRewindState(index: Int): RewindSaveState? {
+        if (isStale) {
+            return null
+        }
+
+        val descriptorOffset = HEADER_SIZE + index * descriptorSize
+        return RewindSaveState(descriptorTable.getInt(descriptorOffset + DESCRIPTOR_FRAME_OFFSET))
+    }
+
+    fun loadThumbnail(state: RewindSaveState): Bitmap? {
+        if (!thumbnailLoader(state.frame, thumbnailBuffer)) {
+            return null
+        }
+
+        thumbnailBuffer.rewind()
+        return Bitmap.createBitmap(thumbnailWidth, thumbnailHeight, Bitmap.Config.RGB_565).apply {
+            copyPixelsFromBuffer(thumbnailBuffer)
+        }
     }
 
     fun getDeltaFromEmulationTimeToRewindState(state: RewindSaveState): Duration {
@@ -18,4 +77,4 @@ class RewindWindow(
         val elapsedMillis = elapsedFrames.toFloat() / FRAMES_PER_SECOND * 1000
         return elapsedMillis.toLong().milliseconds
     }
-}
\ No newline at end of file
+}
@@ -2,5 +2,9 @@ package me.magnum.melonds.ui.romlist
 
 import android.graphics.Bitmap
 import me.magnum.melonds.domain.model.RomIconFiltering
+import kotlin.time.Duration
 
-data class RomIcon(val bitmap: Bitmap?, val filtering: RomIconFiltering)
\ No newline at end of file
+data class RomIcon(val bitmap: Bitmap?, val filtering: RomIconFiltering, val animation: Animation? = null) {
+
+    class Animation(val frames: List<Bitmap>, val frameDurations: List<Duration>)
+}
\ No newline at end of file
@@ -8,8 +8,11 @@ import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.flow.Flow
 import kotlinx.coroutines.flow.MutableStateFlow
 import kotlinx.coroutines.flow.asStateFlow
+import kotlinx.coroutines.flow.collectLatest
 import kotlinx.coroutines.flow.combine
 import kotlinx.coroutines.flow.distinctUntilChanged
+import kotlinx.coroutines.flow.distinctUntilChangedBy
+import kotlinx.coroutines.flow.filterNotNull
 import kotlinx.coroutines.flow.launchIn
 import kotlinx.coroutines.isActive
 import kotlinx.coroutines.launch
@@ -88,6 +91,13 @@ class RomListViewModel @Inject constructor(
             }
         }.launchIn(viewModelScope)
 
+        viewModelScope.launch {
+            // Sorting only reorders the list, which does not need a new prefetch
+            _roms.filterNotNull().distinctUntilChangedBy { roms -> roms.mapTo(HashSet()) { it.uri } }.collectLatest { roms ->
+                romIconProvider.prefetchRomIcons(roms)
+            }
+        }
+
         combine(_sortingMode, _sortingOrder) { sortingMode, sortingOrder ->
             _roms.value = when (sortingMode) {
                 SortingMode.ALPHABETICALLY -> _roms.value?.sortedWith(buildAlphabeticalRomComparator(sortingOrder))
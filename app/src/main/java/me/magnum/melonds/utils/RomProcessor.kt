@@ -3,6 +3,7 @@ package me.magnum.melonds.utils
 import android.graphics.Bitmap
 import android.graphics.Color
 import androidx.core.graphics.createBitmap
+import me.magnum.melonds.MelonHasher
 import me.magnum.melonds.common.Crc32
 import me.magnum.melonds.common.cheats.ProgressTrackerInputStream
 import me.magnum.melonds.domain.model.RomInfo
@@ -12,7 +13,6 @@ import java.io.InputStream
 import java.math.BigInteger
 import java.nio.ByteBuffer
 import java.nio.charset.StandardCharsets
-import java.security.MessageDigest
 import kotlin.experimental.and
 import kotlin.math.min
 
@@ -71,10 +71,7 @@ object RomProcessor {
 							save(KEY_BANNER, banner)
 
 							val titleData = banner.copyOfRange(0x340, 0x340 + 256)
-							val titleString = String(titleData, StandardCharsets.UTF_16LE).trim().replace("\u0000", "")
-
-							val title = titleString.substringBeforeLast('\n').replace("\n", " ")
-							val developer = titleString.substringAfterLast('\n')
+							val (title, developer) = parseBannerTitle(titleData)
 
 							save(KEY_ROM_NAME, title)
 							save(KEY_DEVELOPER_NAME, developer)
@@ -124,8 +121,7 @@ object RomProcessor {
 			banner.copyInto(this, header.size + arm9Bootcode.size + arm7Bootcode.size)
 		}
 
-		val messageDigest = MessageDigest.getInstance("MD5")
-		val retroAchievemetnsHash = BigInteger(1, messageDigest.digest(retroAchievementsHashData)).toString(16).padStart(32, '0')
+		val retroAchievemetnsHash = BigInteger(1, MelonHasher.md5(retroAchievementsHashData)).toString(16).padStart(32, '0')
 
 		return RomMetadata(
 			romName,
@@ -135,6 +131,17 @@ object RomProcessor {
 		)
 	}
 
+	/**
+	 * Splits the UTF-16 title stored in a ROM banner into the ROM title and the developer name, which is always on the last line.
+	 */
+	fun parseBannerTitle(titleData: ByteArray): Pair<String, String> {
+		val titleString = String(titleData, StandardCharsets.UTF_16LE).trim().replace("\u0000", "")
+
+		val title = titleString.substringBeforeLast('\n').replace("\n", " ")
+		val developer = titleString.substringAfterLast('\n')
+		return title to developer
+	}
+
 	fun getRomIcon(inputStream: InputStream): Bitmap {
 		// Banner offset is at header offset 0x68
 		inputStream.skipStreamBytes(0x68)
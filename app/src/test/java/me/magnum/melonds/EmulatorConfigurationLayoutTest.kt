@@ -0,0 +1,67 @@
+package me.magnum.melonds
+
+import me.magnum.melonds.impl.emulator.EmulatorConfigurationLayout
+import org.junit.Assert.assertEquals
+import org.junit.Test
+import java.io.File
+import java.lang.reflect.Modifier
+
+/**
+ * Checks that the serialized emulator configuration layout used by Kotlin matches the one used by the native code.
+ */
+class EmulatorConfigurationLayoutTest {
+    companion object {
+        private val NATIVE_LAYOUT_FILE = File("src/main/cpp/EmulatorConfigurationLayout.h")
+        private val CONSTANT_REGEX = Regex("""constexpr\s+melonDS::u32\s+(\w+)\s*=\s*([^;]+);""")
+    }
+
+    @Test
+    fun testKotlinLayoutMatchesNativeLayout() {
+        val nativeConstants = readNativeConstants()
+        val kotlinConstants = readKotlinConstants()
+
+        assertEquals(nativeConstants.keys.sorted(), kotlinConstants.keys.sorted())
+        nativeConstants.forEach { (name, value) ->
+            assertEquals("Value of $name", value, kotlinConstants[name])
+        }
+    }
+
+    @Test
+    fun testFixedFieldsDoNotOverlapStringTable() {
+        val kotlinConstants = readKotlinConstants()
+        val fieldOffsets = kotlinConstants.filterKeys { it.endsWith("_OFFSET") && it != "STRING_TABLE_OFFSET" && it != "STRING_DATA_OFFSET" }
+
+        fieldOffsets.forEach { (name, offset) ->
+            // All fixed fields are at most 4 bytes long
+            assert(offset + 4 <= EmulatorConfigurationLayout.STRING_TABLE_OFFSET) { "$name overlaps the string table" }
+        }
+        assertEquals(fieldOffsets.size, fieldOffsets.values.toSet().size)
+    }
+
+    private fun readNativeConstants(): Map<String, Int> {
+        val constants = mutableMapOf<String, Int>()
+        CONSTANT_REGEX.findAll(NATIVE_LAYOUT_FILE.readText()).forEach {
+            val (name, expression) = it.destructured
+            constants[name] = evaluateExpression(expression, constants)
+        }
+        return constants
+    }
+
+    private fun readKotlinConstants(): Map<String, Int> {
+        return EmulatorConfigurationLayout::class.java.declaredFields
+            .filter { Modifier.isStatic(it.modifiers) && it.type == Int::class.javaPrimitiveType }
+            .associate { it.name to it.getInt(null) }
+    }
+
+    /**
+     * Evaluates the sums of products used to derive constants from previously declared ones.
+     */
+    private fun evaluateExpression(expression: String, constants: Map<String, Int>): Int {
+        return expression.split('+').sumOf { term ->
+            term.split('*').fold(1) { product, factor ->
+                val operand = factor.trim()
+                product * (operand.toIntOrNull() ?: constants[operand] ?: throw IllegalArgumentException("Unknown constant $operand"))
+            }
+        }
+    }
+}